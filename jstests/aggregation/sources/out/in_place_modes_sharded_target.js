@@ -0,0 +1,40 @@
+// Tests that the $out modes which write to the target collection in place reject a sharded target
+// collection.
+// @tags: [requires_sharding]
+(function() {
+    "use strict";
+
+    const st = new ShardingTest({shards: 2, mongos: 1});
+
+    const mongosDB = st.s0.getDB(jsTestName());
+    const source = mongosDB.source;
+    const target = mongosDB.target;
+
+    assert.commandWorked(mongosDB.adminCommand({enableSharding: mongosDB.getName()}));
+    st.ensurePrimaryShard(mongosDB.getName(), st.shard0.shardName);
+    assert.commandWorked(
+        mongosDB.adminCommand({shardCollection: target.getFullName(), key: {_id: 1}}));
+
+    assert.writeOK(source.insert([{_id: 1, a: 1}, {_id: 2, a: 2}]));
+
+    for (let mode of ["insertDocuments", "replaceDocuments", "mergeDocuments"]) {
+        assert.commandFailedWithCode(mongosDB.runCommand({
+            aggregate: source.getName(),
+            pipeline: [{$out: {to: target.getName(), mode: mode}}],
+            cursor: {}
+        }),
+                                     [28769, 50850]);
+    }
+    assert.eq(0, target.find().itcount());
+
+    // The check on the shard catches a target which mongos doesn't know to be sharded.
+    const shardDB = st.shard0.getDB(mongosDB.getName());
+    assert.commandFailedWithCode(shardDB.runCommand({
+        aggregate: source.getName(),
+        pipeline: [{$out: {to: target.getName(), mode: "mergeDocuments"}}],
+        cursor: {}
+    }),
+                                 50850);
+
+    st.stop();
+}());
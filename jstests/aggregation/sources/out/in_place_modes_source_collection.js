@@ -0,0 +1,21 @@
+// Tests that the $out modes which write to the target collection in place cannot write to the
+// collection being aggregated, since the pipeline could then read its own writes.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const coll = db.out_in_place_source_collection;
+    coll.drop();
+
+    assert.writeOK(coll.insert([{_id: 1, a: 1}, {_id: 2, a: 2}]));
+
+    for (let mode of ["insertDocuments", "replaceDocuments", "mergeDocuments"]) {
+        assertErrorCode(coll, [{$out: {to: coll.getName(), mode: mode}}], 50867);
+    }
+    assert.eq([{_id: 1, a: 1}, {_id: 2, a: 2}], coll.find().sort({_id: 1}).toArray());
+
+    // Replacing the collection writes to a temporary collection first, so it is allowed.
+    coll.aggregate([{$addFields: {b: 1}}, {$out: {to: coll.getName(), mode: "replaceCollection"}}]);
+    assert.eq([{_id: 1, a: 1, b: 1}, {_id: 2, a: 2, b: 1}], coll.find().sort({_id: 1}).toArray());
+}());
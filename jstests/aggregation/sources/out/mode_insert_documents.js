@@ -0,0 +1,27 @@
+// Tests that $out with mode "insertDocuments" adds the results to an existing collection.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const source = db.out_insert_documents_source;
+    const target = db.out_insert_documents_target;
+    source.drop();
+    target.drop();
+
+    assert.writeOK(source.insert([{_id: 1, a: 1}, {_id: 2, a: 2}]));
+    assert.writeOK(target.insert({_id: 0, a: 0}));
+
+    // The existing documents of the target collection are kept.
+    source.aggregate([{$out: {to: target.getName(), mode: "insertDocuments"}}]);
+    assert.eq([{_id: 0, a: 0}, {_id: 1, a: 1}, {_id: 2, a: 2}],
+              target.find().sort({_id: 1}).toArray());
+
+    // Results which collide with an existing document fail the aggregation.
+    assertErrorCode(source, [{$out: {to: target.getName(), mode: "insertDocuments"}}], 16996);
+
+    // The target collection is created if it doesn't exist.
+    target.drop();
+    source.aggregate([{$out: {to: target.getName(), mode: "insertDocuments"}}]);
+    assert.eq([{_id: 1, a: 1}, {_id: 2, a: 2}], target.find().sort({_id: 1}).toArray());
+}());
@@ -0,0 +1,36 @@
+// Tests that $out with mode "mergeDocuments" sets the fields of each result on the target document
+// which has the same 'uniqueKey', or inserts the result if there is none.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const source = db.out_merge_documents_source;
+    const target = db.out_merge_documents_target;
+    source.drop();
+    target.drop();
+
+    // By _id, which is the default 'uniqueKey'. Fields which are not in the result are kept.
+    assert.writeOK(source.insert([{_id: 1, a: 1}, {_id: 2, a: 2}]));
+    assert.writeOK(target.insert([{_id: 1, a: 10, b: 10}, {_id: 3, a: 30}]));
+    source.aggregate([{$out: {to: target.getName(), mode: "mergeDocuments"}}]);
+    assert.eq([{_id: 1, a: 1, b: 10}, {_id: 2, a: 2}, {_id: 3, a: 30}],
+              target.find().sort({_id: 1}).toArray());
+
+    // By a key with a unique index. The matched target documents keep their own _id, and the
+    // inserted ones get a new one.
+    assert(target.drop());
+    assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+    assert.writeOK(target.insert([{_id: "one", a: 1, b: 10}, {_id: "three", a: 3}]));
+    assert.writeOK(source.update({_id: 1}, {$set: {c: 1}}));
+    source.aggregate([{$out: {to: target.getName(), mode: "mergeDocuments", uniqueKey: {a: 1}}}]);
+    assert.eq([{_id: "one", a: 1, b: 10, c: 1}, {_id: "three", a: 3}],
+              target.find({_id: {$in: ["one", "three"]}}).sort({_id: 1}).toArray());
+    assert.eq(1, target.find({a: 2, _id: {$type: "objectId"}}).itcount());
+    assert.eq(3, target.find().itcount());
+
+    // A key without a unique index is rejected, including one covered by a non-unique index.
+    assert.commandWorked(target.createIndex({b: 1}));
+    assertErrorCode(
+        source, [{$out: {to: target.getName(), mode: "mergeDocuments", uniqueKey: {b: 1}}}], 50851);
+}());
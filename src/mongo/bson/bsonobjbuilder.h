@@ -774,6 +774,10 @@ public:
         return _b;
     }
 
+    const BufBuilder& bb() const {
+        return _b;
+    }
+
 private:
     char* _done() {
         if (_doneCalled)
@@ -941,6 +945,13 @@ public:
         return _i;
     }
 
+    /**
+     * The start offset of the array being built by this builder within its buffer.
+     */
+    std::size_t offset() const {
+        return _b.offset();
+    }
+
     BufBuilder& bb() {
         return _b.bb();
     }
@@ -32,6 +32,8 @@
 
 #include "mongo/client/async_client.h"
 
+#include <utility>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/client/authenticate.h"
 #include "mongo/config.h"
@@ -191,6 +193,10 @@ Future<void> AsyncDBClient::initWireVersion(const std::string& appName,
 }
 
 Future<Message> AsyncDBClient::_call(Message request, const transport::BatonHandle& baton) {
+    if (_multiplexed.load()) {
+        return _multiplexedCall(std::move(request));
+    }
+
     auto swm = _compressorManager.compressMessage(request);
     if (!swm.isOK()) {
         return swm.getStatus();
@@ -208,14 +214,155 @@ Future<Message> AsyncDBClient::_call(Message request, const transport::BatonHand
                     "ResponseId did not match sent message ID.",
                     response.header().getResponseToMsgId() == msgId);
 
-            if (response.operation() == dbCompressed) {
-                return _compressorManager.decompressMessage(response);
-            } else {
-                return response;
-            }
+            return _decompress(std::move(response));
         });
 }
 
+StatusWith<Message> AsyncDBClient::_decompress(Message response) {
+    if (response.operation() == dbCompressed) {
+        return _compressorManager.decompressMessage(response);
+    } else {
+        return response;
+    }
+}
+
+bool AsyncDBClient::canMultiplex() const {
+    return _negotiatedProtocol && *_negotiatedProtocol == rpc::Protocol::kOpMsg &&
+        _session->supportsConcurrentSourceAndSink();
+}
+
+void AsyncDBClient::enableMultiplexing() {
+    invariant(canMultiplex());
+    _multiplexed.store(true);
+}
+
+Future<Message> AsyncDBClient::_multiplexedCall(Message request) {
+    auto promise = stdx::make_unique<Promise<Message>>();
+    auto future = promise->getFuture();
+
+    bool startWriting = false;
+    bool startReading = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        if (!_multiplexStatus.isOK()) {
+            return _multiplexStatus;
+        }
+
+        // Compressing under the same lock as queueing the write keeps the compressor state
+        // consistent, and a streaming compressor's messages in the order they are written.
+        auto swm = _compressorManager.compressMessage(request);
+        if (!swm.isOK()) {
+            return swm.getStatus();
+        }
+
+        request = std::move(swm.getValue());
+        auto msgId = nextMessageId();
+        request.header().setId(msgId);
+        request.header().setResponseToMsgId(0);
+
+        _multiplexedResponses.emplace(msgId, std::move(promise));
+        _multiplexedWrites.push_back(std::move(request));
+        startWriting = !std::exchange(_multiplexedWriting, true);
+        startReading = !std::exchange(_multiplexedReading, true);
+    }
+
+    if (startWriting) {
+        _writeNextMultiplexed();
+    }
+    if (startReading) {
+        _readNextMultiplexed();
+    }
+    return future;
+}
+
+void AsyncDBClient::_writeNextMultiplexed() {
+    Message request;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        if (_multiplexedWrites.empty() || !_multiplexStatus.isOK()) {
+            _multiplexedWriting = false;
+            return;
+        }
+        request = std::move(_multiplexedWrites.front());
+        _multiplexedWrites.pop_front();
+    }
+
+    _session->asyncSinkMessage(request).getAsync([self = shared_from_this()](Status status) {
+        if (!status.isOK()) {
+            self->_failMultiplexed(std::move(status));
+            return;
+        }
+        self->_writeNextMultiplexed();
+    });
+}
+
+void AsyncDBClient::_readNextMultiplexed() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        if (_multiplexedResponses.empty() || !_multiplexStatus.isOK()) {
+            _multiplexedReading = false;
+            return;
+        }
+    }
+
+    _session->asyncSourceMessage().getAsync([self = shared_from_this()](StatusWith<Message> swm) {
+        if (!swm.isOK()) {
+            self->_failMultiplexed(swm.getStatus());
+            return;
+        }
+
+        const auto responseTo = swm.getValue().header().getResponseToMsgId();
+        std::unique_ptr<Promise<Message>> promise;
+        StatusWith<Message> response = Status::OK();
+        {
+            stdx::lock_guard<stdx::mutex> lk(self->_multiplexMutex);
+            auto it = self->_multiplexedResponses.find(responseTo);
+            if (it != self->_multiplexedResponses.end()) {
+                promise = std::move(it->second);
+                self->_multiplexedResponses.erase(it);
+            }
+
+            // Responses are decompressed here, in the order they arrive, rather than on the
+            // threads of the requests they answer.
+            response = self->_decompress(std::move(swm.getValue()));
+        }
+
+        if (!promise) {
+            self->_failMultiplexed({ErrorCodes::ProtocolError,
+                                    str::stream() << "Received a response to message "
+                                                  << responseTo
+                                                  << ", which is not in progress"});
+            return;
+        }
+
+        if (!response.isOK()) {
+            // Later responses can't be decompressed either if the compressor keeps a history.
+            promise->setError(response.getStatus());
+            self->_failMultiplexed(response.getStatus());
+            return;
+        }
+
+        promise->emplaceValue(std::move(response.getValue()));
+        self->_readNextMultiplexed();
+    });
+}
+
+void AsyncDBClient::_failMultiplexed(Status status) {
+    decltype(_multiplexedResponses) responses;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        if (_multiplexStatus.isOK()) {
+            _multiplexStatus = status;
+        }
+        responses.swap(_multiplexedResponses);
+        _multiplexedWrites.clear();
+    }
+
+    for (auto& response : responses) {
+        response.second->setError(status);
+    }
+}
+
 Future<rpc::UniqueReply> AsyncDBClient::runCommand(OpMsgRequest request,
                                                    const transport::BatonHandle& baton) {
     invariant(_negotiatedProtocol);
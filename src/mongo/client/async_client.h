@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/service_context.h"
@@ -36,6 +37,8 @@
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/transport_layer.h"
@@ -69,6 +72,21 @@ public:
 
     void cancel(const transport::BatonHandle& baton = nullptr);
 
+    /**
+     * Returns true if this client can be switched to multiplexed mode: the remote speaks OP_MSG
+     * and the session can send and receive at the same time.
+     */
+    bool canMultiplex() const;
+
+    /**
+     * Switches this client to multiplexed mode, in which any number of runCommand() and
+     * runCommandRequest() calls may be in progress at once. Requests are written one after the
+     * other as they come, and a single reader hands each response to the request whose message id
+     * it answers. The I/O happens on the reactor, so batons are ignored, and cancel() must not be
+     * used since it would abort every request. Requires canMultiplex().
+     */
+    void enableMultiplexing();
+
     bool isStillConnected();
 
     void end();
@@ -78,6 +96,20 @@ public:
 
 private:
     Future<Message> _call(Message request, const transport::BatonHandle& baton = nullptr);
+    StatusWith<Message> _decompress(Message response);
+
+    /**
+     * Compresses 'request' and queues it to be written on the multiplexed connection, and returns
+     * a future for its decompressed response.
+     */
+    Future<Message> _multiplexedCall(Message request);
+    void _writeNextMultiplexed();
+    void _readNextMultiplexed();
+
+    /**
+     * Fails every request in progress on the multiplexed connection, and any later one.
+     */
+    void _failMultiplexed(Status status);
     BSONObj _buildIsMasterRequest(const std::string& appName);
     void _parseIsMasterResponse(BSONObj request,
                                 const std::unique_ptr<rpc::ReplyInterface>& response);
@@ -87,6 +119,17 @@ private:
     ServiceContext* const _svcCtx;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    AtomicBool _multiplexed{false};
+
+    // Guards the state of the multiplexed connection below, and _compressorManager once
+    // multiplexed.
+    stdx::mutex _multiplexMutex;
+    Status _multiplexStatus = Status::OK();
+    std::deque<Message> _multiplexedWrites;
+    stdx::unordered_map<int32_t, std::unique_ptr<Promise<Message>>> _multiplexedResponses;
+    bool _multiplexedWriting = false;
+    bool _multiplexedReading = false;
 };
 
 }  // namespace mongo
@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/async_client.h"
+
+#include <deque>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/db/wire_version.h"
+#include "mongo/rpc/factory.h"
+#include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/rpc/protocol.h"
+#include "mongo/rpc/reply_builder_interface.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/mock_session.h"
+#include "mongo/transport/transport_layer_mock.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/options_parser/startup_option_init.h"
+
+namespace mongo {
+namespace {
+
+// Negotiate the compressor which keeps a history across messages, so that each end notices any
+// message compressed out of the order in which it was sent.
+MONGO_STARTUP_OPTIONS_STORE(AsyncDBClientTestCompressors)(InitializerContext*) {
+    MessageCompressorRegistry::get().setSupportedCompressors({"lz4stream"});
+    return Status::OK();
+}
+
+/**
+ * A session whose remote end answers each command written to it with {echo: <command>, ok: 1},
+ * and can be read from and written to at the same time.
+ */
+class EchoSession : public transport::MockSession {
+public:
+    explicit EchoSession(transport::TransportLayer* tl) : MockSession(tl) {}
+
+    bool supportsConcurrentSourceAndSink() const override {
+        return true;
+    }
+
+    Future<void> asyncSinkMessage(Message message,
+                                  const transport::BatonHandle& handle = nullptr) override {
+        auto swReply = _answer(message);
+        if (!swReply.isOK()) {
+            return swReply.getStatus();
+        }
+
+        std::unique_ptr<Promise<Message>> reader;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_reader) {
+                reader = std::move(_reader);
+            } else {
+                _replies.push_back(std::move(swReply.getValue()));
+            }
+        }
+
+        if (reader) {
+            reader->emplaceValue(std::move(swReply.getValue()));
+        }
+        return Future<void>::makeReady();
+    }
+
+    Future<Message> asyncSourceMessage(const transport::BatonHandle& handle = nullptr) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        invariant(!_reader);
+        if (!_replies.empty()) {
+            auto reply = std::move(_replies.front());
+            _replies.pop_front();
+            return Future<Message>::makeReady(std::move(reply));
+        }
+
+        _reader = stdx::make_unique<Promise<Message>>();
+        return _reader->getFuture();
+    }
+
+private:
+    // Only called by one writer at a time.
+    StatusWith<Message> _answer(const Message& message) {
+        MessageCompressorId compressorId;
+        const bool compressed = message.operation() == dbCompressed;
+        auto swRequest = _compressorManager.decompressMessage(message, &compressorId);
+        if (!swRequest.isOK()) {
+            return swRequest.getStatus();
+        }
+
+        const auto protocol = rpc::protocolForMessage(swRequest.getValue());
+        const auto request = rpc::opMsgRequestFromAnyProtocol(swRequest.getValue());
+
+        BSONObjBuilder replyBuilder;
+        if (request.getCommandName() == "isMaster") {
+            replyBuilder.append("ismaster", true);
+            replyBuilder.append("minWireVersion", WireVersion::RELEASE_2_4_AND_BEFORE);
+            replyBuilder.append("maxWireVersion", WireVersion::LATEST_WIRE_VERSION);
+            _compressorManager.serverNegotiate(request.body, &replyBuilder);
+        } else {
+            replyBuilder.append("echo", request.body);
+        }
+        replyBuilder.append("ok", 1);
+
+        auto builder = rpc::makeReplyBuilder(protocol);
+        builder->setCommandReply(replyBuilder.obj());
+        auto reply = builder->done();
+        reply.header().setId(nextMessageId());
+        reply.header().setResponseToMsgId(message.header().getId());
+
+        if (!compressed) {
+            return std::move(reply);
+        }
+        return _compressorManager.compressMessage(reply, &compressorId);
+    }
+
+    MessageCompressorManager _compressorManager;
+
+    stdx::mutex _mutex;
+    std::deque<Message> _replies;
+    std::unique_ptr<Promise<Message>> _reader;
+};
+
+class AsyncDBClientTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _session = std::make_shared<EchoSession>(&_tl);
+        _client = std::make_shared<AsyncDBClient>(HostAndPort("test", 27017), _session, &_svcCtx);
+        _client->initWireVersion("AsyncDBClientTest", nullptr).get();
+    }
+
+    AsyncDBClient& client() {
+        return *_client;
+    }
+
+private:
+    ServiceContextNoop _svcCtx;
+    transport::TransportLayerMock _tl;
+    std::shared_ptr<EchoSession> _session;
+    AsyncDBClient::Handle _client;
+};
+
+TEST_F(AsyncDBClientTest, ConcurrentCompressedCallsOnMultiplexedClient) {
+    const int kNumThreads = 4;
+    const int kNumCallsPerThread = 100;
+
+    ASSERT(client().canMultiplex());
+    client().enableMultiplexing();
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<Future<rpc::UniqueReply>> replies;
+            for (int i = 0; i < kNumCallsPerThread; ++i) {
+                replies.push_back(client().runCommand(
+                    OpMsgRequest::fromDBAndBody("admin", BSON("echo" << t << "i" << i))));
+            }
+
+            for (int i = 0; i < kNumCallsPerThread; ++i) {
+                auto reply = std::move(replies[i]).get();
+                auto echoed = reply->getCommandReply()["echo"].Obj();
+                ASSERT_EQ(echoed["echo"].numberInt(), t);
+                ASSERT_EQ(echoed["i"].numberInt(), i);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -48,6 +48,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/rpc/write_concern_error_detail.h"
 #include "mongo/s/stale_exception.h"
@@ -69,6 +70,8 @@ const WriteConcernOptions kMajorityWriteConcern(
     WriteConcernOptions::SyncMode::UNSET,
     Seconds(60));
 
+const auto getReplyOpMsgBuilder = OperationContext::declareDecoration<OpMsgBuilder*>();
+
 }  // namespace
 
 
@@ -126,6 +129,41 @@ void CommandHelpers::uassertNoDocumentSequences(StringData commandName,
             request.sequences.empty());
 }
 
+bool CommandHelpers::shouldRunAgainForExhaust(const Message& requestMessage,
+                                              const OpMsgRequest& request,
+                                              rpc::ReplyBuilderInterface* replyBuilder) {
+    if (!OpMsg::isFlagSet(requestMessage, OpMsg::kExhaustAllowed) ||
+        OpMsg::isFlagSet(requestMessage, OpMsg::kMoreToCome) ||
+        request.getCommandName() != "getMore"_sd) {
+        return false;
+    }
+
+    auto opMsgBuilder = replyBuilder->getOpMsgBuilder();
+    if (!opMsgBuilder) {
+        return false;
+    }
+
+    // Documents spliced into the batch are missing from the body at this point, but neither the
+    // ok field nor the cursor id can be spliced.
+    const auto replyBody = opMsgBuilder->peekBody();
+    return replyBody["ok"].trueValue() &&
+        replyBody.getObjectField("cursor")["id"].safeNumberLong() != 0;
+}
+
+OpMsgBuilder* CommandHelpers::replyOpMsgBuilder(OperationContext* opCtx) {
+    return getReplyOpMsgBuilder(opCtx);
+}
+
+CommandHelpers::ReplyOpMsgBuilderScope::ReplyOpMsgBuilderScope(OperationContext* opCtx,
+                                                               OpMsgBuilder* builder)
+    : _opCtx(opCtx), _previous(getReplyOpMsgBuilder(opCtx)) {
+    getReplyOpMsgBuilder(opCtx) = builder;
+}
+
+CommandHelpers::ReplyOpMsgBuilderScope::~ReplyOpMsgBuilderScope() {
+    getReplyOpMsgBuilder(_opCtx) = _previous;
+}
+
 std::string CommandHelpers::parseNsFullyQualified(const BSONObj& cmdObj) {
     BSONElement first = cmdObj.firstElement();
     uassert(ErrorCodes::BadValue,
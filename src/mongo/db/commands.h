@@ -223,6 +223,39 @@ struct CommandHelpers {
 
     static void uassertNoDocumentSequences(StringData commandName, const OpMsgRequest& request);
 
+    /**
+     * Returns true if 'requestMessage' is an OP_MSG getMore sent with OpMsg::kExhaustAllowed and
+     * the reply built so far by 'replyBuilder' returns a batch from a cursor which is still open.
+     * The server then streams the next batch without waiting for the client to ask for it.
+     */
+    static bool shouldRunAgainForExhaust(const Message& requestMessage,
+                                         const OpMsgRequest& request,
+                                         rpc::ReplyBuilderInterface* replyBuilder);
+
+    /**
+     * Returns the builder for the OP_MSG which the reply to the command running on 'opCtx' is
+     * being written into, or nullptr if the reply is not built directly into an outgoing OP_MSG
+     * (for example, under DBDirectClient). Commands may use it to splice large documents into the
+     * reply instead of copying them; see OpMsgBuilder::beginSplicedArray().
+     */
+    static OpMsgBuilder* replyOpMsgBuilder(OperationContext* opCtx);
+
+    /**
+     * Sets the builder returned by replyOpMsgBuilder() for the lifetime of this object, restoring
+     * the previous one on destruction.
+     */
+    class ReplyOpMsgBuilderScope {
+        MONGO_DISALLOW_COPYING(ReplyOpMsgBuilderScope);
+
+    public:
+        ReplyOpMsgBuilderScope(OperationContext* opCtx, OpMsgBuilder* builder);
+        ~ReplyOpMsgBuilderScope();
+
+    private:
+        OperationContext* const _opCtx;
+        OpMsgBuilder* const _previous;
+    };
+
     static constexpr StringData kHelpFieldName = "help"_sd;
 };
 
@@ -333,7 +333,8 @@ public:
         const QueryRequest& originalQR = exec->getCanonicalQuery()->getQueryRequest();
 
         // Stream query results, adding them to a BSONArray as we go.
-        CursorResponseBuilder firstBatch(/*isInitialResponse*/ true, &result);
+        CursorResponseBuilder firstBatch(
+            /*isInitialResponse*/ true, &result, CommandHelpers::replyOpMsgBuilder(opCtx));
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
         long long numResults = 0;
@@ -392,7 +392,8 @@ public:
         }
 
         CursorId respondWithId = 0;
-        CursorResponseBuilder nextBatch(/*isInitialResponse*/ false, &result);
+        CursorResponseBuilder nextBatch(
+            /*isInitialResponse*/ false, &result, CommandHelpers::replyOpMsgBuilder(opCtx));
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
         long long numResults = 0;
@@ -55,6 +55,7 @@
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
+#include "mongo/util/shared_buffer_pool.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/version.h"
 
@@ -299,6 +300,10 @@ public:
         BSONObjBuilder b;
         networkCounter.append(b);
         appendMessageCompressionStats(&b);
+        {
+            BSONObjBuilder bufferPool(b.subobjStart("bufferPool"));
+            SharedBufferPool::appendStats(&bufferPool);
+        }
         auto executor = opCtx->getServiceContext()->getServiceExecutor();
         if (executor)
             executor->appendStats(&b);
@@ -446,6 +446,10 @@ Message makeGetMoreMessage(StringData ns, long long cursorId, int nToReturn, int
 struct DbResponse {
     Message response;       // If empty, nothing will be returned to the client.
     std::string exhaustNS;  // Namespace of cursor if exhaust mode, else "".
+
+    // Set for an OP_MSG reply to an exhaust getMore whose cursor is still open. The request is
+    // then run again as soon as this reply has been sent, without waiting for the client.
+    bool shouldRunAgainForExhaust = false;
 };
 
 /**
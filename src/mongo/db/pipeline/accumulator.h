@@ -38,6 +38,8 @@
 #include "mongo/bson/bsontypes.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/hyper_log_log.h"
+#include "mongo/db/pipeline/t_digest.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
 #include "mongo/stdx/functional.h"
@@ -307,6 +309,71 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 };
 
+/**
+ * Estimates the number of distinct values with a HyperLogLog sketch, in constant memory. Counts
+ * are exact while there are few distinct values.
+ */
+class AccumulatorApproxCountDistinct final : public Accumulator {
+public:
+    explicit AccumulatorApproxCountDistinct(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    HyperLogLog _sketch;
+};
+
+/**
+ * Estimates one or more percentiles of the numeric values of 'input' with a t-digest, in bounded
+ * memory. Takes an operand of the form {input: <expression>, p: <number or array of numbers>},
+ * where each p is in [0, 1], and returns a number or an array of numbers accordingly.
+ */
+class AccumulatorApproxPercentile final : public Accumulator {
+public:
+    explicit AccumulatorApproxPercentile(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    /**
+     * Validates 'p' the first time it is seen, and checks that it does not change afterwards.
+     */
+    void setPercentiles(const Value& p);
+
+    TDigest _digest;
+
+    // The 'p' operand as given, which is missing until the first document is processed.
+    Value _p;
+};
+
 class AccumulatorMergeObjects : public Accumulator {
 public:
     AccumulatorMergeObjects(const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(approxCountDistinct, AccumulatorApproxCountDistinct::create);
+
+const char* AccumulatorApproxCountDistinct::getOpName() const {
+    return "$approxCountDistinct";
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        // Like $addToSet, ignore missing values but count null.
+        if (input.missing()) {
+            return;
+        }
+        // Hash with the comparator so that values which compare equal under the collation, such
+        // as 1 and 1.0, are counted once.
+        _sketch.add(getExpressionContext()->getValueComparator().hash(input));
+    } else {
+        // This is what getValue(true) produced below.
+        verify(input.getType() == Object);
+        const Value hashes = input["hashes"];
+        const bool exact = !hashes.missing();
+        const Value data = exact ? hashes : input["registers"];
+        uassert(50859,
+                "$approxCountDistinct cannot merge a malformed partial result",
+                data.getType() == BinData);
+        const BSONBinData binData = data.getBinData();
+        _sketch.merge(
+            HyperLogLog::parse(StringData(static_cast<const char*>(binData.data), binData.length),
+                               exact));
+    }
+    _memUsageBytes = sizeof(*this) + _sketch.getApproximateSize();
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (!toBeMerged) {
+        return Value(_sketch.estimate());
+    }
+
+    const std::vector<char> data = _sketch.serialize();
+    return Value(DOC((_sketch.isExact() ? "hashes" : "registers")
+                     << Value(BSONBinData(data.data(), data.size(), BinDataGeneral))));
+}
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    _sketch = HyperLogLog();
+    _memUsageBytes = sizeof(*this);
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxCountDistinct::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::vector;
+
+REGISTER_ACCUMULATOR(approxPercentile, AccumulatorApproxPercentile::create);
+
+namespace {
+
+bool isValidPercentile(const Value& p) {
+    if (!p.numeric()) {
+        return false;
+    }
+    const double value = p.coerceToDouble();
+    return value >= 0.0 && value <= 1.0;
+}
+
+}  // namespace
+
+const char* AccumulatorApproxPercentile::getOpName() const {
+    return "$approxPercentile";
+}
+
+void AccumulatorApproxPercentile::setPercentiles(const Value& p) {
+    if (!_p.missing()) {
+        uassert(50860,
+                "The 'p' argument to $approxPercentile must be constant",
+                ValueComparator().evaluate(_p == p));
+        return;
+    }
+
+    bool valid = false;
+    if (p.getType() == Array) {
+        valid = !p.getArray().empty();
+        for (auto&& element : p.getArray()) {
+            valid = valid && isValidPercentile(element);
+        }
+    } else {
+        valid = isValidPercentile(p);
+    }
+    uassert(50861,
+            str::stream() << "The 'p' argument to $approxPercentile must be a number or a "
+                             "non-empty array of numbers between 0 and 1, but found: "
+                          << p.toString(),
+            valid);
+    _p = p;
+}
+
+void AccumulatorApproxPercentile::processInternal(const Value& input, bool merging) {
+    uassert(50862,
+            str::stream() << "$approxPercentile requires an object of the form {input: "
+                             "<expression>, p: <number or array of numbers>}, but found: "
+                          << input.toString(),
+            input.getType() == Object);
+
+    if (!merging) {
+        setPercentiles(input["p"]);
+
+        // Non-numeric values, and NaN which has no rank, have no impact on percentiles. Nor do
+        // infinities, which would turn the mean of any centroid they join into NaN.
+        const Value value = input["input"];
+        if (!value.numeric()) {
+            return;
+        }
+        const double number = value.coerceToDouble();
+        if (!std::isfinite(number)) {
+            return;
+        }
+        _digest.add(number);
+    } else {
+        // This is what getValue(true) produced below.
+        const Value means = input["means"];
+        const Value weights = input["weights"];
+        uassert(50863,
+                "$approxPercentile cannot merge a malformed partial result",
+                means.getType() == Array && weights.getType() == Array &&
+                    means.getArrayLength() == weights.getArrayLength());
+        if (means.getArrayLength() == 0) {
+            return;  // This partition had no data to contribute.
+        }
+        setPercentiles(input["p"]);
+
+        vector<TDigest::Centroid> centroids;
+        centroids.reserve(means.getArrayLength());
+        for (size_t i = 0; i < means.getArrayLength(); ++i) {
+            centroids.push_back(
+                {means.getArray()[i].coerceToDouble(), weights.getArray()[i].coerceToDouble()});
+        }
+        _digest.merge(TDigest::parse(
+            input["min"].coerceToDouble(), input["max"].coerceToDouble(), std::move(centroids)));
+    }
+    _memUsageBytes = sizeof(*this) + _digest.getApproximateSize();
+}
+
+Value AccumulatorApproxPercentile::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        vector<Value> means;
+        vector<Value> weights;
+        if (!_digest.empty()) {
+            for (auto&& centroid : _digest.centroids()) {
+                means.push_back(Value(centroid.mean));
+                weights.push_back(Value(centroid.weight));
+            }
+        }
+        return Value(DOC("p" << _p << "min" << _digest.min() << "max" << _digest.max() << "means"
+                             << means
+                             << "weights"
+                             << weights));
+    }
+
+    if (_digest.empty()) {
+        return Value(BSONNULL);
+    }
+
+    if (_p.getType() != Array) {
+        return Value(_digest.quantile(_p.coerceToDouble()));
+    }
+
+    vector<Value> result;
+    for (auto&& p : _p.getArray()) {
+        result.push_back(Value(_digest.quantile(p.coerceToDouble())));
+    }
+    return Value(std::move(result));
+}
+
+AccumulatorApproxPercentile::AccumulatorApproxPercentile(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorApproxPercentile::reset() {
+    _digest = TDigest();
+    _p = Value();
+    _memUsageBytes = sizeof(*this);
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxPercentile::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxPercentile(expCtx);
+}
+
+}  // namespace mongo
@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
+
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
@@ -402,4 +404,154 @@ TEST(AccumulatorMergeObjects, MergingWithEmptyDocumentShouldIgnore) {
 
 }  // namespace AccumulatorMergeObjects
 
+namespace AccumulatorApproxCountDistinct {
+
+TEST(AccumulatorApproxCountDistinct, CountsSmallSetsExactly) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$approxCountDistinct",
+        expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(0LL)},
+            // Missing values are ignored, but null is counted.
+            {{Value(), Value(BSONNULL)}, Value(1LL)},
+            // Numbers which compare equal are counted once.
+            {{Value(1), Value(1LL), Value(1.0), Value(Decimal128(1))}, Value(1LL)},
+            {{Value("a"_sd), Value(1), Value("a"_sd), Value(BSON_ARRAY(1 << 2))}, Value(3LL)},
+        });
+}
+
+TEST(AccumulatorApproxCountDistinct, UsesCollationToCompareStrings) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+    assertExpectedResults("$approxCountDistinct",
+                          expCtx,
+                          {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(AccumulatorApproxCountDistinct, EstimatesLargeSetsAcrossShards) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxCountDistinct");
+    const long long kNumValues = 100000;
+
+    // Each value is seen by two of four shards.
+    intrusive_ptr<Accumulator> merger(factory(expCtx));
+    for (int shard = 0; shard < 4; ++shard) {
+        intrusive_ptr<Accumulator> accum(factory(expCtx));
+        for (long long i = 0; i < kNumValues; ++i) {
+            if (i % 4 == shard || (i + 1) % 4 == shard) {
+                accum->process(Value(i), false);
+            }
+        }
+        merger->process(accum->getValue(true), true);
+    }
+
+    const long long estimate = merger->getValue(false).getLong();
+    ASSERT_LT(std::abs(estimate - kNumValues), kNumValues / 20);
+    ASSERT_LT(merger->memUsageForSorter(), 32 * 1024);
+}
+
+TEST(AccumulatorApproxCountDistinct, MergesExactPartialResultsAboveTheExactLimit) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxCountDistinct");
+    const long long kNumValues = 1500;
+
+    // Still exact, but with more hashes than an exact sketch keeps after compacting.
+    intrusive_ptr<Accumulator> accum(factory(expCtx));
+    for (long long i = 0; i < kNumValues; ++i) {
+        accum->process(Value(i), false);
+    }
+
+    intrusive_ptr<Accumulator> merger(factory(expCtx));
+    merger->process(accum->getValue(true), true);
+    ASSERT_EQ(merger->getValue(false).getLong(), kNumValues);
+}
+
+}  // namespace AccumulatorApproxCountDistinct
+
+namespace AccumulatorApproxPercentile {
+
+Value percentileOperand(const Value& input, const Value& p) {
+    return Value(Document{{"input", input}, {"p", p}});
+}
+
+TEST(AccumulatorApproxPercentile, ComputesPercentilesOfFewValuesExactly) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    const Value median(0.5);
+    assertExpectedResults(
+        "$approxPercentile",
+        expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(BSONNULL)},
+            // Non-numeric values are ignored.
+            {{percentileOperand(Value("a"_sd), median), percentileOperand(Value(), median)},
+             Value(BSONNULL)},
+            {{percentileOperand(Value(3), median)}, Value(3.0)},
+            {{percentileOperand(Value(1), Value(0)), percentileOperand(Value(7LL), Value(0))},
+             Value(1.0)},
+            {{percentileOperand(Value(1), Value(1)), percentileOperand(Value(7LL), Value(1))},
+             Value(7.0)},
+            // Infinities are ignored, like NaN.
+            {{percentileOperand(Value(std::numeric_limits<double>::infinity()), median),
+              percentileOperand(Value(-std::numeric_limits<double>::infinity()), median),
+              percentileOperand(Value(std::numeric_limits<double>::quiet_NaN()), median),
+              percentileOperand(Value(4), median)},
+             Value(4.0)},
+            {{percentileOperand(Value(2.5), Value(BSON_ARRAY(0 << 1))),
+              percentileOperand(Value(-2.5), Value(BSON_ARRAY(0 << 1)))},
+             Value(BSON_ARRAY(-2.5 << 2.5))},
+        });
+}
+
+TEST(AccumulatorApproxPercentile, EstimatesPercentilesAcrossShards) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+    const Value p(BSON_ARRAY(0.01 << 0.5 << 0.99));
+    const int kNumValues = 100000;
+
+    intrusive_ptr<Accumulator> merger(factory(expCtx));
+    for (int shard = 0; shard < 3; ++shard) {
+        intrusive_ptr<Accumulator> accum(factory(expCtx));
+        for (int i = 1 + shard; i <= kNumValues; i += 3) {
+            accum->process(percentileOperand(Value(i), p), false);
+        }
+        merger->process(accum->getValue(true), true);
+    }
+
+    const Value result = merger->getValue(false);
+    ASSERT_EQ(result.getArrayLength(), 3U);
+    ASSERT_APPROX_EQUAL(result[0].getDouble(), 0.01 * kNumValues, kNumValues / 1000.0);
+    ASSERT_APPROX_EQUAL(result[1].getDouble(), 0.5 * kNumValues, kNumValues / 100.0);
+    ASSERT_APPROX_EQUAL(result[2].getDouble(), 0.99 * kNumValues, kNumValues / 1000.0);
+}
+
+TEST(AccumulatorApproxPercentile, RejectsInvalidPercentiles) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+    for (auto&& p : {Value(1.5), Value(-0.1), Value("a"_sd), Value(std::vector<Value>())}) {
+        intrusive_ptr<Accumulator> accum(factory(expCtx));
+        ASSERT_THROWS_CODE(accum->process(percentileOperand(Value(1), p), false),
+                           AssertionException,
+                           50861);
+    }
+
+    intrusive_ptr<Accumulator> accum(factory(expCtx));
+    ASSERT_THROWS_CODE(accum->process(Value(1), false), AssertionException, 50862);
+}
+
+TEST(AccumulatorApproxPercentile, RequiresConstantPercentiles) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+    intrusive_ptr<Accumulator> accum(factory(expCtx));
+    accum->process(percentileOperand(Value(1), Value(0.5)), false);
+    ASSERT_THROWS_CODE(accum->process(percentileOperand(Value(2), Value(0.9)), false),
+                       AssertionException,
+                       50860);
+}
+
+}  // namespace AccumulatorApproxPercentile
+
 }  // namespace AccumulatorTests
@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/cluster_aggregation_planner.h"
 
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_project.h"
@@ -82,6 +83,47 @@ void findSplitPoint(Pipeline* shardPipe, Pipeline* mergePipe) {
     }
 }
 
+/**
+ * If the merger finishes a $group and then performs a top-k $sort on the group key, adds the same
+ * top-k $sort to the end of the shards' pipeline. A group within the overall top k is also within
+ * the top k of each shard which has a partial result for it, so the merger still receives every
+ * partial result it needs, but no more than k from each shard instead of one per group.
+ *
+ * This requires that distinct groups never tie on the sort key, which is only guaranteed when the
+ * group key cannot be an array, since an array sorts by one of its elements. Sorting on a field of
+ * the group key, or on an accumulated field, does not qualify for the same reason: ties, or partial
+ * results ranked differently from the final ones, could drop partial results the merger needs.
+ */
+void pushTopKSortOnGroupKeyToShards(Pipeline* shardPipe, Pipeline* mergePipe) {
+    const auto& shardSources = shardPipe->getSources();
+    const auto& mergeSources = mergePipe->getSources();
+    if (shardSources.empty() || mergeSources.size() < 2) {
+        return;
+    }
+
+    auto shardGroup = dynamic_cast<DocumentSourceGroup*>(shardSources.back().get());
+    auto mergeGroup = dynamic_cast<DocumentSourceGroup*>(mergeSources.front().get());
+    auto sort = dynamic_cast<DocumentSourceSort*>(std::next(mergeSources.begin())->get());
+    if (!shardGroup || !mergeGroup || !sort || sort->mergingPresorted() || sort->getLimit() < 0 ||
+        !shardGroup->isIdNeverArray()) {
+        return;
+    }
+
+    // Since _id is unique among the groups, any components of the sort pattern after it have no
+    // effect on which groups are in the top k.
+    const Document sortPattern =
+        sort->sortKeyPattern(DocumentSourceSort::SortKeySerialization::kForPipelineSerialization);
+    FieldIterator sortFields(sortPattern);
+    const auto firstSortField = sortFields.next();
+    if (firstSortField.first != "_id"_sd || !firstSortField.second.numeric()) {
+        return;
+    }
+
+    const BSONObj shardSortPattern = BSON("_id" << firstSortField.second.coerceToInt());
+    shardPipe->pushBack(
+        DocumentSourceSort::create(shardPipe->getContext(), shardSortPattern, sort->getLimit()));
+}
+
 /**
  * If the final stage on shards is to unwind an array, move that stage to the merger. This cuts down
  * on network traffic and allows us to take advantage of reduced copying in unwind.
@@ -140,6 +182,7 @@ void performSplitPipelineOptimizations(Pipeline* shardPipeline, Pipeline* mergin
     // The order in which optimizations are applied can have significant impact on the
     // efficiency of the final pipeline. Be Careful!
     findSplitPoint(shardPipeline, mergingPipeline);
+    pushTopKSortOnGroupKeyToShards(shardPipeline, mergingPipeline);
     moveFinalUnwindFromShardsToMerger(shardPipeline, mergingPipeline);
     limitFieldsSentFromShardsToMerger(shardPipeline, mergingPipeline);
 }
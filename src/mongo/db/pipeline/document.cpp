@@ -48,7 +48,42 @@ const DocumentStorage DocumentStorage::kEmptyDoc;
 const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore, Document::metaFieldRandVal, Document::metaFieldSortKey};
 
+DocumentStorage::DocumentStorage(BSONObj bson) : DocumentStorage() {
+    invariant(bson.isOwned());
+
+    // Metadata has its own accessors, so it has to be known up front. Finding it only requires
+    // walking the field names, which is much cheaper than decoding the values.
+    BSONForEach(elem, bson) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName[0] != '$')
+            continue;
+
+        if (fieldName == Document::metaFieldTextScore) {
+            setTextScore(elem.Double());
+            _bsonHasMetadata = true;
+        } else if (fieldName == Document::metaFieldRandVal) {
+            setRandMetaField(elem.Double());
+            _bsonHasMetadata = true;
+        } else if (fieldName == Document::metaFieldSortKey) {
+            setSortKeyMetaField(elem.Obj());
+            _bsonHasMetadata = true;
+        }
+    }
+
+    _bson = std::move(bson);
+}
+
 Position DocumentStorage::findField(StringData requested) const {
+    Position pos = findFieldInCache(requested);
+    if (pos.found() || MONGO_likely(!isLazy()))
+        return pos;
+
+    // Decoding a field doesn't change the logical contents of the document. See loadLazyFields()
+    // for why lazily loaded storage has no concurrent readers.
+    return const_cast<DocumentStorage*>(this)->loadLazyField(requested);
+}
+
+Position DocumentStorage::findFieldInCache(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -56,7 +91,8 @@ Position DocumentStorage::findField(StringData requested) const {
 
         Position pos = _hashTab[bucket];
         while (pos.found()) {
-            const ValueElement& elem = getField(pos);
+            // Forwarded elements are taken out of the hash table by fillCache().
+            const ValueElement& elem = elementAt(pos);
             if (elem.nameLen == reqSize && memcmp(requested.rawData(), elem._name, reqSize) == 0) {
                 return pos;
             }
@@ -66,7 +102,8 @@ Position DocumentStorage::findField(StringData requested) const {
         }
     } else {  // linear scan
         for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
-            if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
+            if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0 &&
+                !isForwarded(*it)) {
                 return it.position();
             }
         }
@@ -76,6 +113,103 @@ Position DocumentStorage::findField(StringData requested) const {
     return Position();
 }
 
+bool DocumentStorage::isLazyMetadataField(const BSONElement& elem) const {
+    if (!_bsonHasMetadata)
+        return false;
+
+    auto fieldName = elem.fieldNameStringData();
+    return fieldName[0] == '$' &&
+        (fieldName == Document::metaFieldTextScore || fieldName == Document::metaFieldRandVal ||
+         fieldName == Document::metaFieldSortKey);
+}
+
+Position DocumentStorage::loadLazyField(StringData name) {
+    dassert(isLazy());
+
+    // Scanning the backing BSON is linear in the number of fields, so once a document has been
+    // probed for enough different fields, decode all of them and switch to hash lookups.
+    if (++_lazyScans >= LAZY_SCANS_BEFORE_FILL) {
+        fillCache();
+        return findFieldInCache(name);
+    }
+
+    BSONForEach(elem, _bson) {
+        if (elem.fieldNameStringData() == name && !isLazyMetadataField(elem)) {
+            const Position pos = getNextPosition();
+            appendField(name) = Value(elem);
+            return pos;
+        }
+    }
+
+    return Position();
+}
+
+void DocumentStorage::fillCache() {
+    dassert(isLazy());
+
+    // Fields that were looked up before this point were appended in lookup order. As long as that
+    // matches the order of the backing BSON they can stay where they are. From the first mismatch
+    // on, every field is appended in BSON order and any earlier decoded copy is forwarded to it, so
+    // that Positions that were already handed out stay valid.
+    const unsigned fillStart = _usedBytes;
+    unsigned inOrderEnd = 0;
+    bool inOrder = true;
+    std::vector<std::pair<Position, Position>> forwarded;
+
+    BSONForEach(elem, _bson) {
+        if (isLazyMetadataField(elem))
+            continue;
+
+        const StringData name = elem.fieldNameStringData();
+        if (inOrder && inOrderEnd < fillStart) {
+            const ValueElement& next = elementAt(Position(inOrderEnd));
+            if (next.nameSD() == name) {
+                inOrderEnd = next.next()->ptr() - _buffer;
+                continue;
+            }
+        }
+        inOrder = false;
+
+        // Only fields decoded out of order can be reused, and only once: a lookup never decodes a
+        // value that is missing, so one which is has already been moved. A field with a duplicate
+        // name is decoded again.
+        const Position cached = findFieldInCache(name);
+        const Position pos = getNextPosition();
+        Value& val = appendField(name);
+        if (cached.found() && cached.index >= inOrderEnd && cached.index < fillStart &&
+            !elementAt(cached).val.missing()) {
+            val = std::move(elementAt(cached).val);
+            forwarded.emplace_back(cached, pos);
+        } else {
+            val = Value(elem);
+        }
+    }
+
+    // 'nextCollision' links the hash table until the forwarded elements are taken out of it.
+    for (auto&& forward : forwarded) {
+        elementAt(forward.first).nextCollision = Position(forward.second.index | kForwardedBit);
+    }
+    if (!forwarded.empty() && _numFields >= HASH_TAB_MIN) {
+        rehash();
+    }
+
+    _bson = BSONObj();
+}
+
+void DocumentStorage::appendLazyFieldsTo(BSONObjBuilder* builder) const {
+    invariant(isLazy());
+
+    if (!_bsonHasMetadata) {
+        builder->appendElements(_bson);
+        return;
+    }
+
+    BSONForEach(elem, _bson) {
+        if (!isLazyMetadataField(elem))
+            builder->append(elem);
+    }
+}
+
 Value& DocumentStorage::appendField(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
@@ -103,7 +237,7 @@ Value& DocumentStorage::appendField(StringData name) {
 #undef append
 
     // Make sure next field starts where we expect it
-    fassert(16486, getField(pos).next()->ptr() == _buffer + _usedBytes);
+    fassert(16486, elementAt(pos).next()->ptr() == _buffer + _usedBytes);
 
     _numFields++;
 
@@ -114,12 +248,12 @@ Value& DocumentStorage::appendField(StringData name) {
         rehash();
     }
 
-    return getField(pos).val;
+    return elementAt(pos).val;
 }
 
 // Call after adding field to _fields and increasing _numFields
 void DocumentStorage::addFieldToHashTable(Position pos) {
-    ValueElement& elem = getField(pos);
+    ValueElement& elem = elementAt(pos);
     elem.nextCollision = Position();
 
     const unsigned bucket = bucketForKey(elem.nameSD());
@@ -127,7 +261,7 @@ void DocumentStorage::addFieldToHashTable(Position pos) {
     Position* posPtr = &_hashTab[bucket];
     while (posPtr->found()) {
         // collision: walk links and add new to end
-        posPtr = &getField(*posPtr).nextCollision;
+        posPtr = &elementAt(*posPtr).nextCollision;
     }
     *posPtr = Position(pos.index);
 }
@@ -186,6 +320,9 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    // The clone will be modified, so it can't share the backing BSON.
+    loadLazyFields();
+
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
     // Make a copy of the buffer.
@@ -258,6 +395,15 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // A lazily loaded top-level document is unmodified, so its backing BSON can be copied as is.
+    // That skips the depth check of the nested documents. It isn't needed because the output is
+    // exactly as deep as the backing BSON, which came out of a collection, and documents are only
+    // stored within BSONDepth::getMaxAllowableDepth().
+    if (recursionLevel == 1 && storage().isLazy()) {
+        storage().appendLazyFieldsTo(builder);
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
@@ -312,6 +458,10 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+Document Document::fromBsonWithMetaDataLazy(const BSONObj& bson) {
+    return Document(new DocumentStorage(bson.getOwned()));
+}
+
 MutableDocument::MutableDocument(size_t expectedFields)
     : _storageHolder(NULL), _storage(_storageHolder) {
     if (expectedFields) {
@@ -382,8 +532,10 @@ size_t Document::getApproximateSize() const {
 
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
+    size += storage().lazyBsonBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Visits only the fields decoded so far. Missing values don't add anything beyond the buffer.
+    for (DocumentStorageIterator it = storage().iteratorAll(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
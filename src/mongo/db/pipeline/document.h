@@ -217,6 +217,17 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData, but each field is only decoded from 'bson' when it is first looked
+     * up, so consumers that touch a few fields of a large document don't pay to convert all of
+     * them. Iterating, modifying or cloning the result decodes every field. Takes shared ownership
+     * of 'bson' if it is owned, and copies it otherwise.
+     *
+     * Since reading the result may decode fields into it, unlike other documents it must not be
+     * read by several threads at once.
+     */
+    static Document fromBsonWithMetaDataLazy(const BSONObj& bson);
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
@@ -572,7 +583,11 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        DocumentStorage& storage = const_cast<DocumentStorage&>(*storagePtr());
+
+        // Lazily loaded storage must be fully decoded before it can be modified.
+        storage.loadLazyFields();
+        return storage;
     }
     DocumentStorage& newStorage() {
         reset(new DocumentStorage);
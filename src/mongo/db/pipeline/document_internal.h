@@ -167,6 +167,7 @@ private:
     }
 
     void skipMissing() {
+        // Forwarded elements always hold a missing value.
         while (!atEnd() && _it->val.missing()) {
             advanceOne();
         }
@@ -189,7 +190,16 @@ public:
           _hashTabMask(0),
           _metaFields(),
           _textScore(0),
-          _randVal(0) {}
+          _randVal(0),
+          _lazyScans(0),
+          _bsonHasMetadata(false) {}
+
+    /**
+     * Creates storage backed by the owned object 'bson', whose fields are only decoded when they
+     * are first looked up. Top-level metadata fields are parsed up front, as in
+     * Document::fromBsonWithMetaData(), and are not visible as regular fields.
+     */
+    explicit DocumentStorage(BSONObj bson);
 
     ~DocumentStorage();
 
@@ -224,7 +234,10 @@ public:
     // Document uses these
     const ValueElement& getField(Position pos) const {
         verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        const ValueElement* elem = &elementAt(pos);
+        if (MONGO_unlikely(isForwarded(*elem)))
+            elem = &elementAt(forwardedTo(*elem));
+        return *elem;
     }
     Value getField(StringData name) const {
         Position pos = findField(name);
@@ -236,7 +249,10 @@ public:
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
         verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        ValueElement* elem = &elementAt(pos);
+        if (MONGO_unlikely(isForwarded(*elem)))
+            elem = &elementAt(forwardedTo(*elem));
+        return *elem;
     }
     Value& getField(StringData name) {
         Position pos = findField(name);
@@ -253,12 +269,13 @@ public:
      */
     void reserveFields(size_t expectedFields);
 
-    /// This skips missing values
+    /// This skips missing values. Decodes any fields that are still being loaded lazily.
     DocumentStorageIterator iterator() const {
+        loadLazyFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
-    /// This includes missing values
+    /// This includes missing values. Only fields that have already been decoded are visited.
     DocumentStorageIterator iteratorAll() const {
         return DocumentStorageIterator(_firstElement, end(), true);
     }
@@ -270,6 +287,37 @@ public:
         return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
     }
 
+    /// True if some fields of this document have not been decoded from its backing BSON yet.
+    bool isLazy() const {
+        return !_bson.isEmpty();
+    }
+
+    /// Size of the backing BSON that lazily loaded fields are decoded from, or 0.
+    size_t lazyBsonBytes() const {
+        return isLazy() ? _bson.objsize() : 0;
+    }
+
+    /**
+     * Decodes every field that is still only present in the backing BSON. This doesn't change the
+     * logical contents of the document, so it is allowed on shared, const storage.
+     *
+     * It does change the buffer though, which is why lazily loaded storage must not have concurrent
+     * readers, unlike other storage (see the thread-safety notes on Value). Only
+     * DocumentSourceCursor creates it, and its documents are only read by the thread running the
+     * pipeline, one operation at a time.
+     */
+    void loadLazyFields() const {
+        if (MONGO_unlikely(isLazy()))
+            const_cast<DocumentStorage*>(this)->fillCache();
+    }
+
+    /**
+     * Appends the fields of a lazily loaded document straight from its backing BSON, without
+     * decoding them. Only valid while isLazy() is true; such storage is never modified, so the
+     * backing BSON is exact.
+     */
+    void appendLazyFieldsTo(BSONObjBuilder* builder) const;
+
     /**
      * Copies all metadata from source if it has any.
      * Note: does not clear metadata from this.
@@ -320,6 +368,46 @@ public:
     }
 
 private:
+    /**
+     * An element whose value was moved to a later element when a lazily loaded document was fully
+     * decoded has this bit set in its 'nextCollision', and the Position of that later element in
+     * the other bits. Hash chains never set it, as buffers are much smaller. Such elements hold a
+     * missing value and are skipped by lookups and iteration. See fillCache().
+     */
+    static constexpr unsigned kForwardedBit = 1u << 31;
+    MONGO_STATIC_ASSERT(static_cast<unsigned>(BufferMaxSize) < kForwardedBit);
+
+    static bool isForwarded(const ValueElement& elem) {
+        return elem.nextCollision.found() && (elem.nextCollision.index & kForwardedBit);
+    }
+    static Position forwardedTo(const ValueElement& elem) {
+        return Position(elem.nextCollision.index & ~kForwardedBit);
+    }
+
+    /// Raw access to an element, without following forwarded elements.
+    const ValueElement& elementAt(Position pos) const {
+        return *(_firstElement->plusBytes(pos.index));
+    }
+    ValueElement& elementAt(Position pos) {
+        return *(_firstElement->plusBytes(pos.index));
+    }
+
+    /// Same as findField() but only considers fields that have already been decoded.
+    Position findFieldInCache(StringData name) const;
+
+    /// Decodes the named field from the backing BSON, or decodes all fields once
+    /// LAZY_SCANS_BEFORE_FILL lookups have had to scan it. Returns Position() if there is no field.
+    Position loadLazyField(StringData name);
+
+    /**
+     * Decodes every remaining field of the backing BSON and releases it. Afterwards the elements in
+     * the buffer are in the same order as the fields of the backing BSON.
+     */
+    void fillCache();
+
+    /// True if 'elem' is a top-level metadata field of the backing BSON.
+    bool isLazyMetadataField(const BSONElement& elem) const;
+
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
@@ -363,14 +451,18 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
-            addFieldToHashTable(it.position());
+        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+            if (!isForwarded(*it))
+                addFieldToHashTable(it.position());
+        }
     }
 
     enum {
-        HASH_TAB_INIT_SIZE = 8,  // must be power of 2
-        HASH_TAB_MIN = 4,        // don't hash fields for docs smaller than this
-                                 // set to 1 to always hash
+        HASH_TAB_INIT_SIZE = 8,      // must be power of 2
+        HASH_TAB_MIN = 4,            // don't hash fields for docs smaller than this
+                                     // set to 1 to always hash
+        LAZY_SCANS_BEFORE_FILL = 8,  // decode and hash all fields of a lazily loaded document
+                                     // after this many lookups had to scan its backing BSON
     };
 
     // _buffer layout:
@@ -401,6 +493,14 @@ private:
     double _textScore;
     double _randVal;
     BSONObj _sortKey;
+
+    // Backing BSON of a lazily loaded document. Fields are decoded from it into the buffer on first
+    // lookup, and it is released once all of them have been decoded. It is empty for all other
+    // documents. Storage is only ever lazy while it is read-only: MutableDocument decodes all
+    // fields before making changes.
+    BSONObj _bson;
+    unsigned _lazyScans;    // number of lookups that have had to scan '_bson'
+    bool _bsonHasMetadata;  // '_bson' has top-level metadata fields that must be skipped
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
@@ -35,6 +35,7 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/util/scopeguard.h"
 
@@ -87,6 +88,10 @@ void DocumentSourceCursor::loadBatch() {
                     _currentBatch.push_back(Document());
                 } else if (_dependencies) {
                     _currentBatch.push_back(_dependencies->extractFields(resultObj));
+                } else if (internalDocumentSourceCursorLazyDocuments.load()) {
+                    // The pipeline may only look at a few fields of each document, so defer
+                    // decoding them until they are needed.
+                    _currentBatch.push_back(Document::fromBsonWithMetaDataLazy(resultObj));
                 } else {
                     _currentBatch.push_back(Document::fromBsonWithMetaData(resultObj));
                 }
@@ -828,6 +828,16 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
     return out.freeze();
 }
 
+bool DocumentSourceGroup::isIdNeverArray() const {
+    if (!_idFieldNames.empty()) {
+        return true;
+    }
+
+    invariant(_idExpressions.size() == 1);
+    auto constant = dynamic_cast<ExpressionConstant*>(_idExpressions[0].get());
+    return constant && constant->getValue().getType() != Array;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceGroup::getShardSource() {
     return this;  // No modifications necessary when on shard
 }
@@ -99,6 +99,12 @@ public:
         return _streaming;
     }
 
+    /**
+     * Returns true if the _id of every group is known to be a document or a constant other than an
+     * array, and so cannot compare equal to the _id of another group when sorting by _id.
+     */
+    bool isIdNeverArray() const;
+
     // Virtuals for NeedsMergerDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final;
@@ -30,7 +30,10 @@
 
 #include "mongo/db/pipeline/document_source_out.h"
 
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/ops/write_ops.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/destructor_guard.h"
 
@@ -49,19 +52,65 @@ DocumentSourceOut::~DocumentSourceOut() {
         });
 }
 
-std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceOut::liteParse(
-    const AggregationRequest& request, const BSONElement& spec) {
+DocumentSourceOutSpec DocumentSourceOut::parseOutSpec(const BSONElement& spec) {
+    DocumentSourceOutSpec outSpec;
+    if (spec.type() == BSONType::String) {
+        outSpec.setTo(spec.valueStringData());
+        return outSpec;
+    }
+
     uassert(ErrorCodes::TypeMismatch,
-            str::stream() << "$out stage requires a string argument, but found "
+            str::stream() << "$out stage requires a string or object argument, but found "
                           << typeName(spec.type()),
-            spec.type() == BSONType::String);
+            spec.type() == BSONType::Object);
+    outSpec = DocumentSourceOutSpec::parse(IDLParserErrorContext("$out"), spec.embeddedObject());
+
+    const bool matchesExistingDocuments = outSpec.getMode() == OutputModeEnum::kReplaceDocuments ||
+        outSpec.getMode() == OutputModeEnum::kMergeDocuments;
+    if (auto uniqueKey = outSpec.getUniqueKey()) {
+        uassert(ErrorCodes::InvalidOptions,
+                str::stream() << "$out only supports a 'uniqueKey' with mode '"
+                              << OutputMode_serializer(OutputModeEnum::kReplaceDocuments)
+                              << "' or '"
+                              << OutputMode_serializer(OutputModeEnum::kMergeDocuments)
+                              << "'",
+                matchesExistingDocuments);
+        uassert(ErrorCodes::InvalidOptions,
+                "$out requires a non-empty 'uniqueKey'",
+                !uniqueKey->isEmpty());
+        for (auto&& elem : *uniqueKey) {
+            // Validates the path.
+            FieldPath path(elem.fieldName());
+        }
+        outSpec.setUniqueKey(uniqueKey->getOwned());
+    } else if (matchesExistingDocuments) {
+        outSpec.setUniqueKey(BSON("_id" << 1));
+    }
+
+    return outSpec;
+}
 
-    NamespaceString targetNss(request.getNamespaceString().db(), spec.valueStringData());
+std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceOut::liteParse(
+    const AggregationRequest& request, const BSONElement& spec) {
+    auto outSpec = parseOutSpec(spec);
+
+    NamespaceString targetNss(request.getNamespaceString().db(), outSpec.getTo());
     uassert(ErrorCodes::InvalidNamespace,
             str::stream() << "Invalid $out target namespace, " << targetNss.ns(),
             targetNss.isValid());
 
-    ActionSet actions{ActionType::remove, ActionType::insert};
+    ActionSet actions{ActionType::insert};
+    switch (outSpec.getMode()) {
+        case OutputModeEnum::kReplaceCollection:
+            actions.addAction(ActionType::remove);
+            break;
+        case OutputModeEnum::kInsertDocuments:
+            break;
+        case OutputModeEnum::kReplaceDocuments:
+        case OutputModeEnum::kMergeDocuments:
+            actions.addAction(ActionType::update);
+            break;
+    }
     if (request.shouldBypassDocumentValidation()) {
         actions.addAction(ActionType::bypassDocumentValidation);
     }
@@ -144,11 +193,111 @@ void DocumentSourceOut::initialize() {
     _initialized = true;
 }
 
+void DocumentSourceOut::initializeInPlace() {
+    // The results are written through the direct client, so they have to stay on this shard.
+    uassert(50850,
+            str::stream() << "namespace '" << _outputNs.ns()
+                          << "' is sharded so it can't be used for $out",
+            !pExpCtx->mongoProcessInterface->isSharded(pExpCtx->opCtx, _outputNs));
+
+    // Upserting by a key is only well defined if no two target documents can share it. That is
+    // always the case for _id; any other key must be covered by a unique index.
+    if (!_uniqueKey.isEmpty() && !_uniqueKey.hasField("_id")) {
+        std::set<StringData> uniqueKeyFields;
+        for (auto&& elem : _uniqueKey) {
+            uniqueKeyFields.insert(elem.fieldNameStringData());
+        }
+
+        bool foundUniqueIndex = false;
+        DBClientBase* conn = pExpCtx->mongoProcessInterface->directClient();
+        for (auto&& indexSpec : conn->getIndexSpecs(_outputNs.ns())) {
+            if (!indexSpec["unique"].trueValue() || indexSpec.hasField("partialFilterExpression"))
+                continue;
+
+            std::set<StringData> indexFields;
+            for (auto&& elem : indexSpec["key"].Obj()) {
+                indexFields.insert(elem.fieldNameStringData());
+            }
+            if (indexFields == uniqueKeyFields) {
+                foundUniqueIndex = true;
+                break;
+            }
+        }
+        uassert(50851,
+                str::stream() << "$out requires a unique index on the 'uniqueKey' fields "
+                              << _uniqueKey
+                              << " of namespace '"
+                              << _outputNs.ns()
+                              << "'",
+                foundUniqueIndex);
+    }
+
+    _initialized = true;
+}
+
+BSONObj DocumentSourceOut::makeUniqueKeyQuery(const BSONObj& obj) const {
+    BSONObjBuilder query;
+    for (auto&& keyElem : _uniqueKey) {
+        auto path = keyElem.fieldNameStringData();
+        auto elem = dotted_path_support::extractElementAtPath(obj, path);
+        uassert(50852,
+                str::stream() << "$out cannot write a document that is missing the 'uniqueKey' "
+                              << "field '"
+                              << path
+                              << "'",
+                !elem.eoo());
+        uassert(50853,
+                str::stream() << "$out cannot write a document whose 'uniqueKey' field '" << path
+                              << "' is an array",
+                elem.type() != BSONType::Array);
+
+        // Match with $eq so that object values are never interpreted as query operators.
+        BSONObjBuilder eq(query.subobjStart(path));
+        eq.appendAs(elem, "$eq");
+    }
+    return query.obj();
+}
+
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
-    BSONObj err = pExpCtx->mongoProcessInterface->insert(pExpCtx, _tempNs, toInsert);
-    uassert(16996,
-            str::stream() << "insert for $out failed: " << err,
-            DBClientBase::getLastErrorString(err).empty());
+    switch (_mode) {
+        case OutputModeEnum::kReplaceCollection:
+        case OutputModeEnum::kInsertDocuments: {
+            const auto& targetNs =
+                _mode == OutputModeEnum::kReplaceCollection ? _tempNs : _outputNs;
+            BSONObj err = pExpCtx->mongoProcessInterface->insert(pExpCtx, targetNs, toInsert);
+            uassert(16996,
+                    str::stream() << "insert for $out failed: " << err,
+                    DBClientBase::getLastErrorString(err).empty());
+            return;
+        }
+        case OutputModeEnum::kReplaceDocuments:
+        case OutputModeEnum::kMergeDocuments: {
+            // A target document matched by another key keeps its own _id, which cannot be
+            // modified, so the result's _id is left out of the update.
+            const bool keepId = _uniqueKey.hasField("_id");
+
+            vector<BSONObj> queries;
+            vector<BSONObj> updates;
+            queries.reserve(toInsert.size());
+            updates.reserve(toInsert.size());
+            for (auto&& obj : toInsert) {
+                queries.push_back(makeUniqueKeyQuery(obj));
+                auto update = keepId ? obj : obj.removeField("_id");
+                updates.push_back(_mode == OutputModeEnum::kMergeDocuments
+                                      ? BSON("$set" << update)
+                                      : update);
+            }
+
+            BSONObj reply = pExpCtx->mongoProcessInterface->update(
+                pExpCtx, _outputNs, queries, updates, /*upsert*/ true, /*multi*/ false);
+            auto status = getStatusFromWriteCommandReply(reply);
+            uassert(50854,
+                    str::stream() << "update for $out failed: " << status.reason(),
+                    status.isOK());
+            return;
+        }
+    }
+    MONGO_UNREACHABLE;
 }
 
 DocumentSource::GetNextResult DocumentSourceOut::getNext() {
@@ -159,10 +308,17 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
     }
 
     if (!_initialized) {
-        initialize();
+        if (_mode == OutputModeEnum::kReplaceCollection) {
+            initialize();
+        } else {
+            initializeInPlace();
+        }
     }
 
-    // Insert all documents into temp collection, batching to perform vectored inserts.
+    // Write all documents, batching to perform vectored writes. The modes that match existing
+    // documents send each document twice per statement in the worst case (as the update and as
+    // part of the query), so they get half the byte budget.
+    const int maxBatchBytes = _uniqueKey.isEmpty() ? BSONObjMaxUserSize : BSONObjMaxUserSize / 2;
     vector<BSONObj> bufferedObjects;
     int bufferedBytes = 0;
 
@@ -171,7 +327,7 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
         BSONObj toInsert = nextInput.releaseDocument().toBson();
 
         bufferedBytes += toInsert.objsize();
-        if (!bufferedObjects.empty() && (bufferedBytes > BSONObjMaxUserSize ||
+        if (!bufferedObjects.empty() && (bufferedBytes > maxBatchBytes ||
                                          bufferedObjects.size() >= write_ops::kMaxWriteBatchSize)) {
             spill(bufferedObjects);
             bufferedObjects.clear();
@@ -190,6 +346,11 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            if (_mode != OutputModeEnum::kReplaceCollection) {
+                // Everything was written to the target collection directly.
+                _done = true;
+                return nextInput;
+            }
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
@@ -211,17 +372,23 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
 }
 
 DocumentSourceOut::DocumentSourceOut(const NamespaceString& outputNs,
+                                     OutputModeEnum mode,
+                                     BSONObj uniqueKey,
                                      const intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSource(pExpCtx),
       _done(false),
       _tempNs(""),  // Filled in during getNext().
-      _outputNs(outputNs) {}
+      _outputNs(outputNs),
+      _mode(mode),
+      _uniqueKey(std::move(uniqueKey)) {}
 
 intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
     uassert(16990,
-            str::stream() << "$out only supports a string argument, not " << typeName(elem.type()),
-            elem.type() == String);
+            str::stream() << "$out only supports a string or object argument, not "
+                          << typeName(elem.type()),
+            elem.type() == String || elem.type() == Object);
+    auto outSpec = parseOutSpec(elem);
 
     auto readConcernLevel = repl::ReadConcernArgs::get(pExpCtx->opCtx).getLevel();
     uassert(ErrorCodes::InvalidOptions,
@@ -229,16 +396,37 @@ intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
             readConcernLevel != repl::ReadConcernLevel::kMajorityReadConcern &&
                 readConcernLevel != repl::ReadConcernLevel::kSnapshotReadConcern);
 
-    NamespaceString outputNs(pExpCtx->ns.db().toString() + '.' + elem.str());
-    uassert(17385, "Can't $out to special collection: " + elem.str(), !outputNs.isSpecial());
-    return new DocumentSourceOut(outputNs, pExpCtx);
+    NamespaceString outputNs(pExpCtx->ns.db().toString() + '.' + outSpec.getTo().toString());
+    uassert(17385,
+            "Can't $out to special collection: " + outSpec.getTo().toString(),
+            !outputNs.isSpecial());
+
+    // The modes which write to the target collection in place would otherwise modify the
+    // documents which the pipeline is still reading, so that it could see its own writes.
+    uassert(50867,
+            str::stream() << "$out with mode '" << OutputMode_serializer(outSpec.getMode())
+                          << "' cannot write to the collection it is aggregating, '"
+                          << outputNs.ns()
+                          << "'",
+            outSpec.getMode() == OutputModeEnum::kReplaceCollection || outputNs != pExpCtx->ns);
+    return new DocumentSourceOut(
+        outputNs, outSpec.getMode(), outSpec.getUniqueKey().value_or(BSONObj()), pExpCtx);
 }
 
 Value DocumentSourceOut::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     massert(
         17000, "$out shouldn't have different db than input", _outputNs.db() == pExpCtx->ns.db());
 
-    return Value(DOC(getSourceName() << _outputNs.coll()));
+    // Keep the original string form for the default mode, which older versions understand.
+    if (_mode == OutputModeEnum::kReplaceCollection) {
+        return Value(DOC(getSourceName() << _outputNs.coll()));
+    }
+
+    DocumentSourceOutSpec spec;
+    spec.setTo(_outputNs.coll());
+    spec.setMode(_mode);
+    spec.setUniqueKey(_uniqueKey);
+    return Value(DOC(getSourceName() << spec.toBSON()));
 }
 
 DocumentSource::GetDepsReturn DocumentSourceOut::getDependencies(DepsTracker* deps) const {
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_sources_gen.h"
 
 namespace mongo {
 
@@ -65,12 +66,22 @@ public:
         return _outputNs;
     }
 
+    OutputModeEnum getMode() const {
+        return _mode;
+    }
+
     /**
       Create a document source for output and pass-through.
 
       This can be put anywhere in a pipeline and will store content as
       well as pass it on.
 
+      The specification is either the name of the output collection, which replaces the contents
+      of that collection, or an object of the form
+      {to: <collection>, mode: <OutputMode>, uniqueKey: <object>}. Only the default mode can
+      write to the collection being aggregated. When 'uniqueKey' doesn't contain _id, the
+      matched documents keep their _id and upserted ones get a new one.
+
       @param pBsonElement the raw BSON specification for the source
       @param pExpCtx the expression context for the pipeline
       @returns the newly created document source
@@ -80,8 +91,16 @@ public:
 
 private:
     DocumentSourceOut(const NamespaceString& outputNs,
+                      OutputModeEnum mode,
+                      BSONObj uniqueKey,
                       const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    /**
+     * Parses either form of the $out specification. The returned spec always has a 'uniqueKey'
+     * when its mode is kReplaceDocuments or kMergeDocuments.
+     */
+    static DocumentSourceOutSpec parseOutSpec(const BSONElement& spec);
+
     /**
      * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
      * sharded or capped, and saves the collection options and indexes of the target collection.
@@ -93,10 +112,24 @@ private:
     void initialize();
 
     /**
-     * Inserts all of 'toInsert' into the temporary collection.
+     * Used instead of initialize() by the modes that write to the target collection in place.
+     * Makes sure the target collection isn't sharded and, for the modes that match existing
+     * documents, that a unique index covers '_uniqueKey' so that each result matches at most one
+     * document.
+     */
+    void initializeInPlace();
+
+    /**
+     * Writes all of 'toInsert' to the temporary collection, or to the target collection if the
+     * mode doesn't replace it.
      */
     void spill(const std::vector<BSONObj>& toInsert);
 
+    /**
+     * Returns the query that selects the target document of 'obj' by the fields of '_uniqueKey'.
+     */
+    BSONObj makeUniqueKeyQuery(const BSONObj& obj) const;
+
     bool _initialized = false;
     bool _done = false;
 
@@ -107,6 +140,12 @@ private:
 
     NamespaceString _tempNs;          // output goes here as it is being processed.
     const NamespaceString _outputNs;  // output will go here after all data is processed.
+
+    const OutputModeEnum _mode;
+
+    // The fields that identify the target document of each result in the modes that match
+    // existing documents. Empty otherwise.
+    const BSONObj _uniqueKey;
 };
 
 }  // namespace mongo
@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/intrusive_ptr.hpp>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+class DocumentSourceOutTest : public AggregationContextFixture {
+public:
+    intrusive_ptr<DocumentSourceOut> createOutStage(BSONObj spec) {
+        auto source = DocumentSourceOut::createFromBson(spec.firstElement(), getExpCtx());
+        auto out = dynamic_cast<DocumentSourceOut*>(source.get());
+        ASSERT(out);
+        return out;
+    }
+};
+
+TEST_F(DocumentSourceOutTest, StringSpecReplacesCollection) {
+    auto out = createOutStage(BSON("$out"
+                                   << "target"));
+    ASSERT_EQ(out->getOutputNs().coll(), "target");
+    ASSERT(out->getMode() == OutputModeEnum::kReplaceCollection);
+    ASSERT_VALUE_EQ(out->serialize()["$out"], Value("target"_sd));
+}
+
+TEST_F(DocumentSourceOutTest, ObjectSpecDefaultsToReplaceCollection) {
+    auto out = createOutStage(BSON("$out" << BSON("to"
+                                                  << "target")));
+    ASSERT(out->getMode() == OutputModeEnum::kReplaceCollection);
+    ASSERT_VALUE_EQ(out->serialize()["$out"], Value("target"_sd));
+}
+
+TEST_F(DocumentSourceOutTest, MergeModeDefaultsUniqueKeyToId) {
+    auto out = createOutStage(BSON("$out" << BSON("to"
+                                                  << "target"
+                                                  << "mode"
+                                                  << "mergeDocuments")));
+    ASSERT(out->getMode() == OutputModeEnum::kMergeDocuments);
+    ASSERT_VALUE_EQ(out->serialize()["$out"],
+                    Value(Document{{"to", "target"_sd},
+                                   {"mode", "mergeDocuments"_sd},
+                                   {"uniqueKey", Document{{"_id", 1}}}}));
+}
+
+TEST_F(DocumentSourceOutTest, ReplaceModeRoundTripsUniqueKey) {
+    auto out = createOutStage(BSON("$out" << BSON("to"
+                                                  << "target"
+                                                  << "mode"
+                                                  << "replaceDocuments"
+                                                  << "uniqueKey"
+                                                  << BSON("a.b" << 1 << "c" << 1))));
+    auto serialized = out->serialize()["$out"];
+    ASSERT_VALUE_EQ(serialized["uniqueKey"], Value(Document{{"a.b", 1}, {"c", 1}}));
+
+    auto reparsed = createOutStage(BSON("$out" << serialized.getDocument().toBson()));
+    ASSERT(reparsed->getMode() == OutputModeEnum::kReplaceDocuments);
+    ASSERT_VALUE_EQ(reparsed->serialize()["$out"], serialized);
+}
+
+TEST_F(DocumentSourceOutTest, FailsWithInvalidSpecType) {
+    ASSERT_THROWS_CODE(createOutStage(BSON("$out" << 1)), AssertionException, 16990);
+}
+
+TEST_F(DocumentSourceOutTest, FailsWithUnknownMode) {
+    ASSERT_THROWS_CODE(createOutStage(BSON("$out" << BSON("to"
+                                                          << "target"
+                                                          << "mode"
+                                                          << "unknown"))),
+                       AssertionException,
+                       ErrorCodes::BadValue);
+}
+
+TEST_F(DocumentSourceOutTest, FailsWithUniqueKeyInInsertModes) {
+    ASSERT_THROWS_CODE(createOutStage(BSON("$out" << BSON("to"
+                                                          << "target"
+                                                          << "mode"
+                                                          << "insertDocuments"
+                                                          << "uniqueKey"
+                                                          << BSON("a" << 1)))),
+                       AssertionException,
+                       ErrorCodes::InvalidOptions);
+    ASSERT_THROWS_CODE(createOutStage(BSON("$out" << BSON("to"
+                                                          << "target"
+                                                          << "uniqueKey"
+                                                          << BSON("a" << 1)))),
+                       AssertionException,
+                       ErrorCodes::InvalidOptions);
+}
+
+TEST_F(DocumentSourceOutTest, FailsWithEmptyUniqueKey) {
+    ASSERT_THROWS_CODE(createOutStage(BSON("$out" << BSON("to"
+                                                          << "target"
+                                                          << "mode"
+                                                          << "mergeDocuments"
+                                                          << "uniqueKey"
+                                                          << BSONObj()))),
+                       AssertionException,
+                       ErrorCodes::InvalidOptions);
+}
+
+TEST_F(DocumentSourceOutTest, FailsWithInvalidUniqueKeyPath) {
+    ASSERT_THROWS(createOutStage(BSON("$out" << BSON("to"
+                                                     << "target"
+                                                     << "mode"
+                                                     << "mergeDocuments"
+                                                     << "uniqueKey"
+                                                     << BSON("$a" << 1)))),
+                  AssertionException);
+}
+
+TEST_F(DocumentSourceOutTest, InPlaceModesFailWithSourceCollectionAsTarget) {
+    for (auto mode : {"insertDocuments", "replaceDocuments", "mergeDocuments"}) {
+        ASSERT_THROWS_CODE(createOutStage(BSON("$out" << BSON("to" << getExpCtx()->ns.coll()
+                                                                   << "mode"
+                                                                   << mode))),
+                           AssertionException,
+                           50867);
+    }
+}
+
+TEST_F(DocumentSourceOutTest, ReplaceCollectionModeAllowsSourceCollectionAsTarget) {
+    auto out = createOutStage(BSON("$out" << getExpCtx()->ns.coll()));
+    ASSERT_EQ(out->getOutputNs(), getExpCtx()->ns);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,10 +33,12 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -59,6 +61,22 @@ const char* DocumentSourceSingleDocumentTransformation::getSourceName() const {
 DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (_batchPosition == _batch.size() && !_batchEndResult && shouldBatch()) {
+        loadBatch();
+    }
+
+    if (_batchPosition < _batch.size()) {
+        const size_t index = _batchPosition++;
+        Document input = std::move(_batch[index]);
+        return _parsedTransform->applyBatchedTransformation(input, _batchValues, index);
+    }
+
+    if (_batchEndResult) {
+        auto result = std::move(*_batchEndResult);
+        _batchEndResult = boost::none;
+        return result;
+    }
+
     // Get the next input document.
     auto input = pSource->getNext();
     if (!input.isAdvanced()) {
@@ -69,12 +87,44 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNex
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+bool DocumentSourceSingleDocumentTransformation::shouldBatch() const {
+    // Reading ahead is only safe from $cursor, which buffers its results anyway. Any other source
+    // could do work, or fail, on account of documents which would otherwise never be requested.
+    return internalDocumentSourceTransformationBatchSize.load() > 1 &&
+        _parsedTransform->canPrepareBatch() && dynamic_cast<DocumentSourceCursor*>(pSource);
+}
+
+void DocumentSourceSingleDocumentTransformation::loadBatch() {
+    const size_t batchSize = internalDocumentSourceTransformationBatchSize.load();
+
+    _batch.clear();
+    _batchValues.clear();
+    _batchPosition = 0;
+    while (_batch.size() < batchSize) {
+        auto input = pSource->getNext();
+        if (!input.isAdvanced()) {
+            _batchEndResult = std::move(input);
+            break;
+        }
+        _batch.push_back(input.releaseDocument());
+    }
+
+    if (!_batch.empty()) {
+        _parsedTransform->prepareBatch(_batch, &_batchValues);
+    }
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     _parsedTransform->optimize();
     return this;
 }
 
 void DocumentSourceSingleDocumentTransformation::doDispose() {
+    _batch.clear();
+    _batchValues.clear();
+    _batchPosition = 0;
+    _batchEndResult = boost::none;
+
     if (_parsedTransform) {
         // Cache the stage options document in case this stage is serialized after disposing.
         _cachedStageOptions = _parsedTransform->serializeStageOptions(pExpCtx->explain);
@@ -86,6 +86,37 @@ public:
             return false;
         }
 
+        /**
+         * Values computed by prepareBatch() for a batch of input documents, in a layout private to
+         * each transformer.
+         */
+        using BatchValues = std::vector<std::vector<Value>>;
+
+        /**
+         * Returns true if part of this transformation is cheaper to compute for many documents at
+         * once, through prepareBatch().
+         */
+        virtual bool canPrepareBatch() const {
+            return false;
+        }
+
+        /**
+         * Computes the parts of the transformations of all documents in 'batch' which can be
+         * shared. Must not throw on account of the contents of the documents, since some of them
+         * may never be returned. Anything that can fail is left to applyBatchedTransformation().
+         */
+        virtual void prepareBatch(const std::vector<Document>& batch, BatchValues* values) const {}
+
+        /**
+         * Equivalent to applyTransformation() for the document at 'index' of a batch which was
+         * passed to prepareBatch(), given the 'values' it computed.
+         */
+        virtual Document applyBatchedTransformation(const Document& input,
+                                                    const BatchValues& values,
+                                                    size_t index) {
+            return applyTransformation(input);
+        }
+
     private:
         friend class DocumentSourceSingleDocumentTransformation;
     };
@@ -134,6 +165,16 @@ protected:
                                                      Pipeline::SourceContainer* container) final;
 
 private:
+    /**
+     * Returns true if the input should be transformed a batch at a time.
+     */
+    bool shouldBatch() const;
+
+    /**
+     * Pulls the next batch of input documents and prepares their transformations.
+     */
+    void loadBatch();
+
     // Stores transformation logic.
     std::unique_ptr<TransformerInterface> _parsedTransform;
 
@@ -146,6 +187,16 @@ private:
     // Cached stage options in case this DocumentSource is disposed before serialized (e.g. explain
     // with a sort which will auto-dispose of the pipeline).
     Document _cachedStageOptions;
+
+    // The input documents read ahead for batched transformation, along with the values prepared
+    // for them. '_batchPosition' is the index of the next document to transform.
+    std::vector<Document> _batch;
+    TransformerInterface::BatchValues _batchValues;
+    size_t _batchPosition = 0;
+
+    // The result which ended the current batch early, such as EOF or a pause, if any. It is
+    // returned once all the documents in the batch have been.
+    boost::optional<GetNextResult> _batchEndResult;
 };
 
 }  // namespace mongo
@@ -111,6 +111,81 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(LazyDocument, LookupsDecodeOnlyRequestedFields) {
+    Document document = Document::fromBsonWithMetaDataLazy(BSON("a" << 1 << "b"
+                                                                    << "q"
+                                                                    << "c"
+                                                                    << BSON("d" << 2)));
+    ASSERT_EQUALS(2, document["c"]["d"].getInt());
+    ASSERT_EQUALS(1, document["a"].getInt());
+    ASSERT_TRUE(document["z"].missing());
+
+    // Iteration decodes the remaining fields and preserves the original field order.
+    ASSERT_EQUALS(3U, document.size());
+    ASSERT_EQUALS("a", getNthField(document, 0).first.toString());
+    ASSERT_EQUALS("b", getNthField(document, 1).first.toString());
+    ASSERT_EQUALS("q", getNthField(document, 1).second.getString());
+    ASSERT_EQUALS("c", getNthField(document, 2).first.toString());
+}
+
+TEST(LazyDocument, PositionsRemainValidAfterAllFieldsAreDecoded) {
+    Document document =
+        Document::fromBsonWithMetaDataLazy(BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4));
+    Position posD = document.positionOf("d");
+    Position posB = document.positionOf("b");
+    ASSERT_TRUE(posD.found());
+    ASSERT_TRUE(posB.found());
+
+    MutableDocument md(document);
+    md.setField(posD, mongo::Value(40));
+    md.setField(posB, mongo::Value(20));
+    ASSERT_DOCUMENT_EQ(md.freeze(), DOC("a" << 1 << "b" << 20 << "c" << 3 << "d" << 40));
+    ASSERT_DOCUMENT_EQ(document, DOC("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4));
+}
+
+TEST(LazyDocument, ManyLookupsOnLargeDocument) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.append(str::stream() << "f" << i, i);
+    }
+    BSONObj obj = builder.obj();
+
+    Document document = Document::fromBsonWithMetaDataLazy(obj);
+    for (int i = 99; i >= 0; i -= 3) {
+        ASSERT_EQUALS(i, document[str::stream() << "f" << i].getInt());
+    }
+    ASSERT_BSONOBJ_EQ(obj, document.toBson());
+    ASSERT_DOCUMENT_EQ(document, Document(obj));
+}
+
+TEST(LazyDocument, DuplicateFieldNames) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    Document document = Document::fromBsonWithMetaDataLazy(obj);
+    ASSERT_EQUALS(2, document["b"].getInt());
+    ASSERT_EQUALS(1, document["a"].getInt());
+    ASSERT_DOCUMENT_EQ(document, Document(obj));
+}
+
+TEST(LazyDocument, MetadataIsParsedEagerlyAndHidden) {
+    Document document = Document::fromBsonWithMetaDataLazy(
+        BSON("a" << 1 << Document::metaFieldTextScore << 10.0 << "b" << 2));
+    ASSERT_TRUE(document.hasTextScore());
+    ASSERT_EQ(10.0, document.getTextScore());
+    ASSERT_TRUE(document[Document::metaFieldTextScore].missing());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 2), document.toBson());
+    ASSERT_EQUALS(2U, document.size());
+}
+
+TEST(LazyDocument, CloneIsIndependent) {
+    Document document = Document::fromBsonWithMetaDataLazy(BSON("a" << 1 << "b" << 2));
+    ASSERT_EQUALS(2, document["b"].getInt());
+
+    MutableDocument md(document);
+    md.addField("c", mongo::Value(3));
+    ASSERT_DOCUMENT_EQ(md.freeze(), DOC("a" << 1 << "b" << 2 << "c" << 3));
+    ASSERT_DOCUMENT_EQ(document, DOC("a" << 1 << "b" << 2));
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -0,0 +1,374 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_vectorized.h"
+
+#include "mongo/base/compare_numbers.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+struct VectorizedExpression::Node {
+    enum class Op { kField, kConstant, kAdd, kSubtract, kMultiply, kDivide, kCond, kCompare };
+
+    explicit Node(Op op) : op(op) {}
+
+    bool isConstant(BSONType type) const {
+        return op == Op::kConstant && constant.getType() == type;
+    }
+
+    // Whether this node evaluates to a double, as opposed to an integral constant which is only
+    // allowed where it gets widened to a double.
+    bool producesDouble() const {
+        return op != Op::kConstant || constant.getType() == NumberDouble;
+    }
+
+    const Op op;
+
+    // For kField, the components of the path below the root document.
+    std::vector<std::string> path;
+
+    // For kConstant.
+    Value constant;
+
+    // For kCompare.
+    ExpressionCompare::CmpOp cmpOp = ExpressionCompare::EQ;
+
+    std::vector<std::unique_ptr<Node>> children;
+};
+
+namespace {
+
+using Node = VectorizedExpression::Node;
+using Column = std::vector<double>;
+
+// Doubles can represent every integer of at most this magnitude exactly.
+const long long kMaxPreciseDoubleInteger = 1ll << 53;
+
+std::unique_ptr<Node> compileDouble(const Expression& expr);
+
+/**
+ * Compiles an operand of an arithmetic expression or a comparison, which may also be an integral
+ * constant. Long constants are only allowed in comparisons if they convert to doubles exactly,
+ * since a long compares to a double by its exact value.
+ */
+std::unique_ptr<Node> compileNumeric(const Expression& expr, bool forComparison) {
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(&expr)) {
+        Value value = constant->getValue();
+        if (value.getType() == NumberInt ||
+            (value.getType() == NumberLong &&
+             (!forComparison || (value.getLong() <= kMaxPreciseDoubleInteger &&
+                                 value.getLong() >= -kMaxPreciseDoubleInteger)))) {
+            auto node = stdx::make_unique<Node>(Node::Op::kConstant);
+            node->constant = value;
+            return node;
+        }
+    }
+    return compileDouble(expr);
+}
+
+/**
+ * Compiles an arithmetic expression. Its result is only a double if at least one operand is.
+ */
+std::unique_ptr<Node> compileArithmetic(Node::Op op, const ExpressionNary& expr) {
+    const auto& operands = expr.getOperandList();
+    if (operands.empty()) {
+        return nullptr;
+    }
+
+    auto node = stdx::make_unique<Node>(op);
+    bool producesDouble = false;
+    for (auto&& operand : operands) {
+        auto child = compileNumeric(*operand, false);
+        if (!child) {
+            return nullptr;
+        }
+        producesDouble = producesDouble || child->producesDouble();
+        node->children.push_back(std::move(child));
+    }
+    return producesDouble ? std::move(node) : nullptr;
+}
+
+std::unique_ptr<Node> compilePredicate(const Expression& expr) {
+    auto compare = dynamic_cast<const ExpressionCompare*>(&expr);
+    if (!compare || compare->getOp() == ExpressionCompare::CMP) {
+        return nullptr;
+    }
+
+    auto node = stdx::make_unique<Node>(Node::Op::kCompare);
+    node->cmpOp = compare->getOp();
+    for (auto&& operand : compare->getOperandList()) {
+        auto child = compileNumeric(*operand, true);
+        if (!child) {
+            return nullptr;
+        }
+        node->children.push_back(std::move(child));
+    }
+    return node;
+}
+
+std::unique_ptr<Node> compileDouble(const Expression& expr) {
+    if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(&expr)) {
+        // Paths of length one refer to the whole document.
+        const auto& path = fieldPath->getFieldPath();
+        if (!fieldPath->isRootFieldPath() || path.getPathLength() < 2) {
+            return nullptr;
+        }
+        auto node = stdx::make_unique<Node>(Node::Op::kField);
+        for (size_t i = 1; i < path.getPathLength(); ++i) {
+            node->path.push_back(path.getFieldName(i).toString());
+        }
+        return node;
+    }
+
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(&expr)) {
+        if (constant->getValue().getType() != NumberDouble) {
+            return nullptr;
+        }
+        auto node = stdx::make_unique<Node>(Node::Op::kConstant);
+        node->constant = constant->getValue();
+        return node;
+    }
+
+    if (auto add = dynamic_cast<const ExpressionAdd*>(&expr)) {
+        return compileArithmetic(Node::Op::kAdd, *add);
+    }
+    if (auto subtract = dynamic_cast<const ExpressionSubtract*>(&expr)) {
+        return compileArithmetic(Node::Op::kSubtract, *subtract);
+    }
+    if (auto multiply = dynamic_cast<const ExpressionMultiply*>(&expr)) {
+        return compileArithmetic(Node::Op::kMultiply, *multiply);
+    }
+    if (auto divide = dynamic_cast<const ExpressionDivide*>(&expr)) {
+        return compileArithmetic(Node::Op::kDivide, *divide);
+    }
+
+    if (auto cond = dynamic_cast<const ExpressionCond*>(&expr)) {
+        const auto& operands = cond->getOperandList();
+        auto node = stdx::make_unique<Node>(Node::Op::kCond);
+        node->children.push_back(compilePredicate(*operands[0]));
+        node->children.push_back(compileDouble(*operands[1]));
+        node->children.push_back(compileDouble(*operands[2]));
+        for (auto&& child : node->children) {
+            if (!child) {
+                return nullptr;
+            }
+        }
+        return node;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Evaluates compiled nodes over a batch. A lane of a column is only meaningful where the matching
+ * entry of the 'valid' mask passed along is set; every evaluation clears the entries of the lanes
+ * it can't compute.
+ */
+class BatchEvaluator {
+public:
+    explicit BatchEvaluator(const std::vector<Document>& batch) : _batch(batch) {}
+
+    Column evaluate(const Node& node, std::vector<char>* valid) const {
+        switch (node.op) {
+            case Node::Op::kField:
+                return evaluateField(node, valid);
+            case Node::Op::kConstant:
+                return Column(_batch.size(), node.constant.coerceToDouble());
+            case Node::Op::kAdd:
+                return evaluateAdd(node, valid);
+            case Node::Op::kSubtract:
+                return evaluateSubtract(node, valid);
+            case Node::Op::kMultiply:
+                return evaluateMultiply(node, valid);
+            case Node::Op::kDivide:
+                return evaluateDivide(node, valid);
+            case Node::Op::kCond:
+                return evaluateCond(node, valid);
+            case Node::Op::kCompare:
+                break;
+        }
+        MONGO_UNREACHABLE;
+    }
+
+private:
+    Column evaluateField(const Node& node, std::vector<char>* valid) const {
+        const size_t n = _batch.size();
+        Column out(n);
+        for (size_t i = 0; i < n; ++i) {
+            Value val = _batch[i][node.path[0]];
+            for (size_t j = 1; j < node.path.size(); ++j) {
+                val = val.getType() == Object ? val.getDocument()[node.path[j]] : Value();
+            }
+
+            // Anything else, including an array along the path, takes the original code path.
+            if (val.getType() == NumberDouble) {
+                out[i] = val.getDouble();
+            } else {
+                (*valid)[i] = false;
+            }
+        }
+        return out;
+    }
+
+    Column evaluateAdd(const Node& node, std::vector<char>* valid) const {
+        // Sum the same way as ExpressionAdd, so that the results are identical.
+        const size_t n = _batch.size();
+        std::vector<DoubleDoubleSummation> sums(n);
+        for (auto&& child : node.children) {
+            if (child->isConstant(NumberLong)) {
+                const long long addend = child->constant.getLong();
+                for (size_t i = 0; i < n; ++i) {
+                    sums[i].addLong(addend);
+                }
+                continue;
+            }
+
+            const Column addend = evaluate(*child, valid);
+            for (size_t i = 0; i < n; ++i) {
+                sums[i].addDouble(addend[i]);
+            }
+        }
+
+        Column out(n);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = sums[i].getDouble();
+        }
+        return out;
+    }
+
+    Column evaluateSubtract(const Node& node, std::vector<char>* valid) const {
+        Column out = evaluate(*node.children[0], valid);
+        const Column rhs = evaluate(*node.children[1], valid);
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] -= rhs[i];
+        }
+        return out;
+    }
+
+    Column evaluateMultiply(const Node& node, std::vector<char>* valid) const {
+        Column out(_batch.size(), 1.0);
+        for (auto&& child : node.children) {
+            const Column factor = evaluate(*child, valid);
+            for (size_t i = 0; i < out.size(); ++i) {
+                out[i] *= factor[i];
+            }
+        }
+        return out;
+    }
+
+    Column evaluateDivide(const Node& node, std::vector<char>* valid) const {
+        Column out = evaluate(*node.children[0], valid);
+        const Column rhs = evaluate(*node.children[1], valid);
+        for (size_t i = 0; i < out.size(); ++i) {
+            // Dividing by zero is an error, which the original expression reports.
+            (*valid)[i] = (*valid)[i] && rhs[i] != 0.0;
+            out[i] /= rhs[i];
+        }
+        return out;
+    }
+
+    Column evaluateCond(const Node& node, std::vector<char>* valid) const {
+        const size_t n = _batch.size();
+        const std::vector<char> condition = evaluatePredicate(*node.children[0], valid);
+
+        // A branch which is not taken is not evaluated by the original expression either, so it
+        // only invalidates the lanes that take it.
+        std::vector<char> thenValid(n, true);
+        std::vector<char> elseValid(n, true);
+        const Column thenColumn = evaluate(*node.children[1], &thenValid);
+        const Column elseColumn = evaluate(*node.children[2], &elseValid);
+
+        Column out(n);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = condition[i] ? thenColumn[i] : elseColumn[i];
+            (*valid)[i] = (*valid)[i] && (condition[i] ? thenValid[i] : elseValid[i]);
+        }
+        return out;
+    }
+
+    std::vector<char> evaluatePredicate(const Node& node, std::vector<char>* valid) const {
+        invariant(node.op == Node::Op::kCompare);
+
+        // The truth value of each comparison for a result of -1, 0 and 1 from compareDoubles(),
+        // which orders NaN like Value comparisons do.
+        static const bool kTruthValues[][3] = {
+            /* EQ  */ {false, true, false},
+            /* NE  */ {true, false, true},
+            /* GT  */ {false, false, true},
+            /* GTE */ {false, true, true},
+            /* LT  */ {true, false, false},
+            /* LTE */ {true, true, false},
+        };
+        const bool* truthValue = kTruthValues[node.cmpOp];
+
+        const Column lhs = evaluate(*node.children[0], valid);
+        const Column rhs = evaluate(*node.children[1], valid);
+        std::vector<char> out(lhs.size());
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = truthValue[compareDoubles(lhs[i], rhs[i]) + 1];
+        }
+        return out;
+    }
+
+    const std::vector<Document>& _batch;
+};
+
+}  // namespace
+
+VectorizedExpression::VectorizedExpression(std::unique_ptr<Node> root) : _root(std::move(root)) {}
+
+VectorizedExpression::~VectorizedExpression() = default;
+
+std::unique_ptr<VectorizedExpression> VectorizedExpression::compile(const Expression& expr) {
+    auto root = compileDouble(expr);
+
+    // A bare field path or constant has nothing to compute.
+    if (!root || root->op == Node::Op::kField || root->op == Node::Op::kConstant) {
+        return nullptr;
+    }
+    return std::unique_ptr<VectorizedExpression>(new VectorizedExpression(std::move(root)));
+}
+
+void VectorizedExpression::evaluate(const std::vector<Document>& batch,
+                                    std::vector<Value>* results) const {
+    std::vector<char> valid(batch.size(), true);
+    const Column column = BatchEvaluator(batch).evaluate(*_root, &valid);
+
+    results->assign(batch.size(), Value());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (valid[i]) {
+            (*results)[i] = Value(column[i]);
+        }
+    }
+}
+
+}  // namespace mongo
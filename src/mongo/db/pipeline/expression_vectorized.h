@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * A compiled form of an arithmetic expression which evaluates over a batch of documents at a time.
+ * Instead of walking the expression tree once per document and boxing every intermediate result
+ * in a Value, each node of the tree is computed for the whole batch by a tight loop over a column
+ * of doubles, and only the final results are boxed.
+ *
+ * Only expressions whose every node produces a double can be compiled. These are built out of
+ * $add, $subtract, $multiply and $divide with at least one double operand, $cond over a numeric
+ * $eq/$ne/$gt/$gte/$lt/$lte comparison with double branches, field paths rooted at the current
+ * document, and numeric constants.
+ *
+ * A document is computed this way only if each field path resolves to a double in it and no
+ * $divide by zero happens. Any other document is left for the original expression to evaluate, so
+ * results and errors are always exactly the same as those of Expression::evaluate().
+ */
+class VectorizedExpression {
+    MONGO_DISALLOW_COPYING(VectorizedExpression);
+
+public:
+    struct Node;
+
+    ~VectorizedExpression();
+
+    /**
+     * Returns the compiled form of 'expr', or nullptr if it can't be vectorized.
+     */
+    static std::unique_ptr<VectorizedExpression> compile(const Expression& expr);
+
+    /**
+     * Evaluates the expression for each document in 'batch'. On return, (*results)[i] holds the
+     * result for batch[i], or the missing value if batch[i] must be evaluated by the original
+     * expression instead. Never throws on account of the contents of the documents.
+     */
+    void evaluate(const std::vector<Document>& batch, std::vector<Value>* results) const;
+
+private:
+    explicit VectorizedExpression(std::unique_ptr<Node> root);
+
+    std::unique_ptr<Node> _root;
+};
+
+}  // namespace mongo
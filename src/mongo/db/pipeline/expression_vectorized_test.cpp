@@ -0,0 +1,234 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cmath>
+#include <limits>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/expression_vectorized.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+class VectorizedExpressionTest : public unittest::Test {
+protected:
+    intrusive_ptr<Expression> parse(const std::string& json) {
+        return Expression::parseOperand(
+            _expCtx, fromjson("{expr: " + json + "}").firstElement(), _expCtx->variablesParseState);
+    }
+
+    std::unique_ptr<VectorizedExpression> compile(const std::string& json) {
+        return VectorizedExpression::compile(*parse(json));
+    }
+
+    /**
+     * Returns documents with fields 'x', 'y' and 'b.c' set to every combination of interesting
+     * doubles, and of values which the vectorized form can't handle.
+     */
+    static std::vector<Document> makeBatch() {
+        const double inf = std::numeric_limits<double>::infinity();
+        std::vector<Value> values = {Value(0.0),
+                                     Value(-0.0),
+                                     Value(1.5),
+                                     Value(-2.25),
+                                     Value(3.0),
+                                     Value(0.1),
+                                     Value(1e308),
+                                     Value(1e-300),
+                                     Value(inf),
+                                     Value(-inf),
+                                     Value(std::numeric_limits<double>::quiet_NaN()),
+                                     Value(2),
+                                     Value(4LL),
+                                     Value("str"_sd),
+                                     Value(BSONNULL),
+                                     Value(std::vector<Value>{Value(1.0)}),
+                                     Value()};
+
+        std::vector<Document> batch;
+        for (auto&& x : values) {
+            for (auto&& y : values) {
+                for (auto&& c : {Value(2.5), Value(-0.0), Value()}) {
+                    MutableDocument doc;
+                    doc.addField("x", x);
+                    doc.addField("y", y);
+                    doc.addField("b", Value(Document{{"c", c}}));
+                    batch.push_back(doc.freeze());
+                }
+            }
+        }
+        return batch;
+    }
+
+    /**
+     * Asserts that the vectorized form of 'json' computes exactly the same result as the original
+     * expression for every document it computes, and that it computes at least the documents
+     * where all fields are doubles and no division by zero happens.
+     */
+    void assertMatchesExpression(const std::string& json) {
+        auto expr = parse(json);
+        auto vectorized = VectorizedExpression::compile(*expr);
+        ASSERT(vectorized);
+
+        auto batch = makeBatch();
+        std::vector<Value> results;
+        vectorized->evaluate(batch, &results);
+        ASSERT_EQ(results.size(), batch.size());
+
+        size_t computed = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (results[i].missing()) {
+                continue;
+            }
+            ++computed;
+
+            Value expected = expr->evaluate(batch[i]);
+            ASSERT_EQ(expected.getType(), NumberDouble) << batch[i].toString();
+            ASSERT_EQ(results[i].getType(), NumberDouble) << batch[i].toString();
+            if (std::isnan(expected.getDouble())) {
+                ASSERT(std::isnan(results[i].getDouble())) << batch[i].toString();
+            } else {
+                ASSERT_EQ(expected.getDouble(), results[i].getDouble()) << batch[i].toString();
+                ASSERT_EQ(std::signbit(expected.getDouble()), std::signbit(results[i].getDouble()))
+                    << batch[i].toString();
+            }
+        }
+        ASSERT_GT(computed, 0U);
+    }
+
+private:
+    intrusive_ptr<ExpressionContextForTest> _expCtx = new ExpressionContextForTest();
+};
+
+TEST_F(VectorizedExpressionTest, AddMatchesExpression) {
+    assertMatchesExpression("{$add: ['$x', '$y']}");
+    assertMatchesExpression("{$add: ['$x', '$y', '$b.c']}");
+    assertMatchesExpression("{$add: ['$x', 1, {$numberLong: '9007199254740993'}, 0.1]}");
+}
+
+TEST_F(VectorizedExpressionTest, SubtractMatchesExpression) {
+    assertMatchesExpression("{$subtract: ['$x', '$b.c']}");
+    assertMatchesExpression("{$subtract: [10, '$y']}");
+}
+
+TEST_F(VectorizedExpressionTest, MultiplyMatchesExpression) {
+    assertMatchesExpression("{$multiply: ['$x', '$y', 2]}");
+    assertMatchesExpression("{$multiply: [{$add: ['$x', 1]}, {$subtract: ['$y', 0.5]}]}");
+}
+
+TEST_F(VectorizedExpressionTest, DivideMatchesExpression) {
+    assertMatchesExpression("{$divide: ['$x', '$y']}");
+    assertMatchesExpression("{$divide: [1, {$subtract: ['$x', '$y']}]}");
+}
+
+TEST_F(VectorizedExpressionTest, CondMatchesExpression) {
+    assertMatchesExpression("{$cond: [{$gt: ['$x', 0]}, {$divide: ['$y', '$x']}, 0.5]}");
+    assertMatchesExpression("{$cond: [{$lte: ['$x', '$y']}, '$x', '$y']}");
+    assertMatchesExpression("{$cond: [{$eq: ['$x', '$y']}, 1.0, {$multiply: ['$x', '$y']}]}");
+    assertMatchesExpression("{$cond: [{$ne: [{$numberLong: '3'}, '$x']}, '$b.c', '$y']}");
+}
+
+TEST_F(VectorizedExpressionTest, LeavesNonDoubleInputsToExpression) {
+    auto vectorized = compile("{$add: ['$x', 1]}");
+    ASSERT(vectorized);
+
+    std::vector<Document> batch = {Document{{"x", 1.5}},
+                                   Document{{"x", 1}},
+                                   Document{{"x", "str"_sd}},
+                                   Document{{"y", 1.5}},
+                                   Document{{"x", std::vector<Value>{Value(1.5)}}}};
+    std::vector<Value> results;
+    vectorized->evaluate(batch, &results);
+    ASSERT_EQ(results.size(), 5U);
+    ASSERT_EQ(results[0].getType(), NumberDouble);
+    ASSERT_EQ(results[0].getDouble(), 2.5);
+    for (size_t i = 1; i < results.size(); ++i) {
+        ASSERT(results[i].missing());
+    }
+}
+
+TEST_F(VectorizedExpressionTest, LeavesDivisionByZeroToExpression) {
+    auto vectorized = compile("{$divide: ['$x', '$y']}");
+    ASSERT(vectorized);
+
+    std::vector<Document> batch = {Document{{"x", 1.0}, {"y", 0.0}},
+                                   Document{{"x", 1.0}, {"y", -0.0}},
+                                   Document{{"x", 1.0}, {"y", 4.0}}};
+    std::vector<Value> results;
+    vectorized->evaluate(batch, &results);
+    ASSERT(results[0].missing());
+    ASSERT(results[1].missing());
+    ASSERT_EQ(results[2].getDouble(), 0.25);
+}
+
+TEST_F(VectorizedExpressionTest, BranchNotTakenDoesNotPreventVectorizing) {
+    auto vectorized = compile("{$cond: [{$gt: ['$d', 0]}, {$divide: ['$n', '$d']}, 0.0]}");
+    ASSERT(vectorized);
+
+    std::vector<Document> batch = {Document{{"n", 1.0}, {"d", 0.0}},
+                                   Document{{"d", -1.0}},
+                                   Document{{"n", 1.0}, {"d", 2.0}}};
+    std::vector<Value> results;
+    vectorized->evaluate(batch, &results);
+    ASSERT_EQ(results[0].getDouble(), 0.0);
+    ASSERT_EQ(results[1].getDouble(), 0.0);
+    ASSERT_EQ(results[2].getDouble(), 0.5);
+}
+
+TEST_F(VectorizedExpressionTest, DoesNotCompileUnsupportedExpressions) {
+    // Nothing to compute.
+    ASSERT(!compile("'$x'"));
+    ASSERT(!compile("{$literal: 1.5}"));
+
+    // The result would not be a double.
+    ASSERT(!compile("{$add: [1, 2]}"));
+    ASSERT(!compile("{$add: ['$x', {$literal: 'str'}]}"));
+    ASSERT(!compile("{$cond: [{$gt: ['$x', 0]}, '$x', 0]}"));
+
+    // Unsupported operators and variables.
+    ASSERT(!compile("{$abs: '$x'}"));
+    ASSERT(!compile("{$add: ['$$ROOT', 1.5]}"));
+    ASSERT(!compile("{$let: {vars: {v: 1.5}, in: {$add: ['$$v', '$x']}}}"));
+    ASSERT(!compile("{$cond: [{$cmp: ['$x', 0]}, '$x', 1.5]}"));
+    ASSERT(!compile("{$cond: ['$flag', '$x', 1.5]}"));
+
+    // A long which a double can't represent exactly compares differently.
+    ASSERT(!compile("{$cond: [{$gt: ['$x', {$numberLong: '9007199254740993'}]}, '$x', 1.5]}"));
+}
+
+}  // namespace
+}  // namespace mongo
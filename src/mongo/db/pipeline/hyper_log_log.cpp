@@ -0,0 +1,239 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/hyper_log_log.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "mongo/base/data_view.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+constexpr int HyperLogLog::kPrecision;
+constexpr size_t HyperLogLog::kNumRegisters;
+constexpr size_t HyperLogLog::kMaxExactHashes;
+
+namespace {
+
+// The number of hash bits left to rank a hash by, after those which pick its register.
+const int kRankBits = 64 - HyperLogLog::kPrecision;
+
+/**
+ * The 64-bit finalizer of MurmurHash3, which spreads the entropy of its input over all the bits of
+ * its output.
+ */
+uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+void sortAndDeduplicate(std::vector<uint64_t>* hashes) {
+    std::sort(hashes->begin(), hashes->end());
+    hashes->erase(std::unique(hashes->begin(), hashes->end()), hashes->end());
+}
+
+// The sigma and tau functions of Ertl's improved estimator, which account for the registers that
+// are still zero and for those that are saturated, respectively.
+double sigma(double x) {
+    if (x == 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1.0;
+    double z = x;
+    double previous;
+    do {
+        x *= x;
+        previous = z;
+        z += x * y;
+        y += y;
+    } while (z != previous);
+    return z;
+}
+
+double tau(double x) {
+    if (x == 0.0 || x == 1.0) {
+        return 0.0;
+    }
+    double y = 1.0;
+    double z = 1.0 - x;
+    double previous;
+    do {
+        x = std::sqrt(x);
+        previous = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while (z != previous);
+    return z / 3.0;
+}
+
+}  // namespace
+
+void HyperLogLog::add(uint64_t hash) {
+    const uint64_t mixedHash = mixHash(hash);
+    if (!isExact()) {
+        addToRegisters(mixedHash);
+        return;
+    }
+
+    _hashes.push_back(mixedHash);
+    if (_hashes.size() >= 2 * kMaxExactHashes) {
+        compactHashes();
+    }
+}
+
+void HyperLogLog::addToRegisters(uint64_t mixedHash) {
+    const size_t index = mixedHash >> kRankBits;
+    const uint64_t rest = mixedHash << kPrecision;
+    const uint8_t rank = rest == 0 ? kRankBits + 1 : countLeadingZeros64(rest) + 1;
+    _registers[index] = std::max(_registers[index], rank);
+}
+
+void HyperLogLog::compactHashes() {
+    sortAndDeduplicate(&_hashes);
+    if (_hashes.size() <= kMaxExactHashes) {
+        return;
+    }
+
+    _registers.assign(kNumRegisters, 0);
+    for (auto hash : _hashes) {
+        addToRegisters(hash);
+    }
+    _hashes = std::vector<uint64_t>();
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.isExact()) {
+        for (auto hash : other._hashes) {
+            if (isExact()) {
+                _hashes.push_back(hash);
+                if (_hashes.size() >= 2 * kMaxExactHashes) {
+                    compactHashes();
+                }
+            } else {
+                addToRegisters(hash);
+            }
+        }
+        return;
+    }
+
+    if (isExact()) {
+        auto hashes = std::move(_hashes);
+        _hashes = std::vector<uint64_t>();
+        _registers = other._registers;
+        for (auto hash : hashes) {
+            addToRegisters(hash);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+        _registers[i] = std::max(_registers[i], other._registers[i]);
+    }
+}
+
+long long HyperLogLog::estimate() const {
+    if (isExact()) {
+        auto hashes = _hashes;
+        sortAndDeduplicate(&hashes);
+        return hashes.size();
+    }
+
+    std::array<size_t, kRankBits + 2> histogram{};
+    for (auto rank : _registers) {
+        ++histogram[rank];
+    }
+
+    const double m = kNumRegisters;
+    if (histogram[0] == kNumRegisters) {
+        return 0;
+    }
+    double z = m * tau(1.0 - histogram[kRankBits + 1] / m);
+    for (int rank = kRankBits; rank >= 1; --rank) {
+        z = 0.5 * (z + histogram[rank]);
+    }
+    z += m * sigma(histogram[0] / m);
+
+    const double alphaInfinity = 0.5 / std::log(2.0);
+    return std::llround(alphaInfinity * m * m / z);
+}
+
+std::vector<char> HyperLogLog::serialize() const {
+    if (!isExact()) {
+        return std::vector<char>(_registers.begin(), _registers.end());
+    }
+
+    auto hashes = _hashes;
+    sortAndDeduplicate(&hashes);
+    std::vector<char> data(hashes.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        DataView(data.data()).write<LittleEndian<uint64_t>>(hashes[i], i * sizeof(uint64_t));
+    }
+    return data;
+}
+
+HyperLogLog HyperLogLog::parse(StringData data, bool exact) {
+    HyperLogLog sketch;
+    if (exact) {
+        uassert(50855,
+                str::stream() << "invalid HyperLogLog hashes of " << data.size() << " bytes",
+                data.size() % sizeof(uint64_t) == 0 &&
+                    data.size() < 2 * kMaxExactHashes * sizeof(uint64_t));
+        for (size_t offset = 0; offset < data.size(); offset += sizeof(uint64_t)) {
+            sketch._hashes.push_back(
+                ConstDataView(data.rawData()).read<LittleEndian<uint64_t>>(offset));
+        }
+        return sketch;
+    }
+
+    uassert(50856,
+            str::stream() << "invalid HyperLogLog registers of " << data.size() << " bytes",
+            data.size() == kNumRegisters);
+    sketch._registers.assign(data.begin(), data.end());
+    for (auto rank : sketch._registers) {
+        uassert(50857, "invalid HyperLogLog register", rank <= kRankBits + 1);
+    }
+    return sketch;
+}
+
+size_t HyperLogLog::getApproximateSize() const {
+    return sizeof(*this) + _hashes.capacity() * sizeof(uint64_t) + _registers.capacity();
+}
+
+}  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A HyperLogLog sketch, which estimates the number of distinct hashes added to it in a bounded
+ * amount of memory. Sketches merge into the sketch of the union of their inputs, which lets each
+ * shard of a split $group build a partial sketch.
+ *
+ * Until it has seen more than kMaxExactHashes distinct hashes, the sketch stores them and counts
+ * exactly. It then switches to 2^kPrecision one-byte registers, for a standard error of about
+ * 0.8%, and estimates with the method of O. Ertl, "New cardinality estimation algorithms for
+ * HyperLogLog sketches", 2017, which needs no empirical bias correction.
+ */
+class HyperLogLog {
+public:
+    static constexpr int kPrecision = 14;
+    static constexpr size_t kNumRegisters = size_t(1) << kPrecision;
+    static constexpr size_t kMaxExactHashes = 1024;
+
+    /**
+     * Adds a hash to the sketch. The hash is mixed again before use, so it need not be uniformly
+     * distributed, but equal values must have equal hashes everywhere the sketch is built.
+     */
+    void add(uint64_t hash);
+
+    /**
+     * Adds all the hashes seen by 'other' to this sketch.
+     */
+    void merge(const HyperLogLog& other);
+
+    /**
+     * Returns the estimated number of distinct hashes added to the sketch.
+     */
+    long long estimate() const;
+
+    /**
+     * Returns true if the sketch still stores its hashes rather than registers.
+     */
+    bool isExact() const {
+        return _registers.empty();
+    }
+
+    /**
+     * The serialized state of the sketch: the little-endian hashes when it is exact, and the
+     * registers otherwise. An exact sketch only compacts once it holds 2 * kMaxExactHashes hashes,
+     * so it may serialize up to one less than that.
+     */
+    std::vector<char> serialize() const;
+
+    /**
+     * Builds a sketch from the output of serialize() of an exact or a register sketch. Throws if
+     * 'data' is not a valid serialization.
+     */
+    static HyperLogLog parse(StringData data, bool exact);
+
+    size_t getApproximateSize() const;
+
+private:
+    void addToRegisters(uint64_t mixedHash);
+
+    /**
+     * Sorts and deduplicates '_hashes', and switches to registers if there are too many.
+     */
+    void compactHashes();
+
+    // The mixed hashes, not necessarily sorted or distinct, while the sketch is exact.
+    std::vector<uint64_t> _hashes;
+
+    // The maximum rank of the hashes which map to each register, once the sketch is not exact.
+    std::vector<uint8_t> _registers;
+};
+
+}  // namespace mongo
@@ -101,6 +101,17 @@ public:
                            const NamespaceString& ns,
                            const std::vector<BSONObj>& objs) = 0;
 
+    /**
+     * Applies the update statements formed by 'queries' and 'updates', which must be of the same
+     * length, to 'ns' in a single ordered update command. Returns the command reply.
+     */
+    virtual BSONObj update(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                           const NamespaceString& ns,
+                           const std::vector<BSONObj>& queries,
+                           const std::vector<BSONObj>& updates,
+                           bool upsert,
+                           bool multi) = 0;
+
     virtual CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                                   const NamespaceString& ns) = 0;
 
@@ -90,6 +90,16 @@ Document ParsedAddFields::applyProjection(const Document& inputDoc) const {
     return output.freeze();
 }
 
+Document ParsedAddFields::applyBatchedTransformation(const Document& inputDoc,
+                                                     const BatchValues& values,
+                                                     size_t index) {
+    MutableDocument output(inputDoc);
+    _root->addComputedFields(&output, inputDoc, values, index);
+
+    output.copyMetaDataFrom(inputDoc);
+    return output.freeze();
+}
+
 bool ParsedAddFields::parseObjectAsExpression(StringData pathToObject,
                                               const BSONObj& objSpec,
                                               const VariablesParseState& variablesParseState) {
@@ -112,6 +112,18 @@ public:
      */
     Document applyProjection(const Document& inputDoc) const final;
 
+    bool canPrepareBatch() const final {
+        return _root->hasVectorizedComputedFields();
+    }
+
+    void prepareBatch(const std::vector<Document>& batch, BatchValues* values) const final {
+        _root->evaluateVectorized(batch, values);
+    }
+
+    Document applyBatchedTransformation(const Document& inputDoc,
+                                        const BatchValues& values,
+                                        size_t index) final;
+
 private:
     /**
      * Attempts to parse 'objSpec' as an expression like {$add: [...]}. Adds a computed field to
@@ -52,6 +52,19 @@ void InclusionNode::optimize() {
     for (auto&& childPair : _children) {
         childPair.second->optimize();
     }
+
+    // Expressions are evaluated against the root document at every level, but batching only pays
+    // off at the root, where each field is computed exactly once per document.
+    _vectorizedExpressions.clear();
+    _vectorizedColumns.clear();
+    if (_pathToNode.empty()) {
+        for (auto&& expressionPair : _expressions) {
+            if (auto vectorized = VectorizedExpression::compile(*expressionPair.second)) {
+                _vectorizedColumns[expressionPair.first] = _vectorizedExpressions.size();
+                _vectorizedExpressions.push_back(std::move(vectorized));
+            }
+        }
+    }
 }
 
 void InclusionNode::serialize(MutableDocument* output,
@@ -142,16 +155,51 @@ Value InclusionNode::applyInclusionsToValue(Value inputValue) const {
 }
 
 void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document& root) const {
+    addComputedFields(outputDoc, root, nullptr, 0);
+}
+
+void InclusionNode::addComputedFields(MutableDocument* outputDoc,
+                                      const Document& root,
+                                      const VectorizedValues& batchValues,
+                                      size_t indexInBatch) const {
+    addComputedFields(outputDoc, root, &batchValues, indexInBatch);
+}
+
+void InclusionNode::addComputedFields(MutableDocument* outputDoc,
+                                      const Document& root,
+                                      const VectorizedValues* batchValues,
+                                      size_t indexInBatch) const {
     for (auto&& field : _orderToProcessAdditionsAndChildren) {
         auto childIt = _children.find(field);
         if (childIt != _children.end()) {
             outputDoc->setField(field,
                                 childIt->second->addComputedFields(outputDoc->peek()[field], root));
-        } else {
-            auto expressionIt = _expressions.find(field);
-            invariant(expressionIt != _expressions.end());
-            outputDoc->setField(field, expressionIt->second->evaluate(root));
+            continue;
         }
+
+        if (batchValues) {
+            // A missing value means that the vectorized form couldn't compute this document.
+            auto columnIt = _vectorizedColumns.find(field);
+            if (columnIt != _vectorizedColumns.end()) {
+                const Value& value = (*batchValues)[columnIt->second][indexInBatch];
+                if (!value.missing()) {
+                    outputDoc->setField(field, value);
+                    continue;
+                }
+            }
+        }
+
+        auto expressionIt = _expressions.find(field);
+        invariant(expressionIt != _expressions.end());
+        outputDoc->setField(field, expressionIt->second->evaluate(root));
+    }
+}
+
+void InclusionNode::evaluateVectorized(const std::vector<Document>& roots,
+                                       VectorizedValues* batchValues) const {
+    batchValues->resize(_vectorizedExpressions.size());
+    for (size_t i = 0; i < _vectorizedExpressions.size(); ++i) {
+        _vectorizedExpressions[i]->evaluate(roots, &(*batchValues)[i]);
     }
 }
 
@@ -349,6 +397,17 @@ Document ParsedInclusionProjection::applyProjection(const Document& inputDoc) co
     return output.freeze();
 }
 
+Document ParsedInclusionProjection::applyBatchedTransformation(const Document& inputDoc,
+                                                               const BatchValues& values,
+                                                               size_t index) {
+    MutableDocument output;
+    _root->applyInclusions(inputDoc, &output);
+    _root->addComputedFields(&output, inputDoc, values, index);
+
+    output.copyMetaDataFrom(inputDoc);
+    return output.freeze();
+}
+
 bool ParsedInclusionProjection::parseObjectAsExpression(
     StringData pathToObject,
     const BSONObj& objSpec,
@@ -32,6 +32,7 @@
 
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/expression_vectorized.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_map.h"
@@ -52,10 +53,17 @@ namespace parsed_aggregation_projection {
  */
 class InclusionNode {
 public:
+    /**
+     * The values of the computed fields of this node for a batch of documents, with one column per
+     * field which has a vectorized form.
+     */
+    using VectorizedValues = std::vector<std::vector<Value>>;
+
     InclusionNode(std::string pathToNode = "");
 
     /**
-     * Optimize any computed expressions.
+     * Optimize any computed expressions. The computed fields of the root node which have a
+     * vectorized form are compiled to it here.
      */
     void optimize();
 
@@ -90,6 +98,29 @@ public:
      */
     void addComputedFields(MutableDocument* outputDoc, const Document& root) const;
 
+    /**
+     * Same as above, for the document at 'indexInBatch' of a batch for which 'batchValues' were
+     * computed by evaluateVectorized(). Fields with a vectorized value skip their expression.
+     */
+    void addComputedFields(MutableDocument* outputDoc,
+                           const Document& root,
+                           const VectorizedValues& batchValues,
+                           size_t indexInBatch) const;
+
+    /**
+     * Returns true if some computed fields of this node can be evaluated a batch at a time.
+     */
+    bool hasVectorizedComputedFields() const {
+        return !_vectorizedExpressions.empty();
+    }
+
+    /**
+     * Evaluates the computed fields of this node which have a vectorized form for all of 'roots' at
+     * once, filling 'batchValues'. Never throws on account of the contents of the documents.
+     */
+    void evaluateVectorized(const std::vector<Document>& roots,
+                            VectorizedValues* batchValues) const;
+
     /**
      * Creates the child if it doesn't already exist. 'field' is not allowed to be dotted.
      */
@@ -140,6 +171,10 @@ private:
     // each element of any arrays, and ensure non-documents are handled appropriately.
     Value applyInclusionsToValue(Value inputVal) const;
     Value addComputedFields(Value inputVal, const Document& root) const;
+    void addComputedFields(MutableDocument* outputDoc,
+                           const Document& root,
+                           const VectorizedValues* batchValues,
+                           size_t indexInBatch) const;
 
     /**
      * Returns nullptr if no such child exists.
@@ -171,6 +206,11 @@ private:
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
     stdx::unordered_set<std::string> _inclusions;
 
+    // The vectorized forms of the computed fields of the root node which have one, and the index
+    // of each such field in '_vectorizedExpressions' and in the VectorizedValues of a batch.
+    std::vector<std::unique_ptr<VectorizedExpression>> _vectorizedExpressions;
+    StringMap<size_t> _vectorizedColumns;
+
     // TODO use StringMap once SERVER-23700 is resolved.
     stdx::unordered_map<std::string, std::unique_ptr<InclusionNode>> _children;
 };
@@ -244,6 +284,18 @@ public:
      */
     Document applyProjection(const Document& inputDoc) const final;
 
+    bool canPrepareBatch() const final {
+        return _root->hasVectorizedComputedFields();
+    }
+
+    void prepareBatch(const std::vector<Document>& batch, BatchValues* values) const final {
+        _root->evaluateVectorized(batch, values);
+    }
+
+    Document applyBatchedTransformation(const Document& inputDoc,
+                                        const BatchValues& values,
+                                        size_t index) final;
+
     /*
      * Checks whether the inclusion projection represented by the InclusionNode
      * tree is a subset of the object passed in. Projections that have any
@@ -605,6 +605,34 @@ BSONObj PipelineD::MongoDInterface::insert(const boost::intrusive_ptr<Expression
     return _client.getLastErrorDetailed();
 }
 
+BSONObj PipelineD::MongoDInterface::update(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                           const NamespaceString& ns,
+                                           const std::vector<BSONObj>& queries,
+                                           const std::vector<BSONObj>& updates,
+                                           bool upsert,
+                                           bool multi) {
+    invariant(queries.size() == updates.size());
+
+    BSONObjBuilder cmd;
+    cmd.append("update", ns.coll());
+    cmd.append("ordered", true);
+    if (expCtx->bypassDocumentValidation)
+        cmd.append("bypassDocumentValidation", true);
+
+    {
+        BSONArrayBuilder statements(cmd.subarrayStart("updates"));
+        for (size_t i = 0; i < queries.size(); ++i) {
+            statements.append(BSON("q" << queries[i] << "u" << updates[i] << "upsert" << upsert
+                                       << "multi"
+                                       << multi));
+        }
+    }
+
+    BSONObj reply;
+    _client.runCommand(ns.db().toString(), cmd.obj(), reply);
+    return reply;
+}
+
 CollectionIndexUsageMap PipelineD::MongoDInterface::getIndexStats(OperationContext* opCtx,
                                                                   const NamespaceString& ns) {
     AutoGetCollectionForReadCommand autoColl(opCtx, ns);
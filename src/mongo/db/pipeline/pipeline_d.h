@@ -71,6 +71,12 @@ public:
         BSONObj insert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                        const NamespaceString& ns,
                        const std::vector<BSONObj>& objs) final;
+        BSONObj update(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       const NamespaceString& ns,
+                       const std::vector<BSONObj>& queries,
+                       const std::vector<BSONObj>& updates,
+                       bool upsert,
+                       bool multi) final;
         CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                               const NamespaceString& ns) final;
         void appendLatencyStats(OperationContext* opCtx,
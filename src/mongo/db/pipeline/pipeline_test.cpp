@@ -2157,6 +2157,117 @@ class LookUp : public needsPrimaryShardMergerBase {
 
 }  // namespace needsPrimaryShardMerger
 
+namespace pushTopKSortOnGroupKeyToShards {
+
+class DocumentGroupKey : public Base {
+    string inputPipeJson() {
+        return "[{$group: {_id: {a: '$a', b: '$b'}, c: {$sum: 1}}}"
+               ",{$sort: {_id: -1, c: 1}}"
+               ",{$limit: 5}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {a: '$a', b: '$b'}, c: {$sum: {$const: 1}}}}"
+               ",{$sort: {sortKey: {_id: -1}, limit: 5}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', c: {$sum: '$$ROOT.c'}, $doingMerge: true}}"
+               ",{$sort: {sortKey: {_id: -1, c: 1}, limit: 5}}"
+               "]";
+    }
+};
+
+class SkipIsIncludedInLimit : public Base {
+    string inputPipeJson() {
+        return "[{$group: {_id: {a: '$a'}}}"
+               ",{$sort: {_id: 1}}"
+               ",{$skip: 2}"
+               ",{$limit: 3}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {a: '$a'}}}"
+               ",{$sort: {sortKey: {_id: 1}, limit: 5}}"
+               "]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}"
+               ",{$sort: {sortKey: {_id: 1}, limit: 5}}"
+               ",{$skip: 2}"
+               "]";
+    }
+};
+
+class ExpressionGroupKeyIsNotPushed : public Base {
+    string inputPipeJson() {
+        return "[{$group: {_id: '$a'}}"
+               ",{$sort: {_id: 1}}"
+               ",{$limit: 5}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: '$a'}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}"
+               ",{$sort: {sortKey: {_id: 1}, limit: 5}}"
+               "]";
+    }
+};
+
+class SortOnGroupKeyFieldIsNotPushed : public Base {
+    string inputPipeJson() {
+        return "[{$group: {_id: {a: '$a', b: '$b'}}}"
+               ",{$sort: {'_id.a': 1}}"
+               ",{$limit: 5}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {a: '$a', b: '$b'}}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}"
+               ",{$sort: {sortKey: {'_id.a': 1}, limit: 5}}"
+               "]";
+    }
+};
+
+class SortOnAccumulatedFieldIsNotPushed : public Base {
+    string inputPipeJson() {
+        return "[{$group: {_id: {a: '$a'}, c: {$sum: 1}}}"
+               ",{$sort: {c: -1, _id: 1}}"
+               ",{$limit: 5}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {a: '$a'}, c: {$sum: {$const: 1}}}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', c: {$sum: '$$ROOT.c'}, $doingMerge: true}}"
+               ",{$sort: {sortKey: {c: -1, _id: 1}, limit: 5}}"
+               "]";
+    }
+};
+
+class SortWithoutLimitIsNotPushed : public Base {
+    string inputPipeJson() {
+        return "[{$group: {_id: {a: '$a'}}}"
+               ",{$sort: {_id: 1}}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$group: {_id: {a: '$a'}}}]";
+    }
+    string mergePipeJson() {
+        return "[{$group: {_id: '$$ROOT._id', $doingMerge: true}}"
+               ",{$sort: {sortKey: {_id: 1}}}"
+               "]";
+    }
+};
+
+}  // namespace pushTopKSortOnGroupKeyToShards
+
 namespace mustRunOnMongoS {
 
 // Like a DocumentSourceMock, but must run on mongoS and can be used anywhere in the pipeline.
@@ -2712,6 +2823,15 @@ public:
         add<Optimizations::Sharded::needsPrimaryShardMerger::Out>();
         add<Optimizations::Sharded::needsPrimaryShardMerger::Project>();
         add<Optimizations::Sharded::needsPrimaryShardMerger::LookUp>();
+        add<Optimizations::Sharded::pushTopKSortOnGroupKeyToShards::DocumentGroupKey>();
+        add<Optimizations::Sharded::pushTopKSortOnGroupKeyToShards::SkipIsIncludedInLimit>();
+        add<Optimizations::Sharded::pushTopKSortOnGroupKeyToShards::
+                ExpressionGroupKeyIsNotPushed>();
+        add<Optimizations::Sharded::pushTopKSortOnGroupKeyToShards::
+                SortOnGroupKeyFieldIsNotPushed>();
+        add<Optimizations::Sharded::pushTopKSortOnGroupKeyToShards::
+                SortOnAccumulatedFieldIsNotPushed>();
+        add<Optimizations::Sharded::pushTopKSortOnGroupKeyToShards::SortWithoutLimitIsNotPushed>();
     }
 };
 
@@ -63,6 +63,15 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    BSONObj update(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                   const NamespaceString& ns,
+                   const std::vector<BSONObj>& queries,
+                   const std::vector<BSONObj>& updates,
+                   bool upsert,
+                   bool multi) override {
+        MONGO_UNREACHABLE;
+    }
+
     CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                           const NamespaceString& ns) override {
         MONGO_UNREACHABLE;
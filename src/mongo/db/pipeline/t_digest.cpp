@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/t_digest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr double TDigest::kCompression;
+
+namespace {
+
+// Values are buffered until there are this many times the compression of them.
+const double kBufferFactor = 5.0;
+
+const double kPi = 3.14159265358979323846;
+
+// The k1 scale function, which maps a quantile to a scale on which every centroid may span at most
+// one unit, and its inverse.
+double scale(double q) {
+    return TDigest::kCompression / (2.0 * kPi) * std::asin(2.0 * q - 1.0);
+}
+
+double inverseScale(double k) {
+    const double angle = std::min(k * 2.0 * kPi / TDigest::kCompression, kPi / 2.0);
+    return (std::sin(angle) + 1.0) / 2.0;
+}
+
+}  // namespace
+
+void TDigest::add(double value) {
+    addCentroid({value, 1.0});
+}
+
+void TDigest::addCentroid(Centroid centroid) {
+    if (empty()) {
+        _min = centroid.mean;
+        _max = centroid.mean;
+    } else {
+        _min = std::min(_min, centroid.mean);
+        _max = std::max(_max, centroid.mean);
+    }
+    _totalWeight += centroid.weight;
+
+    _buffer.push_back(centroid);
+    if (_buffer.size() >= kBufferFactor * kCompression) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.empty()) {
+        return;
+    }
+
+    const bool wasEmpty = empty();
+    for (auto&& centroid : other._centroids) {
+        addCentroid(centroid);
+    }
+    for (auto&& centroid : other._buffer) {
+        addCentroid(centroid);
+    }
+
+    // The extremes of 'other' need not be centroids of their own.
+    _min = wasEmpty ? other._min : std::min(_min, other._min);
+    _max = wasEmpty ? other._max : std::max(_max, other._max);
+}
+
+void TDigest::compress() {
+    if (_buffer.empty()) {
+        return;
+    }
+
+    std::vector<Centroid> all;
+    all.reserve(_centroids.size() + _buffer.size());
+    all.insert(all.end(), _centroids.begin(), _centroids.end());
+    all.insert(all.end(), _buffer.begin(), _buffer.end());
+    std::sort(all.begin(), all.end(), [](const Centroid& lhs, const Centroid& rhs) {
+        return lhs.mean < rhs.mean;
+    });
+    _buffer.clear();
+
+    _centroids.clear();
+    Centroid current = all.front();
+    double weightBefore = 0.0;
+    double weightLimit = _totalWeight * inverseScale(scale(0.0) + 1.0);
+    for (size_t i = 1; i < all.size(); ++i) {
+        const Centroid& next = all[i];
+        const double mergedWeight = current.weight + next.weight;
+        if (weightBefore + mergedWeight <= weightLimit) {
+            current.mean += (next.mean - current.mean) * next.weight / mergedWeight;
+            current.weight = mergedWeight;
+            continue;
+        }
+
+        _centroids.push_back(current);
+        weightBefore += current.weight;
+        weightLimit = _totalWeight * inverseScale(scale(weightBefore / _totalWeight) + 1.0);
+        current = next;
+    }
+    _centroids.push_back(current);
+}
+
+const std::vector<TDigest::Centroid>& TDigest::centroids() {
+    compress();
+    return _centroids;
+}
+
+double TDigest::quantile(double q) {
+    invariant(!empty());
+    compress();
+
+    if (_centroids.size() == 1) {
+        return _centroids.front().mean;
+    }
+
+    // Interpolate linearly between the centers of adjacent centroids, and between the outermost
+    // centroids and the extremes.
+    const double target = q * _totalWeight;
+    const Centroid& first = _centroids.front();
+    if (target < first.weight / 2.0) {
+        return _min + (first.mean - _min) * target / (first.weight / 2.0);
+    }
+
+    double weightBefore = 0.0;
+    for (size_t i = 0; i + 1 < _centroids.size(); ++i) {
+        const Centroid& left = _centroids[i];
+        const Centroid& right = _centroids[i + 1];
+        const double leftCenter = weightBefore + left.weight / 2.0;
+        const double rightCenter = weightBefore + left.weight + right.weight / 2.0;
+        if (target < rightCenter) {
+            const double fraction = (target - leftCenter) / (rightCenter - leftCenter);
+            return left.mean + (right.mean - left.mean) * fraction;
+        }
+        weightBefore += left.weight;
+    }
+
+    const Centroid& last = _centroids.back();
+    const double lastCenter = _totalWeight - last.weight / 2.0;
+    const double fraction = std::min((target - lastCenter) / (last.weight / 2.0), 1.0);
+    return last.mean + (_max - last.mean) * fraction;
+}
+
+TDigest TDigest::parse(double min, double max, std::vector<Centroid> centroids) {
+    TDigest digest;
+    for (auto&& centroid : centroids) {
+        uassert(50858,
+                "invalid t-digest centroid",
+                centroid.weight > 0.0 && !std::isnan(centroid.mean) && centroid.mean >= min &&
+                    centroid.mean <= max);
+        digest.addCentroid(centroid);
+    }
+    if (!digest.empty()) {
+        digest._min = min;
+        digest._max = max;
+    }
+    return digest;
+}
+
+size_t TDigest::getApproximateSize() const {
+    return sizeof(*this) + (_centroids.capacity() + _buffer.capacity()) * sizeof(Centroid);
+}
+
+}  // namespace mongo
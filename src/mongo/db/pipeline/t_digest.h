@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace mongo {
+
+/**
+ * A merging t-digest, which summarizes a distribution of doubles by a bounded number of weighted
+ * centroids in order to estimate its quantiles. Centroids near the tails are kept small, so
+ * extreme quantiles are estimated more accurately than the median. Digests merge into the digest
+ * of the union of their inputs, which lets each shard of a split $group build a partial digest.
+ *
+ * See T. Dunning and O. Ertl, "Computing extremely accurate quantiles using t-digests", 2019.
+ */
+class TDigest {
+public:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    // Bounds the number of centroids to about this many, and their memory accordingly.
+    static constexpr double kCompression = 100.0;
+
+    /**
+     * Adds a value, which must not be NaN.
+     */
+    void add(double value);
+
+    /**
+     * Adds all the values summarized by 'other' to this digest.
+     */
+    void merge(const TDigest& other);
+
+    /**
+     * Returns the estimated 'q' quantile, with 'q' in [0, 1], of the values added. Must not be
+     * called on an empty digest.
+     */
+    double quantile(double q);
+
+    bool empty() const {
+        return _totalWeight == 0.0;
+    }
+
+    double min() const {
+        return _min;
+    }
+
+    double max() const {
+        return _max;
+    }
+
+    /**
+     * Returns the centroids, ordered by mean, after merging any buffered values into them.
+     */
+    const std::vector<Centroid>& centroids();
+
+    /**
+     * Builds a digest from the output of min(), max() and centroids() of another digest. Throws
+     * if they are not consistent.
+     */
+    static TDigest parse(double min, double max, std::vector<Centroid> centroids);
+
+    size_t getApproximateSize() const;
+
+private:
+    /**
+     * Merges the buffered centroids into '_centroids', so that no centroid covers more of the
+     * distribution than the scale function allows.
+     */
+    void compress();
+
+    void addCentroid(Centroid centroid);
+
+    // Sorted by mean, and compressed.
+    std::vector<Centroid> _centroids;
+
+    // Values and centroids added since the last compression.
+    std::vector<Centroid> _buffer;
+
+    double _totalWeight = 0.0;
+    double _min = 0.0;
+    double _max = 0.0;
+};
+
+}  // namespace mongo
@@ -33,12 +33,26 @@
 #include "mongo/db/query/cursor_response.h"
 
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/util/itoa.h"
 
 namespace mongo {
 
 namespace {
 
+// Owned documents at least this large are sent from their own buffers instead of being copied into
+// the reply to find and getMore. Zero disables splicing.
+MONGO_EXPORT_SERVER_PARAMETER(cursorReplySpliceThresholdBytes, int, 4 * 1024)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "cursorReplySpliceThresholdBytes must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
 const char kCursorField[] = "cursor";
 const char kIdField[] = "id";
 const char kNsField[] = "ns";
@@ -49,11 +63,38 @@ const char kInternalLatestOplogTimestampField[] = "$_internalLatestOplogTimestam
 }  // namespace
 
 CursorResponseBuilder::CursorResponseBuilder(bool isInitialResponse,
-                                             BSONObjBuilder* commandResponse)
+                                             BSONObjBuilder* commandResponse,
+                                             OpMsgBuilder* reply)
     : _responseInitialLen(commandResponse->bb().len()),
       _commandResponse(commandResponse),
       _cursorObject(commandResponse->subobjStart(kCursorField)),
-      _batch(_cursorObject.subarrayStart(isInitialResponse ? kBatchFieldInitial : kBatchField)) {}
+      _batch(_cursorObject.subarrayStart(isInitialResponse ? kBatchFieldInitial : kBatchField)) {
+    const int threshold = cursorReplySpliceThresholdBytes.load();
+    if (reply && threshold > 0 && reply->isBodyBuilder(*commandResponse)) {
+        _reply = reply;
+        _spliceThreshold = threshold;
+        _splicedArray = reply->beginSplicedArray(
+            {static_cast<int>(_batch.offset()), static_cast<int>(_cursorObject.offset())});
+    }
+}
+
+void CursorResponseBuilder::_appendSpliceable(const BSONObj& obj) {
+    ItoA fieldName(static_cast<uint64_t>(_numDocs));
+
+    if (obj.isOwned() && obj.objsize() >= _spliceThreshold) {
+        _reply->spliceArrayElement(
+            _splicedArray, _batch.bb().len(), static_cast<uint32_t>(_numDocs), obj);
+        _splicedBytes += 1 + StringData(fieldName).size() + 1 + obj.objsize();
+        return;
+    }
+
+    // Appended by hand because BSONArrayBuilder numbers elements by counting its own appends, which
+    // doesn't include the spliced ones.
+    auto& bb = _batch.bb();
+    bb.appendNum(static_cast<char>(Object));
+    bb.appendStr(fieldName);
+    bb.appendBuf(obj.objdata(), obj.objsize());
+}
 
 void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace) {
     invariant(_active);
@@ -61,6 +102,9 @@ void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace)
     _cursorObject.append(kIdField, cursorId);
     _cursorObject.append(kNsField, cursorNamespace);
     _cursorObject.doneFast();
+    if (_reply) {
+        _reply->endSplicedArray(_splicedArray);
+    }
     if (!_latestOplogTimestamp.isNull()) {
         _commandResponse->append(kInternalLatestOplogTimestampField, _latestOplogTimestamp);
     }
@@ -69,6 +113,9 @@ void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace)
 
 void CursorResponseBuilder::abandon() {
     invariant(_active);
+    if (_reply) {
+        _reply->abandonSplicedArray(_splicedArray);
+    }
     _batch.doneFast();
     _cursorObject.doneFast();
     _commandResponse->bb().setlen(_responseInitialLen);  // Removes everything we've added.
@@ -209,11 +256,15 @@ void CursorResponse::addToBSON(CursorResponse::ResponseType responseType,
 
     const char* batchFieldName =
         (responseType == ResponseType::InitialResponse) ? kBatchFieldInitial : kBatchField;
-    BSONArrayBuilder batchBuilder(cursorBuilder.subarrayStart(batchFieldName));
-    for (const BSONObj& obj : _batch) {
-        batchBuilder.append(obj);
+    if (!_rawBatch.isEmpty()) {
+        cursorBuilder.appendArray(batchFieldName, _rawBatch);
+    } else {
+        BSONArrayBuilder batchBuilder(cursorBuilder.subarrayStart(batchFieldName));
+        for (const BSONObj& obj : _batch) {
+            batchBuilder.append(obj);
+        }
+        batchBuilder.doneFast();
     }
-    batchBuilder.doneFast();
 
     cursorBuilder.doneFast();
 
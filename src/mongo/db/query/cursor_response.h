@@ -38,6 +38,8 @@
 
 namespace mongo {
 
+class OpMsgBuilder;
+
 /**
  * Builds the cursor field and the _latestOplogTimestamp field for a reply to a cursor-generating
  * command in place.
@@ -53,8 +55,14 @@ public:
      *
      * If the builder goes out of scope without a call to done(), any data appended to the
      * builder will be removed.
+     *
+     * If 'reply' is given and 'commandResponse' is building the top level of its body, owned
+     * documents of at least cursorReplySpliceThresholdBytes are spliced into the reply rather than
+     * copied into it. See OpMsgBuilder::beginSplicedArray().
      */
-    CursorResponseBuilder(bool isInitialResponse, BSONObjBuilder* commandResponse);
+    CursorResponseBuilder(bool isInitialResponse,
+                          BSONObjBuilder* commandResponse,
+                          OpMsgBuilder* reply = nullptr);
 
     ~CursorResponseBuilder() {
         if (_active)
@@ -63,12 +71,16 @@ public:
 
     size_t bytesUsed() const {
         invariant(_active);
-        return _batch.len();
+        return _batch.len() + _splicedBytes;
     }
 
     void append(const BSONObj& obj) {
         invariant(_active);
-        _batch.append(obj);
+        if (_reply) {
+            _appendSpliceable(obj);
+        } else {
+            _batch.append(obj);
+        }
         _numDocs++;
     }
 
@@ -94,12 +106,21 @@ public:
     void abandon();
 
 private:
+    void _appendSpliceable(const BSONObj& obj);
+
     const int _responseInitialLen;  // Must be the first member so its initializer runs first.
     bool _active = true;
     BSONObjBuilder* const _commandResponse;
     BSONObjBuilder _cursorObject;
     BSONArrayBuilder _batch;
     long long _numDocs = 0;
+
+    // Only set if documents may be spliced into the reply.
+    OpMsgBuilder* _reply = nullptr;
+    size_t _splicedArray = 0;
+    int _spliceThreshold = 0;
+    size_t _splicedBytes = 0;
+
     Timestamp _latestOplogTimestamp;
 };
 
@@ -205,6 +226,16 @@ public:
         return std::move(_batch);
     }
 
+    /**
+     * Replaces the batch with 'rawBatch', an array of documents exactly as it was received from
+     * another node. The array is copied into the serialized response in a single append rather
+     * than one document at a time. After this call, getBatch() returns an empty batch.
+     */
+    void setRawBatch(BSONObj rawBatch) {
+        _batch.clear();
+        _rawBatch = std::move(rawBatch);
+    }
+
     boost::optional<long long> getNumReturnedSoFar() const {
         return _numReturnedSoFar;
     }
@@ -230,6 +261,7 @@ private:
     NamespaceString _nss;
     CursorId _cursorId;
     std::vector<BSONObj> _batch;
+    BSONObj _rawBatch;
     boost::optional<long long> _numReturnedSoFar;
     boost::optional<Timestamp> _latestOplogTimestamp;
     boost::optional<BSONObj> _writeConcernError;
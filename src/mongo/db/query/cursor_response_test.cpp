@@ -30,6 +30,7 @@
 
 #include "mongo/db/query/cursor_response.h"
 
+#include "mongo/rpc/op_msg.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -306,6 +307,25 @@ TEST(CursorResponseTest, addToBSONSubsequentResponse) {
     ASSERT_BSONOBJ_EQ(responseObj, expectedResponse);
 }
 
+TEST(CursorResponseTest, addToBSONRawBatch) {
+    CursorResponse response(NamespaceString("testdb.testcoll"), CursorId(123), {});
+    response.setRawBatch(BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2)));
+    ASSERT(response.getBatch().empty());
+
+    BSONObjBuilder builder;
+    response.addToBSON(CursorResponse::ResponseType::SubsequentResponse, &builder);
+    BSONObj responseObj = builder.obj();
+
+    BSONObj expectedResponse =
+        BSON("cursor" << BSON("id" << CursorId(123) << "ns"
+                                   << "testdb.testcoll"
+                                   << "nextBatch"
+                                   << BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2)))
+                      << "ok"
+                      << 1.0);
+    ASSERT_BSONOBJ_EQ(responseObj, expectedResponse);
+}
+
 TEST(CursorResponseTest, serializeLatestOplogEntry) {
     std::vector<BSONObj> batch = {BSON("_id" << 1), BSON("_id" << 2)};
     CursorResponse response(
@@ -330,6 +350,78 @@ TEST(CursorResponseTest, serializeLatestOplogEntry) {
     ASSERT_EQ(*reparsedResponse.getLastOplogTimestamp(), Timestamp(1, 2));
 }
 
+TEST(CursorResponseBuilderTest, splicedDocumentsRoundTripThroughOpMsg) {
+    const std::string bigString(8 * 1024, 'x');
+    const std::vector<BSONObj> docs = {BSON("_id" << 0),
+                                       BSON("_id" << 1 << "big" << bigString),
+                                       BSON("_id" << 2),
+                                       BSON("_id" << 3 << "big" << bigString)};
+
+    OpMsgBuilder builder;
+    {
+        auto body = builder.beginBody();
+        CursorResponseBuilder crb(true, &body, &builder);
+        for (auto&& doc : docs) {
+            crb.append(doc);
+        }
+        ASSERT_GT(crb.bytesUsed(), 2 * bigString.size());
+        crb.done(CursorId(123), "db.coll");
+        body.append("ok", 1.0);
+    }
+    auto message = builder.finish();
+    ASSERT(message.hasSplices());
+
+    size_t gatheredBytes = 0;
+    for (auto&& buffer : message.gatherBuffers()) {
+        gatheredBytes += buffer.length();
+    }
+    ASSERT_EQ(gatheredBytes, static_cast<size_t>(message.size()));
+
+    auto response = CursorResponse::parseFromBSON(OpMsg::parse(message).body);
+    ASSERT_OK(response.getStatus());
+    ASSERT_EQ(response.getValue().getCursorId(), CursorId(123));
+    ASSERT_EQ(response.getValue().getNSS().ns(), "db.coll");
+    ASSERT_EQ(response.getValue().getBatch().size(), docs.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(response.getValue().getBatch()[i], docs[i]);
+    }
+}
+
+TEST(CursorResponseBuilderTest, unownedDocumentsAreNotSpliced) {
+    const BSONObj doc = BSON("_id" << 1 << "big" << std::string(8 * 1024, 'x'));
+
+    OpMsgBuilder builder;
+    {
+        auto body = builder.beginBody();
+        CursorResponseBuilder crb(true, &body, &builder);
+        crb.append(BSONObj(doc.objdata()));
+        crb.done(CursorId(0), "db.coll");
+        body.append("ok", 1.0);
+    }
+    auto message = builder.finish();
+    ASSERT_FALSE(message.hasSplices());
+
+    auto response = CursorResponse::parseFromBSON(OpMsg::parse(message).body);
+    ASSERT_OK(response.getStatus());
+    ASSERT_EQ(response.getValue().getBatch().size(), 1U);
+    ASSERT_BSONOBJ_EQ(response.getValue().getBatch()[0], doc);
+}
+
+TEST(CursorResponseBuilderTest, abandonedBatchDropsSplicedDocuments) {
+    OpMsgBuilder builder;
+    {
+        auto body = builder.beginBody();
+        {
+            CursorResponseBuilder crb(true, &body, &builder);
+            crb.append(BSON("_id" << 1 << "big" << std::string(8 * 1024, 'x')));
+        }
+        body.append("ok", 1.0);
+    }
+    auto message = builder.finish();
+    ASSERT_FALSE(message.hasSplices());
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(message).body, BSON("ok" << 1.0));
+}
+
 }  // namespace
 
 }  // namespace mongo
@@ -120,7 +120,23 @@ extern AtomicInt32 internalInsertMaxBatchSize;
 
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// If true, $cursor decodes the fields of whole documents lazily, as the pipeline looks them up.
+extern AtomicBool internalDocumentSourceCursorLazyDocuments;
+
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The number of documents $project and $addFields read ahead from $cursor in order to evaluate
+// arithmetic expressions a batch at a time. Values of 1 or less disable batching.
+extern AtomicInt32 internalDocumentSourceTransformationBatchSize;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
+
+// When a remote cursor merged on mongos has fewer than this many results buffered, the
+// AsyncResultsMerger issues the next getMore to that remote without waiting for the buffer to run
+// dry. Values of 0 or less disable read-ahead.
+extern AtomicInt32 internalQueryARMReadAheadLowWaterMark;
+
+// Read-ahead getMores are only issued while a mongos cursor holds fewer than this many bytes of
+// buffered results across all of its remotes.
+extern AtomicInt32 internalQueryARMReadAheadMaxBufferedBytes;
 }  // namespace mongo
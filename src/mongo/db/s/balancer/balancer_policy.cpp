@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -54,6 +55,19 @@ const size_t kAggressiveImbalanceThreshold = 1;
 
 }  // namespace
 
+// If non-zero, a shard whose operations per second exceed this multiple of the mean of all shards
+// moves its most written chunk to the least busy shard. The shards report their most written
+// chunks in serverStatus' shardingStatistics.hotChunks whatever hotChunkSplitWritesPerSec is set
+// to, and a chunk split for being hot keeps its rate, shared between its halves.
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadImbalanceRatio, double, 0)
+    ->withValidator([](const double& potentialNewValue) {
+        if (potentialNewValue != 0 && potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "balancerLoadImbalanceRatio must be either 0 or at least 1");
+        }
+        return Status::OK();
+    });
+
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
     : _nss(std::move(nss)),
       _shardChunks(std::move(shardToChunksMap)),
@@ -434,6 +448,17 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             ;
     }
 
+    // 4) Move a chunk off the busiest shard, if it serves disproportionately many operations
+    const double loadImbalanceRatio = balancerLoadImbalanceRatio.load();
+    if (loadImbalanceRatio > 0) {
+        _loadBalance(shardStats,
+                     distribution,
+                     loadImbalanceRatio,
+                     imbalanceThreshold,
+                     &migrations,
+                     usedShards);
+    }
+
     return migrations;
 }
 
@@ -524,6 +549,87 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_loadBalance(const ShardStatisticsVector& shardStats,
+                                  const DistributionStatus& distribution,
+                                  double loadImbalanceRatio,
+                                  size_t imbalanceThreshold,
+                                  vector<MigrateInfo>* migrations,
+                                  set<ShardId>* usedShards) {
+    const ClusterStatistics::ShardStatistics* busiest = nullptr;
+    const ClusterStatistics::ShardStatistics* idlest = nullptr;
+    double totalOpsPerSec = 0;
+    size_t numShards = 0;
+
+    for (const auto& stat : shardStats) {
+        if (stat.isDraining)
+            continue;
+
+        totalOpsPerSec += stat.opsPerSec;
+        numShards++;
+
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (!busiest || stat.opsPerSec > busiest->opsPerSec)
+            busiest = &stat;
+        if (!idlest || stat.opsPerSec < idlest->opsPerSec)
+            idlest = &stat;
+    }
+
+    if (!busiest || busiest == idlest || totalOpsPerSec <= 0)
+        return false;
+
+    const double meanOpsPerSec = totalOpsPerSec / numShards;
+    if (busiest->opsPerSec < loadImbalanceRatio * meanOpsPerSec)
+        return false;
+
+    // Do not give the receiver so many chunks that chunk count balancing would move them back
+    const size_t totalChunks = distribution.totalChunks();
+    const size_t idealNumberOfChunksPerShard =
+        (totalChunks / numShards) + (totalChunks % numShards ? 1 : 0);
+    const size_t receiverChunks = distribution.numberOfChunksInShard(idlest->shardId);
+    if (receiverChunks + 1 >= idealNumberOfChunksPerShard + imbalanceThreshold)
+        return false;
+
+    // Shard-wide operation counters do not say which chunks serve the load, so only move the
+    // chunk the donor reports as the most written, and only while balancing its collection.
+    if (busiest->hotChunks.empty())
+        return false;
+
+    const auto& hottest = busiest->hotChunks.front();
+    if (hottest.nss != distribution.nss())
+        return false;
+
+    // Moving a chunk hotter than the gap between the two shards would only swap their roles
+    if (idlest->opsPerSec + hottest.writesPerSec >= busiest->opsPerSec)
+        return false;
+
+    for (const auto& chunk : distribution.getChunks(busiest->shardId)) {
+        if (SimpleBSONObjComparator::kInstance.evaluate(chunk.getMin() != hottest.min))
+            continue;
+
+        if (chunk.getJumbo())
+            return false;
+
+        if (!isShardSuitableReceiver(*idlest, distribution.getTagForChunk(chunk)).isOK())
+            return false;
+
+        LOG(1) << "collection : " << distribution.nss().ns();
+        LOG(1) << "donor      : " << busiest->shardId << " ops/sec " << busiest->opsPerSec;
+        LOG(1) << "receiver   : " << idlest->shardId << " ops/sec " << idlest->opsPerSec;
+        LOG(1) << "mean       : " << meanOpsPerSec;
+        LOG(1) << "chunk      : " << redact(chunk.getMin()) << " writes/sec "
+               << hottest.writesPerSec;
+
+        migrations->emplace_back(idlest->shardId, chunk);
+        invariant(usedShards->insert(busiest->shardId).second);
+        invariant(usedShards->insert(idlest->shardId).second);
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -36,6 +36,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_id.h"
 
@@ -66,6 +67,10 @@ struct MigrateInfo {
     ChunkVersion version;
 };
 
+// If positive, the balancer moves the most written chunk off the shard serving the most operations
+// per second whenever that shard's rate is at least this many times the average across all shards.
+extern AtomicDouble balancerLoadImbalanceRatio;
+
 typedef std::vector<ClusterStatistics::ShardStatistics> ShardStatisticsVector;
 typedef std::map<ShardId, std::vector<ChunkType>> ShardToChunksMap;
 
@@ -184,6 +189,10 @@ public:
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
      *
+     * If balancerLoadImbalanceRatio is set and no other migration involves them, it additionally
+     * suggests moving the most written chunk from the shard serving the most operations to the one
+     * serving the least, provided that does not unbalance the chunk counts.
+     *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
      * shard.
@@ -239,6 +248,23 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Selects the chunk with the highest write rate on the shard serving the most operations per
+     * second to be moved to the shard serving the least, if the former's rate is at least
+     * 'loadImbalanceRatio' times the average and the move would not push the receiver's chunk
+     * count past the imbalance threshold. Only moves the chunk if it belongs to the collection in
+     * 'distribution' and if its writes would not make the receiver the busier of the two shards.
+     * Takes into account and updates the shards, which have already been used for migrations.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _loadBalance(const ShardStatisticsVector& shardStats,
+                             const DistributionStatus& distribution,
+                             double loadImbalanceRatio,
+                             size_t imbalanceThreshold,
+                             std::vector<MigrateInfo>* migrations,
+                             std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -609,6 +610,88 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, LoadBalancingMovesChunkOffBusiestShard) {
+    const double oldRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([oldRatio] { balancerLoadImbalanceRatio.store(oldRatio); });
+    balancerLoadImbalanceRatio.store(1.5);
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId2, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSec = 1000;
+    cluster.first[0].hotChunks = {{kNamespace, cluster.second[kShardId0][1].getMin(), 400},
+                                  {kNamespace, cluster.second[kShardId0][0].getMin(), 10}};
+    cluster.first[1].opsPerSec = 100;
+    cluster.first[2].opsPerSec = 50;
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, LoadBalancingDoesNotMoveChunksOfOtherCollections) {
+    const double oldRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([oldRatio] { balancerLoadImbalanceRatio.store(oldRatio); });
+    balancerLoadImbalanceRatio.store(1.5);
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSec = 1000;
+    cluster.first[0].hotChunks = {{NamespaceString("TestDB.OtherColl"), kMinBSONKey, 400}};
+
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingDoesNotMoveChunkHotterThanTheImbalance) {
+    const double oldRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([oldRatio] { balancerLoadImbalanceRatio.store(oldRatio); });
+    balancerLoadImbalanceRatio.store(1.5);
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSec = 1000;
+    cluster.first[0].hotChunks = {{kNamespace, cluster.second[kShardId0][0].getMin(), 900}};
+    cluster.first[1].opsPerSec = 200;
+
+    // The receiver would end up serving more operations than the donor does now
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingDisabledByDefault) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSec = 1000;
+
+    ASSERT(balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingDoesNotOverfillReceiver) {
+    const double oldRatio = balancerLoadImbalanceRatio.load();
+    ON_BLOCK_EXIT([oldRatio] { balancerLoadImbalanceRatio.store(oldRatio); });
+    balancerLoadImbalanceRatio.store(1.5);
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSec = 1000;
+    cluster.first[0].hotChunks = {{kNamespace, cluster.second[kShardId0][0].getMin(), 400}};
+
+    // An aggressive threshold of one chunk leaves no room on the receiver
+    ASSERT(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), true).empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -72,6 +72,7 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("opsPerSec", opsPerSec);
     return builder.obj();
 }
 
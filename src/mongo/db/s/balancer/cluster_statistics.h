@@ -34,6 +34,8 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/s/client/shard.h"
 
 namespace mongo {
@@ -92,6 +94,23 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // The rate of operations served by this shard's primary since the previous statistics
+        // snapshot, or zero if it is not known yet.
+        double opsPerSec{0};
+
+        /**
+         * The write rate of a single chunk, as tracked by the shard's primary.
+         */
+        struct ChunkWriteRate {
+            NamespaceString nss;
+            BSONObj min;
+            double writesPerSec;
+        };
+
+        // The chunks with the highest write rates on this shard's primary, hottest first. Empty
+        // unless the shard tracks chunk write rates (hotChunkSplitWritesPerSec is set on it).
+        std::vector<ChunkWriteRate> hotChunks;
     };
 
     virtual ~ClusterStatistics();
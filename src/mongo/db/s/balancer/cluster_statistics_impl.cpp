@@ -48,16 +48,19 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kHostField[] = "host";
+const char kOpCountersField[] = "opcounters";
+const char kUptimeMillisField[] = "uptimeMillis";
+const char kShardingStatisticsField[] = "shardingStatistics";
+const char kHotChunksField[] = "hotChunks";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -78,15 +81,50 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
+
+/**
+ * Returns the sum of the operation counters reported in 'serverStatus'.
+ */
+long long totalOpCounters(const BSONObj& serverStatus) {
+    long long totalOps = 0;
+    for (const auto& counter : serverStatus[kOpCountersField].Obj()) {
+        totalOps += counter.safeNumberLong();
+    }
+    return totalOps;
+}
+
+/**
+ * Returns the chunk write rates reported in 'serverStatus', skipping any malformed entries.
+ */
+std::vector<ClusterStatistics::ShardStatistics::ChunkWriteRate> parseHotChunks(
+    const BSONObj& serverStatus) {
+    std::vector<ClusterStatistics::ShardStatistics::ChunkWriteRate> hotChunks;
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+    const auto shardingStatistics = serverStatus[kShardingStatisticsField];
+    if (shardingStatistics.type() != BSONType::Object ||
+        shardingStatistics.Obj()[kHotChunksField].type() != BSONType::Array) {
+        return hotChunks;
     }
 
-    return version;
+    for (const auto& entry : shardingStatistics.Obj()[kHotChunksField].Obj()) {
+        if (entry.type() != BSONType::Object) {
+            continue;
+        }
+
+        const auto chunk = entry.Obj();
+        if (chunk["ns"].type() != BSONType::String || chunk["min"].type() != BSONType::Object ||
+            !chunk["writesPerSec"].isNumber()) {
+            continue;
+        }
+
+        hotChunks.push_back({NamespaceString(chunk["ns"].valueStringData()),
+                             chunk["min"].Obj().getOwned(),
+                             chunk["writesPerSec"].numberDouble()});
+    }
+
+    return hotChunks;
 }
 
 }  // namespace
@@ -97,6 +135,40 @@ ClusterStatisticsImpl::ClusterStatisticsImpl(BalancerRandomSource& random) : _ra
 
 ClusterStatisticsImpl::~ClusterStatisticsImpl() = default;
 
+double ClusterStatisticsImpl::_updateOpsPerSec(const std::string& host, OpCountersSample sample) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastOpCountersSamples.find(host);
+    if (it == _lastOpCountersSamples.end()) {
+        _lastOpCountersSamples.emplace(host, sample);
+        return 0;
+    }
+
+    const auto previous = it->second;
+    it->second = sample;
+
+    // A host which restarted since the previous sample reports unrelated counters.
+    const long long elapsedMillis = sample.uptimeMillis - previous.uptimeMillis;
+    const long long ops = sample.totalOps - previous.totalOps;
+    if (elapsedMillis <= 0 || ops < 0) {
+        return 0;
+    }
+
+    return ops * 1000.0 / elapsedMillis;
+}
+
+void ClusterStatisticsImpl::_retainOpCountersSamples(const std::set<std::string>& hosts) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    for (auto it = _lastOpCountersSamples.begin(); it != _lastOpCountersSamples.end();) {
+        if (hosts.count(it->first)) {
+            ++it;
+        } else {
+            it = _lastOpCountersSamples.erase(it);
+        }
+    }
+}
+
 StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationContext* opCtx) {
     // Get a list of all the shards that are participating in this balance round along with any
     // maximum allowed quotas and current utilization. We get the latter by issuing
@@ -114,6 +186,7 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
     std::shuffle(shards.begin(), shards.end(), _random);
 
     std::vector<ShardStatistics> stats;
+    std::set<std::string> sampledHosts;
 
     for (const auto& shard : shards) {
         const auto shardSizeStatus = [&]() -> StatusWith<long long> {
@@ -133,15 +206,37 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        double opsPerSec = 0;
+        std::vector<ShardStatistics::ChunkWriteRate> hotChunks;
+
+        // Since the mongod version is only used for reporting and the operation rate is only a
+        // hint for the balancer, there is no need to fail the entire round if they cannot be
+        // retrieved, so just leave them empty
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatusStatus.isOK()) {
+            const auto& serverStatus = serverStatusStatus.getValue();
+
+            auto versionStatus =
+                bsonExtractStringField(serverStatus, kVersionField, &mongoDVersion);
+            if (!versionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(versionStatus);
+            }
+
+            if (serverStatus[kHostField].type() == BSONType::String &&
+                serverStatus[kOpCountersField].type() == BSONType::Object &&
+                serverStatus[kUptimeMillisField].isNumber()) {
+                const auto host = serverStatus[kHostField].str();
+                sampledHosts.insert(host);
+                opsPerSec = _updateOpsPerSec(host,
+                                             {totalOpCounters(serverStatus),
+                                              serverStatus[kUptimeMillisField].safeNumberLong()});
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            hotChunks = parseHotChunks(serverStatus);
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatusStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -156,8 +251,12 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSec = opsPerSec;
+        stats.back().hotChunks = std::move(hotChunks);
     }
 
+    _retainOpCountersSamples(sampledHosts);
+
     return stats;
 }
 
@@ -28,8 +28,13 @@
 
 #pragma once
 
+#include <map>
+#include <set>
+#include <string>
+
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -37,6 +42,9 @@ namespace mongo {
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
  * fetch the statistics and does not perform any caching. If any of the shards fails to report
  * statistics fails the entire refresh.
+ *
+ * The operation rate of each shard is derived from the difference between its operation counters
+ * in consecutive calls to getStats, so it is only available from the second call onwards.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -46,8 +54,34 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    /**
+     * The total of a shard's operation counters as of a given uptime of its primary.
+     */
+    struct OpCountersSample {
+        long long totalOps;
+        long long uptimeMillis;
+    };
+
+    /**
+     * Records 'sample' for the specified host and returns the rate of operations since the
+     * previous sample for that host, or zero if there is no usable previous sample.
+     */
+    double _updateOpsPerSec(const std::string& host, OpCountersSample sample);
+
+    /**
+     * Drops the samples of the hosts other than 'hosts', which are no longer shard primaries.
+     */
+    void _retainOpCountersSamples(const std::set<std::string>& hosts);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects the members below
+    stdx::mutex _mutex;
+
+    // The latest operation counters sample obtained from each shard primary, by host. Counters
+    // of different hosts are unrelated, so a new primary starts with a new sample.
+    std::map<std::string, OpCountersSample> _lastOpCountersSamples;
 };
 
 }  // namespace mongo
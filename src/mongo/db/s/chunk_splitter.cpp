@@ -32,11 +32,17 @@
 
 #include "mongo/db/s/chunk_splitter.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/query.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
@@ -52,8 +58,24 @@
 #include "mongo/util/log.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(hotChunkSplitWritesPerSec, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "hotChunkSplitWritesPerSec must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
+// Number of write keys sampled from a hot chunk, from which its split point is chosen
+const size_t kNumSampledWriteKeys = 64;
+
+// Upper bound on the number of chunks for which write statistics are kept at a time
+const size_t kMaxTrackedChunks = 10000;
+
 /**
  * Constructs the default options for the thread pool used to schedule splits.
  */
@@ -253,6 +275,8 @@ void ChunkSplitter::onStepDown() {
         return;
     }
     _isPrimary = false;
+    _chunkWriteRates.clear();
+    _hotChunkWriteKeys.clear();
 
     // log() << "The ChunkSplitter has stopped and will no longer run new autosplit tasks. Any "
     //       << "autosplit tasks that have already started will be allowed to finish.";
@@ -271,6 +295,174 @@ void ChunkSplitter::trySplitting(const NamespaceString& nss,
     }));
 }
 
+BSONObj ChunkSplitter::recordWrite(const NamespaceString& nss,
+                                   Chunk& chunk,
+                                   const BSONObj& shardKey,
+                                   Date_t now) {
+    if (!_isPrimary) {
+        return BSONObj();
+    }
+
+    // The write is counted on the chunk itself, so that the writes to different chunks don't
+    // contend. The shared state is only locked once per chunk and write rate window, and for the
+    // writes to chunks which are about to be split.
+    bool startedWindow;
+    const double writesPerSec = chunk.addWrite(now, &startedWindow);
+    if (startedWindow) {
+        _reportWriteRate(nss, chunk.getMin(), writesPerSec, now);
+    }
+
+    // The write rates are reported to the balancer even if hot chunks are not split
+    const int writesPerSecThreshold = hotChunkSplitWritesPerSec.load();
+    if (writesPerSecThreshold <= 0 || writesPerSec < writesPerSecThreshold) {
+        return BSONObj();
+    }
+
+    const std::string chunkId = ChunkType::genID(nss, chunk.getMin());
+
+    std::vector<BSONObj> keys;
+    {
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+        // Chunks which cooled down before enough of their keys were sampled leave theirs behind
+        if (_hotChunkWriteKeys.size() >= kMaxTrackedChunks && !_hotChunkWriteKeys.count(chunkId)) {
+            _hotChunkWriteKeys.clear();
+        }
+
+        auto& chunkKeys = _hotChunkWriteKeys[chunkId];
+        chunkKeys.push_back(shardKey.getOwned());
+        if (chunkKeys.size() < kNumSampledWriteKeys) {
+            return BSONObj();
+        }
+
+        keys = std::move(chunkKeys);
+        _hotChunkWriteKeys.erase(chunkId);
+    }
+
+    chunk.clearWrites();
+
+    auto median = keys.begin() + keys.size() / 2;
+    std::nth_element(
+        keys.begin(), median, keys.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // A chunk whose writes concentrate on its lower bound cannot be split any further
+    if (median->woCompare(chunk.getMin()) <= 0) {
+        return BSONObj();
+    }
+
+    return *median;
+}
+
+void ChunkSplitter::_reportWriteRate(const NamespaceString& nss,
+                                     const BSONObj& min,
+                                     double writesPerSec,
+                                     Date_t now) {
+    const std::string chunkId = ChunkType::genID(nss, min);
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    if (_chunkWriteRates.size() >= kMaxTrackedChunks && !_chunkWriteRates.count(chunkId)) {
+        // Forget the chunks which have not been written to for long enough that their rate is
+        // stale and, if that is not sufficient, start over
+        for (auto it = _chunkWriteRates.begin(); it != _chunkWriteRates.end();) {
+            if (now - it->second.reportedAt > ChunkInfo::kWriteRateWindow * 2) {
+                it = _chunkWriteRates.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (_chunkWriteRates.size() >= kMaxTrackedChunks) {
+            _chunkWriteRates.clear();
+        }
+    }
+
+    auto& rate = _chunkWriteRates[chunkId];
+    if (rate.ns.empty()) {
+        rate.ns = nss.ns();
+        rate.min = min.getOwned();
+    }
+    rate.writesPerSec = writesPerSec;
+    rate.reportedAt = now;
+}
+
+void ChunkSplitter::reportSplit(const NamespaceString& nss,
+                                const BSONObj& min,
+                                const BSONObj& splitKey,
+                                Date_t now) {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    auto it = _chunkWriteRates.find(ChunkType::genID(nss, min));
+    if (it == _chunkWriteRates.end()) {
+        return;
+    }
+
+    // The chunk was split at the median of its recent writes, so each half gets about half of
+    // them. The new chunks start counting their writes from scratch, and would otherwise not be
+    // reported until their first window ends.
+    auto& lower = it->second;
+    lower.writesPerSec /= 2;
+    lower.reportedAt = now;
+
+    ChunkWriteRate upper;
+    upper.ns = nss.ns();
+    upper.min = splitKey.getOwned();
+    upper.writesPerSec = lower.writesPerSec;
+    upper.reportedAt = now;
+    _chunkWriteRates[ChunkType::genID(nss, splitKey)] = std::move(upper);
+}
+
+void ChunkSplitter::appendHottestChunks(BSONObjBuilder* builder, size_t limit, Date_t now) {
+    std::vector<const ChunkWriteRate*> rates;
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    // A chunk reports its rate on its first write after a window ended, so the rate of a chunk
+    // which has not reported for two windows is that of a window long gone
+    for (const auto& entry : _chunkWriteRates) {
+        if (now - entry.second.reportedAt <= ChunkInfo::kWriteRateWindow * 2) {
+            rates.push_back(&entry.second);
+        }
+    }
+
+    if (rates.empty()) {
+        return;
+    }
+
+    const auto end = rates.begin() + std::min(limit, rates.size());
+    std::partial_sort(rates.begin(), end, rates.end(), [](const auto& a, const auto& b) {
+        return a->writesPerSec > b->writesPerSec;
+    });
+
+    BSONArrayBuilder hotChunks(builder->subarrayStart("hotChunks"));
+    for (auto it = rates.begin(); it != end; ++it) {
+        BSONObjBuilder chunk(hotChunks.subobjStart());
+        chunk.append("ns", (*it)->ns);
+        chunk.append("min", (*it)->min);
+        chunk.append("writesPerSec", (*it)->writesPerSec);
+    }
+}
+
+void ChunkSplitter::trySplittingHotChunk(const NamespaceString& nss,
+                                         const BSONObj& min,
+                                         const BSONObj& max,
+                                         const BSONObj& splitKey) {
+    if (!_isPrimary) {
+        return;
+    }
+
+    // This runs as part of a user's write, which must not fail because a split could not be
+    // scheduled. The chunk gets another chance once its writes pass the threshold again.
+    const auto status = _threadPool.schedule([ this, nss, min, max, splitKey ]() noexcept {
+        _runHotChunkSplit(nss, min, max, splitKey);
+    });
+    if (!status.isOK()) {
+        warning() << "Could not schedule splitting the chunk with range '"
+                  << redact(ChunkRange(min, max).toString()) << "' of " << nss
+                  << " which receives too many writes" << causedBy(redact(status));
+    }
+}
+
 void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
                                   const BSONObj& min,
                                   const BSONObj& max,
@@ -403,4 +595,60 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
     }
 }
 
+void ChunkSplitter::_runHotChunkSplit(const NamespaceString& nss,
+                                      const BSONObj& min,
+                                      const BSONObj& max,
+                                      const BSONObj& splitKey) {
+    if (!_isPrimary) {
+        return;
+    }
+
+    try {
+        const auto opCtx = cc().makeOperationContext();
+        const auto routingInfo = uassertStatusOK(
+            Grid::get(opCtx.get())->catalogCache()->getCollectionRoutingInfo(opCtx.get(), nss));
+
+        uassert(ErrorCodes::NamespaceNotSharded,
+                "Could not split chunk. Collection is no longer sharded",
+                routingInfo.cm());
+
+        const auto cm = routingInfo.cm();
+        const auto chunk = cm->findIntersectingChunkWithSimpleCollation(min);
+
+        // Stop if chunk's range differs from the range we were expecting to split.
+        if ((0 != chunk.getMin().woCompare(min)) || (0 != chunk.getMax().woCompare(max)) ||
+            (chunk.getShardId() != ShardingState::get(opCtx.get())->getShardName())) {
+            LOG(1) << "Cannot split hot chunk with range '"
+                   << redact(ChunkRange(min, max).toString()) << "' for nss '" << nss
+                   << "' because since scheduling the split the chunk has been changed to '"
+                   << redact(chunk.toString()) << "'";
+            return;
+        }
+
+        const auto balancerConfig = Grid::get(opCtx.get())->getBalancerConfiguration();
+        // Ensure we have the most up-to-date balancer configuration
+        uassertStatusOK(balancerConfig->refreshAndCheck(opCtx.get()));
+
+        if (!balancerConfig->getShouldAutoSplit()) {
+            return;
+        }
+
+        uassertStatusOK(splitChunkAtMultiplePoints(opCtx.get(),
+                                                   chunk.getShardId(),
+                                                   nss,
+                                                   cm->getShardKeyPattern(),
+                                                   cm->getVersion(),
+                                                   ChunkRange(chunk.getMin(), chunk.getMax()),
+                                                   {splitKey}));
+        reportSplit(nss, min, splitKey);
+
+        log() << "split hot chunk " << redact(chunk.toString()) << " of " << nss << " at "
+              << redact(splitKey) << " (more than " << hotChunkSplitWritesPerSec.load()
+              << " writes per second)";
+    } catch (const DBException& ex) {
+        log() << "Unable to split hot chunk " << redact(ChunkRange(min, max).toString())
+              << " in nss " << nss << causedBy(redact(ex.toStatus()));
+    }
+}
+
 }  // namespace mongo
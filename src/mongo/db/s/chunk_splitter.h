@@ -28,14 +28,30 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+class Chunk;
 class NamespaceString;
 class OperationContext;
 class ServiceContext;
 
+/**
+ * Writes per second above which a chunk is split at the median of its recent write keys, regardless
+ * of its size. Zero disables write-rate based splitting, but not the counting of the write rates,
+ * which the balancer also uses.
+ */
+extern AtomicInt32 hotChunkSplitWritesPerSec;
+
 /**
  * Handles asynchronous auto-splitting of chunks.
  */
@@ -80,7 +96,66 @@ public:
                       const BSONObj& max,
                       long dataWritten);
 
+    /**
+     * Records a write of a document with the specified shard key into 'chunk' of 'nss', which
+     * counts towards the chunk's write rate, reported by appendHottestChunks whether or not hot
+     * chunks are split. Once the rate has passed a non-zero hotChunkSplitWritesPerSec,
+     * returns the median of the keys of the chunk's next writes, at which it should be split, and
+     * starts counting its writes afresh. Otherwise returns an empty object.
+     */
+    BSONObj recordWrite(const NamespaceString& nss,
+                        Chunk& chunk,
+                        const BSONObj& shardKey,
+                        Date_t now = Date_t::now());
+
+    /**
+     * Appends to 'builder' a 'hotChunks' array with the namespace, lower bound and write rate of
+     * up to 'limit' of the chunks with the highest write rates, hottest first, as of the last
+     * ChunkInfo::kWriteRateWindow which ended for each of them. Appends nothing if no chunk
+     * received writes recently.
+     */
+    void appendHottestChunks(BSONObjBuilder* builder, size_t limit, Date_t now = Date_t::now());
+
+    /**
+     * Shares the last reported write rate of the chunk of 'nss' starting at 'min' between the two
+     * chunks it was split into at 'splitKey', so that they are reported until they have a rate of
+     * their own.
+     */
+    void reportSplit(const NamespaceString& nss,
+                     const BSONObj& min,
+                     const BSONObj& splitKey,
+                     Date_t now = Date_t::now());
+
+    /**
+     * Schedules splitting the chunk [min, max) at 'splitKey' because it receives too many writes.
+     * Gives up on the split if it can't be scheduled.
+     */
+    void trySplittingHotChunk(const NamespaceString& nss,
+                              const BSONObj& min,
+                              const BSONObj& max,
+                              const BSONObj& splitKey);
+
 private:
+    /**
+     * Write rate of a single chunk, as of the end of its last write rate window.
+     */
+    struct ChunkWriteRate {
+        std::string ns;
+        BSONObj min;
+
+        double writesPerSec{0};
+        Date_t reportedAt;
+    };
+
+    /**
+     * Records the write rate of the chunk of 'nss' starting at 'min', whose write rate window
+     * ended at 'now'.
+     */
+    void _reportWriteRate(const NamespaceString& nss,
+                          const BSONObj& min,
+                          double writesPerSec,
+                          Date_t now);
+
     /**
      * Determines if the specified chunk should be split and then performs any necessary splits.
      *
@@ -94,12 +169,28 @@ private:
                        const BSONObj& max,
                        long dataWritten);
 
+    /**
+     * Splits the chunk [min, max) at 'splitKey' if it is still owned by this shard with the same
+     * bounds.
+     */
+    void _runHotChunkSplit(const NamespaceString& nss,
+                           const BSONObj& min,
+                           const BSONObj& max,
+                           const BSONObj& splitKey);
+
     // Protects the state below.
     stdx::mutex _mutex;
 
     // The ChunkSplitter is only active on a primary node.
     bool _isPrimary{false};
 
+    // Write rates of the chunks which received writes recently, keyed by chunk id.
+    stdx::unordered_map<std::string, ChunkWriteRate> _chunkWriteRates;
+
+    // Shard keys of the latest writes to the chunks whose write rate has passed
+    // hotChunkSplitWritesPerSec, from which their split points are chosen, keyed by chunk id.
+    stdx::unordered_map<std::string, std::vector<BSONObj>> _hotChunkWriteKeys;
+
     // Thread pool for parallelizing splits.
     ThreadPool _threadPool;
 };
@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_splitter.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const ChunkRange kChunkRange(BSON("x" << 0), BSON("x" << 1000));
+
+ChunkType makeChunkType(const ChunkRange& range) {
+    return ChunkType(kNss, range, ChunkVersion(1, 0, OID::gen()), ShardId("shard0"));
+}
+
+class ChunkSplitterWriteRateTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _oldWritesPerSec = hotChunkSplitWritesPerSec.load();
+        hotChunkSplitWritesPerSec.store(5);
+        _splitter.setReplicaSetMode(true);
+    }
+
+    void tearDown() override {
+        hotChunkSplitWritesPerSec.store(_oldWritesPerSec);
+    }
+
+    BSONObj recordWrite(const BSONObj& shardKey, Date_t now) {
+        return _splitter.recordWrite(kNss, _chunk, shardKey, now);
+    }
+
+    ChunkSplitter _splitter;
+    ChunkInfo _chunkInfo{makeChunkType(kChunkRange)};
+    Chunk _chunk{_chunkInfo, boost::none};
+    const Date_t _start = Date_t::fromMillisSinceEpoch(1000000);
+
+private:
+    int _oldWritesPerSec;
+};
+
+TEST_F(ChunkSplitterWriteRateTest, DisabledWhenThresholdIsZero) {
+    hotChunkSplitWritesPerSec.store(0);
+
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(BSON("x" << i), _start + Milliseconds(i)).isEmpty());
+    }
+}
+
+TEST_F(ChunkSplitterWriteRateTest, NotPrimary) {
+    _splitter.setReplicaSetMode(false);
+
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(BSON("x" << i), _start + Milliseconds(i)).isEmpty());
+    }
+}
+
+TEST_F(ChunkSplitterWriteRateTest, SlowWritesDoNotSplit) {
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(BSON("x" << i), _start + Seconds(i)).isEmpty());
+    }
+}
+
+TEST_F(ChunkSplitterWriteRateTest, HotChunkSplitsAtMedianOfSampledWrites) {
+    BSONObj splitKey;
+    int numWrites = 0;
+    while (splitKey.isEmpty() && numWrites < 200) {
+        numWrites++;
+        splitKey = recordWrite(BSON("x" << numWrites), _start + Milliseconds(10 * numWrites));
+    }
+
+    // At 100 writes per second, the rate over the 10 second window passes the threshold with the
+    // 50th write, after which the keys [50, 113] are sampled
+    ASSERT_EQ(113, numWrites);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 82), splitKey);
+
+    // Counting starts afresh after a split has been suggested
+    ASSERT(recordWrite(BSON("x" << 114), _start + Milliseconds(10 * 114)).isEmpty());
+}
+
+TEST_F(ChunkSplitterWriteRateTest, WritesAtLowerBoundDoNotSplit) {
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(kChunkRange.getMin(), _start + Milliseconds(i)).isEmpty());
+    }
+}
+
+TEST_F(ChunkSplitterWriteRateTest, ReportsHottestChunksFirst) {
+    hotChunkSplitWritesPerSec.store(1000);
+
+    const ChunkRange coldRange(BSON("x" << 1000), BSON("x" << 2000));
+    ChunkInfo coldChunkInfo(makeChunkType(coldRange));
+    Chunk coldChunk(coldChunkInfo, boost::none);
+
+    for (int i = 1; i <= 300; i++) {
+        if (i % 10 == 0) {
+            const auto coldKey = BSON("x" << 1000 + i);
+            ASSERT(_splitter.recordWrite(kNss, coldChunk, coldKey, _start + Seconds(i / 10))
+                       .isEmpty());
+        }
+        ASSERT(recordWrite(BSON("x" << i), _start + Milliseconds(100 * i)).isEmpty());
+    }
+
+    BSONObjBuilder builder;
+    _splitter.appendHottestChunks(&builder, 1, _start + Seconds(30));
+    const auto hotChunks = builder.obj()["hotChunks"].Array();
+
+    ASSERT_EQ(1U, hotChunks.size());
+    ASSERT_EQ(kNss.ns(), hotChunks[0]["ns"].str());
+    ASSERT_BSONOBJ_EQ(kChunkRange.getMin(), hotChunks[0]["min"].Obj());
+    ASSERT_GTE(hotChunks[0]["writesPerSec"].numberDouble(), 10);
+}
+
+TEST_F(ChunkSplitterWriteRateTest, ForgetsRatesOfChunksWithoutRecentWrites) {
+    hotChunkSplitWritesPerSec.store(1000);
+
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(BSON("x" << i), _start + Milliseconds(100 * i)).isEmpty());
+    }
+
+    BSONObjBuilder recentBuilder;
+    _splitter.appendHottestChunks(&recentBuilder, 10, _start + Seconds(20));
+    ASSERT_EQ(1U, recentBuilder.obj()["hotChunks"].Array().size());
+
+    BSONObjBuilder staleBuilder;
+    _splitter.appendHottestChunks(&staleBuilder, 10, _start + Minutes(1));
+    ASSERT(staleBuilder.obj().isEmpty());
+}
+
+TEST_F(ChunkSplitterWriteRateTest, ReportsRatesWhenSplittingIsDisabled) {
+    hotChunkSplitWritesPerSec.store(0);
+
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(BSON("x" << i), _start + Milliseconds(100 * i)).isEmpty());
+    }
+
+    BSONObjBuilder builder;
+    _splitter.appendHottestChunks(&builder, 10, _start + Seconds(20));
+    const auto hotChunks = builder.obj()["hotChunks"].Array();
+
+    ASSERT_EQ(1U, hotChunks.size());
+    ASSERT_BSONOBJ_EQ(kChunkRange.getMin(), hotChunks[0]["min"].Obj());
+    ASSERT_GTE(hotChunks[0]["writesPerSec"].numberDouble(), 10);
+}
+
+TEST_F(ChunkSplitterWriteRateTest, SplitChunkKeepsItsRateUnderItsNewRanges) {
+    hotChunkSplitWritesPerSec.store(1000);
+
+    for (int i = 1; i <= 200; i++) {
+        ASSERT(recordWrite(BSON("x" << i), _start + Milliseconds(100 * i)).isEmpty());
+    }
+
+    BSONObjBuilder beforeBuilder;
+    _splitter.appendHottestChunks(&beforeBuilder, 10, _start + Seconds(20));
+    const double writesPerSec =
+        beforeBuilder.obj()["hotChunks"].Array()[0]["writesPerSec"].numberDouble();
+
+    // Reported long enough after the chunk's last window that its own rate would be stale
+    _splitter.reportSplit(kNss, kChunkRange.getMin(), BSON("x" << 100), _start + Seconds(40));
+
+    BSONObjBuilder afterBuilder;
+    _splitter.appendHottestChunks(&afterBuilder, 10, _start + Seconds(45));
+    auto hotChunks = afterBuilder.obj()["hotChunks"].Array();
+
+    ASSERT_EQ(2U, hotChunks.size());
+    std::sort(hotChunks.begin(), hotChunks.end(), [](const auto& a, const auto& b) {
+        return a["min"].Obj().woCompare(b["min"].Obj()) < 0;
+    });
+    ASSERT_BSONOBJ_EQ(kChunkRange.getMin(), hotChunks[0]["min"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("x" << 100), hotChunks[1]["min"].Obj());
+    ASSERT_EQ(writesPerSec / 2, hotChunks[0]["writesPerSec"].numberDouble());
+    ASSERT_EQ(writesPerSec / 2, hotChunks[1]["writesPerSec"].numberDouble());
+}
+
+TEST_F(ChunkSplitterWriteRateTest, ReportsNoHotChunksWithoutWrites) {
+    BSONObjBuilder builder;
+    _splitter.appendHottestChunks(&builder, 10, _start);
+    ASSERT(builder.obj().isEmpty());
+}
+
+}  // namespace
+}  // namespace mongo
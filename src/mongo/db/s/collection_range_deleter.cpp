@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog_raii.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
@@ -58,6 +60,23 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 32)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterBatchSize must be at least 1");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBytesPerSec, int, 0)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterMaxBytesPerSec must be nonnegative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
@@ -97,6 +116,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     CollectionRangeDeleter* forTestOnly) {
 
     StatusWith<int> wrote = 0;
+    long long bytesDeleted = 0;
 
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
@@ -197,7 +217,8 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
         try {
             const auto keyPattern = scopedCollectionMetadata->getKeyPattern();
-            wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, maxToDelete);
+            wrote = self->_doDeletion(
+                opCtx, collection, keyPattern, *range, maxToDelete, &bytesDeleted);
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
@@ -272,6 +293,12 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(wrote.getValue() > 0);
 
     notification.abandon();
+
+    // Pace the deletion passes so that, on average, they stay within the configured byte budget.
+    const int maxBytesPerSec = rangeDeleterMaxBytesPerSec.load();
+    if (maxBytesPerSec > 0) {
+        return Date_t::now() + Milliseconds(bytesDeleted * 1000 / maxBytesPerSec);
+    }
     return Date_t{};
 }
 
@@ -279,7 +306,8 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                                                     Collection* collection,
                                                     BSONObj const& keyPattern,
                                                     ChunkRange const& range,
-                                                    int maxToDelete) {
+                                                    int maxToDelete,
+                                                    long long* bytesDeleted) {
     invariant(collection != nullptr);
     invariant(!isEmpty());
 
@@ -321,40 +349,67 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
+    auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
+    auto manual = PlanExecutor::YIELD_MANUAL;
+    auto forward = InternalPlanner::FORWARD;
+    auto fetch = InternalPlanner::IXSCAN_FETCH;
+
+    auto exec = InternalPlanner::indexScan(
+        opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
+
+    const int batchSize = std::max(rangeDeleterBatchSize.load(), 1);
+
     int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
-
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
-
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
+    bool scanDone = false;
+    while (!scanDone && numDeleted < maxToDelete) {
+        // Collect the next batch of documents in index order, then delete them all in a single
+        // storage transaction, so that their index key removals and oplog entries are written
+        // together rather than one document at a time.
+        std::vector<std::pair<RecordId, BSONObj>> batch;
+        while (batch.size() < static_cast<size_t>(std::min(batchSize, maxToDelete - numDeleted))) {
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+            if (state == PlanExecutor::IS_EOF) {
+                scanDone = true;
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning() << PlanExecutor::statestr(state)
+                          << " - cursor error while trying to delete " << redact(min) << " to "
+                          << redact(max) << " in " << nss << ": "
+                          << redact(WorkingSetCommon::toStatusString(obj))
+                          << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                scanDone = true;
+                break;
+            }
+            invariant(PlanExecutor::ADVANCED == state);
+
+            *bytesDeleted += obj.objsize();
+            batch.emplace_back(rloc, saver ? obj.getOwned() : BSONObj());
         }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << redact(WorkingSetCommon::toStatusString(obj))
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
+
+        if (batch.empty()) {
             break;
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
+        exec->saveState();
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
             WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+            for (const auto& doc : batch) {
+                if (saver) {
+                    uassertStatusOK(saver->goingToDelete(doc.second));
+                }
+                collection->deleteDocument(opCtx, kUninitializedStmtId, doc.first, nullptr, true);
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
-    } while (++numDeleted < maxToDelete);
+        numDeleted += batch.size();
+
+        if (!scanDone) {
+            uassertStatusOK(exec->restoreState());
+        }
+    }
 
     return numDeleted;
 }
@@ -32,6 +32,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/time_support.h"
@@ -42,6 +43,12 @@ class BSONObj;
 class Collection;
 class OperationContext;
 
+// Number of documents deleted in a single storage transaction.
+extern AtomicInt32 rangeDeleterBatchSize;
+
+// If positive, the rate in bytes per second to which range deletion is throttled.
+extern AtomicInt32 rangeDeleterMaxBytesPerSec;
+
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
 
@@ -158,7 +165,8 @@ public:
      * it must be called without locks.
      *
      * If it should be scheduled to run again because there might be more documents to delete,
-     * returns the time to begin, or boost::none otherwise.
+     * returns the time to begin, or boost::none otherwise. If rangeDeleterMaxBytesPerSec is set,
+     * the next run is delayed long enough for the bytes just deleted to fit within that budget.
      *
      * Argument 'forTestOnly' is used in unit tests that exercise the CollectionRangeDeleter class,
      * so that they do not need to set up CollectionShardingState and MetadataManager objects.
@@ -171,8 +179,9 @@ public:
 
 private:
     /**
-     * Performs the deletion of up to maxToDelete entries within the range in progress. Must be
-     * called under the collection lock.
+     * Performs the deletion of up to maxToDelete entries within the range in progress, in batches
+     * of rangeDeleterBatchSize documents per storage transaction. Must be called under the
+     * collection lock. Adds the total size of the deleted documents to 'bytesDeleted'.
      *
      * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
      * the range failed.
@@ -181,7 +190,8 @@ private:
                                 Collection* collection,
                                 const BSONObj& keyPattern,
                                 ChunkRange const& range,
-                                int maxToDelete);
+                                int maxToDelete,
+                                long long* bytesDeleted);
 
     /**
      * Removes the latest-scheduled range from the ranges to be cleaned up, and notifies any
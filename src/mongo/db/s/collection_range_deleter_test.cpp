@@ -45,6 +45,7 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -203,6 +204,63 @@ TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInOneRangeToClean) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kShardKey << "startRangeDeletion")));
 }
 
+// Tests that a single run deletes documents in several storage transactions when its limit
+// exceeds the batch size.
+TEST_F(CollectionRangeDeleterTest, MultipleBatchesInOneRun) {
+    const int oldBatchSize = rangeDeleterBatchSize.load();
+    ON_BLOCK_EXIT([oldBatchSize] { rangeDeleterBatchSize.store(oldBatchSize); });
+    rangeDeleterBatchSize.store(2);
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    for (int i = 1; i <= 5; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+    ASSERT_EQUALS(5ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+
+    std::list<Deletion> ranges;
+    auto deletion = Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}};
+    ranges.emplace_back(std::move(deletion));
+    auto when = rangeDeleter.add(std::move(ranges));
+    ASSERT(when && *when == Date_t{});
+
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+    ASSERT_TRUE(next(rangeDeleter, 4));
+    ASSERT_FALSE(next(rangeDeleter, 4));
+}
+
+// Tests that a byte budget delays the run following one which deleted documents.
+TEST_F(CollectionRangeDeleterTest, ByteBudgetDelaysNextRun) {
+    const int oldMaxBytesPerSec = rangeDeleterMaxBytesPerSec.load();
+    ON_BLOCK_EXIT([oldMaxBytesPerSec] { rangeDeleterMaxBytesPerSec.store(oldMaxBytesPerSec); });
+    rangeDeleterMaxBytesPerSec.store(1);
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 1));
+
+    std::list<Deletion> ranges;
+    auto deletion = Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}};
+    ranges.emplace_back(std::move(deletion));
+    auto when = rangeDeleter.add(std::move(ranges));
+    ASSERT(when && *when == Date_t{});
+
+    const auto start = Date_t::now();
+    auto nextRun = next(rangeDeleter, 100);
+    ASSERT_TRUE(nextRun);
+    ASSERT_GT(*nextRun, start);
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 10)));
+
+    // Runs which delete nothing are not delayed.
+    nextRun = next(rangeDeleter, 100);
+    ASSERT_TRUE(nextRun);
+    ASSERT_EQUALS(*nextRun, Date_t{});
+    ASSERT_FALSE(next(rangeDeleter, 100));
+}
+
 // Tests the case that there are multiple documents within a range to clean, and the range deleter
 // has a max deletion rate of one document per run.
 TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
@@ -32,6 +32,9 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -471,11 +474,27 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    // Claim the record ids which are expected to fill the rest of the batch and read the documents
+    // without holding the mutex, so that concurrent requests from a recipient cloning over several
+    // streams read disjoint parts of the chunk in parallel instead of one after the other.
+    std::vector<RecordId> claimedLocs;
+    {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+        const uint64_t bytesLeft = std::max(BSONObjMaxUserSize - arrBuilder->len(), 0);
+        const uint64_t numToClaim =
+            bytesLeft / std::max(_averageObjectSizeForCloneLocs, uint64_t{1}) + 1;
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
+        auto it = _cloneLocs.begin();
+        for (; it != _cloneLocs.end() && claimedLocs.size() < numToClaim; ++it) {
+            claimedLocs.push_back(*it);
+        }
+        _cloneLocs.erase(_cloneLocs.begin(), it);
+        ++_numCloneBatchesInProgress;
+    }
+
+    auto it = claimedLocs.begin();
+    for (; it != claimedLocs.end(); ++it) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
@@ -495,11 +514,15 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
         }
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+    stdx::lock_guard<stdx::mutex> sl(_mutex);
+
+    // Give back the record ids which did not make it into this batch.
+    _cloneLocs.insert(it, claimedLocs.end());
+    --_numCloneBatchesInProgress;
 
     // If we have drained all the cloned data, there is no need to keep the delete notify executor
     // around
-    if (_cloneLocs.empty() && _deleteNotifyExec) {
+    if (_cloneLocs.empty() && !_numCloneBatchesInProgress && _deleteNotifyExec) {
         // We have a different OperationContext than when we created the PlanExecutor, so need to
         // manually destroy it ourselves.
         _deleteNotifyExec->dispose(opCtx, collection->getCursorManager());
@@ -116,6 +116,9 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * May be called concurrently by several requests from the recipient, each of which is handed a
+     * disjoint set of documents.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* opCtx,
@@ -212,6 +215,10 @@ private:
     // List of record ids that needs to be transferred (initial clone)
     std::set<RecordId> _cloneLocs;
 
+    // Number of nextCloneBatch calls which have taken record ids out of _cloneLocs and not yet
+    // returned the ones they did not transfer (initial clone)
+    int _numCloneBatchesInProgress{0};
+
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
     uint64_t _averageObjectSizeForCloneLocs{0};
@@ -51,11 +51,14 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -195,6 +198,17 @@ BSONObj createTransferModsRequest(const NamespaceString& nss, const MigrationSes
     return builder.obj();
 }
 
+// Number of streams over which the initial clone of a chunk is fetched from the donor and
+// inserted locally.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneConcurrency, int, 4)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneConcurrency must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
 // receives a chunk migration from the donor.
 MONGO_FP_DECLARE(migrateThreadHangAtStep1);
@@ -373,48 +387,117 @@ Status MigrationDestinationManager::start(const NamespaceString& nss,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
-    stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numStreams) {
+    invariant(numStreams > 0);
 
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
-        Client::initThreadIfNotAlready("chunkInserter");
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), BSONObjIterator(arr));
-            }
-        } catch (...) {
+    ProducerConsumerQueue<BSONObj> batches(numStreams);
+
+    // Errors on the helper threads are surfaced to the caller by interrupting its operation, after
+    // which the queue is closed to stop the other helpers.
+    auto failClone = [&](StringData what) {
+        {
             stdx::lock_guard<Client> lk(*opCtx->getClient());
             opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
         }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
-        batches.closeProducerEnd();
-        inserterThread.join();
-    });
+        log() << what << " failed " << causedBy(redact(exceptionToStatus()));
+        batches.closeConsumerEnd();
+    };
+
+    // The queue allows only one producer to wait for space at a time, so the fetchers take turns
+    // pushing.
+    stdx::mutex pushMutex;
+    stdx::condition_variable pushCV;
+    bool pushing = false;
+
+    auto pushBatch = [&](OperationContext* fetcherOpCtx, BSONObj batch) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(pushMutex);
+            fetcherOpCtx->waitForConditionOrInterrupt(pushCV, lk, [&] { return !pushing; });
+            pushing = true;
+        }
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> lk(pushMutex);
+            pushing = false;
+            pushCV.notify_one();
+        });
 
-    while (true) {
-        opCtx->checkForInterrupt();
+        batches.push(std::move(batch), fetcherOpCtx);
+    };
 
-        auto res = fetchBatchFn(opCtx);
+    auto fetchBatches = [&](OperationContext* fetcherOpCtx) {
+        while (true) {
+            fetcherOpCtx->checkForInterrupt();
 
-        opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
-        auto arr = res["objects"].Obj();
-        if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
-            opCtx->checkForInterrupt();
-            break;
+            auto res = fetchBatchFn(fetcherOpCtx);
+
+            fetcherOpCtx->checkForInterrupt();
+            if (res["objects"].Obj().isEmpty()) {
+                return;
+            }
+            pushBatch(fetcherOpCtx, res.getOwned());
+        }
+    };
+
+    std::vector<stdx::thread> inserterThreads;
+    std::vector<stdx::thread> fetcherThreads;
+    auto joinGuard = MakeGuard([&] {
+        batches.closeConsumerEnd();
+        for (auto& thread : fetcherThreads) {
+            thread.join();
+        }
+        for (auto& thread : inserterThreads) {
+            thread.join();
         }
+    });
+
+    for (int i = 0; i < numStreams; ++i) {
+        inserterThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkInserter");
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    insertBatchFn(inserterOpCtx.get(), BSONObjIterator(nextBatch["objects"].Obj()));
+                }
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Either all batches have been inserted or another thread failed.
+            } catch (...) {
+                failClone("Batch insertion");
+            }
+        });
     }
+
+    // The calling thread is one of the fetchers, so the remaining streams each get their own.
+    for (int i = 1; i < numStreams; ++i) {
+        fetcherThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkFetcher");
+            auto fetcherOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                fetchBatches(fetcherOpCtx.get());
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Another thread failed.
+            } catch (...) {
+                failClone("Batch fetching");
+            }
+        });
+    }
+
+    fetchBatches(opCtx);
+    for (auto& thread : fetcherThreads) {
+        thread.join();
+    }
+    fetcherThreads.clear();
+    opCtx->checkForInterrupt();
+
+    // Every fetcher has seen the end of the initial clone, so the inserters can drain the queue.
+    batches.closeProducerEnd();
+    for (auto& thread : inserterThreads) {
+        thread.join();
+    }
+    inserterThreads.clear();
+    joinGuard.Dismiss();
+    opCtx->checkForInterrupt();
 }
 
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
@@ -817,20 +900,24 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
             }
         };
 
+        // Each call uses its own pooled connection, since several streams may fetch at once.
         auto fetchBatchFn = [&](OperationContext* opCtx) {
+            ScopedDbConnection fetchConn(fromShardConnString);
             BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
-                conn.done();
+            if (!fetchConn->runCommand("admin",
+                                       migrateCloneRequest,
+                                       res)) {  // gets array of objects to copy, in disk order
+                fetchConn.done();
                 const std::string errMsg = str::stream() << "_migrateClone failed: "
                                                          << redact(res.toString());
                 uasserted(50747, errMsg);
             }
+            fetchConn.done();
             return res;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        cloneDocumentsFromDonor(
+            opCtx, insertBatchFn, fetchBatchFn, migrateCloneConcurrency.load());
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
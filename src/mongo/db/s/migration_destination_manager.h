@@ -118,12 +118,16 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. Batches are fetched by calling 'fetchBatchFn' from
+     * 'numStreams' threads, including the calling one, until each of them receives an empty batch,
+     * and are inserted by as many separate threads through 'insertBatchFn'. Both functions must be
+     * safe to call concurrently if 'numStreams' is greater than one.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
         stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
-        stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
+        stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numStreams = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
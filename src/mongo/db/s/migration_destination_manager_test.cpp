@@ -29,8 +29,15 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/s/migration_destination_manager.h"
+
+#include <set>
+
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -104,6 +111,98 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every batch is inserted exactly once when fetching and inserting over several streams.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithMultipleStreams) {
+    const int kNumBatches = 10;
+    AtomicInt32 numFetches(0);
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        const int batchNum = numFetches.fetchAndAdd(1);
+        if (batchNum < kNumBatches) {
+            BSONArrayBuilder arrayBuilder;
+            arrayBuilder.append(createDocument(batchNum));
+            fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        } else {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    stdx::mutex mutex;
+    std::set<int> insertedIds;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
+        while (docs.more()) {
+            const int id = docs.next().Obj()["_id"].numberInt();
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ASSERT(insertedIds.insert(id).second);
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 3);
+
+    ASSERT_EQ(static_cast<size_t>(kNumBatches), insertedIds.size());
+    ASSERT_EQ(0, *insertedIds.begin());
+    ASSERT_EQ(kNumBatches - 1, *insertedIds.rbegin());
+}
+
+// Tests that fetchers which all find the queue full at once wait their turn to push.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsWithAllFetchersBlockedOnFullQueue) {
+    const int kNumStreams = 3;
+
+    // Each inserter holds a batch and the queue holds one batch per stream, so this many fetches
+    // leave every fetcher waiting for space.
+    const int kNumFetchesToFillUp = 3 * kNumStreams;
+    const int kNumBatches = 2 * kNumFetchesToFillUp;
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    int numFetches = 0;
+    std::set<int> insertedIds;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        const int batchNum = numFetches++;
+        cv.notify_all();
+        if (batchNum < kNumBatches) {
+            BSONArrayBuilder arrayBuilder;
+            arrayBuilder.append(createDocument(batchNum));
+            fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        } else {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cv.wait(lk, [&] { return numFetches >= kNumFetchesToFillUp; });
+        }
+
+        // Give the fetchers time to get stuck on the full queue.
+        sleepmillis(100);
+
+        while (docs.more()) {
+            const int id = docs.next().Obj()["_id"].numberInt();
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ASSERT(insertedIds.insert(id).second);
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, kNumStreams);
+
+    ASSERT_EQ(static_cast<size_t>(kNumBatches), insertedIds.size());
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
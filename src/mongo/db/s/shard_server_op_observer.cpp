@@ -34,6 +34,7 @@
 
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/database_sharding_state.h"
 #include "mongo/db/s/migration_source_manager.h"
@@ -187,6 +188,15 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
         // TODO: call ChunkSplitter here
         chunk.clearBytesWritten();
     }
+
+    // Independently of its size, split a chunk which receives writes too quickly, so that the
+    // balancer can spread its range across shards.
+    auto& chunkSplitter = ChunkSplitter::get(opCtx);
+    const auto hotSplitKey = chunkSplitter.recordWrite(chunkManager.getns(), chunk, shardKey);
+    if (!hotSplitKey.isEmpty()) {
+        chunkSplitter.trySplittingHotChunk(
+            chunkManager.getns(), chunk.getMin(), chunk.getMax(), hotSplitKey);
+    }
 }
 
 }  // namespace
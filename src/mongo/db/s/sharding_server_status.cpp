@@ -31,6 +31,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/s/active_migrations_registry.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/server_options.h"
@@ -42,6 +43,9 @@
 namespace mongo {
 namespace {
 
+// The number of chunks with the highest write rates reported in serverStatus.
+const size_t kNumReportedHotChunks = 10;
+
 bool isClusterNode() {
     return serverGlobalParams.clusterRole != ClusterRole::None;
 }
@@ -114,6 +118,9 @@ public:
         BSONObjBuilder result;
         ShardingStatistics::get(opCtx).report(&result);
         catalogCache->report(&result);
+
+        // The balancer moves the hottest of these chunks off shards which serve too much load.
+        ChunkSplitter::get(opCtx).appendHottestChunks(&result, kNumReportedHotChunks);
         return result.obj();
     }
 
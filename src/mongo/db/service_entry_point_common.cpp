@@ -489,6 +489,11 @@ bool runCommandImpl(OperationContext* opCtx,
 
     CommandReplyBuilder crb(replyBuilder->getInPlaceReplyBuilder(bytesToReserve));
 
+    // Cursor-returning commands may splice large documents into an OP_MSG reply rather than copy
+    // them, unless the reply is only going to be read back in-process.
+    CommandHelpers::ReplyOpMsgBuilderScope replyOpMsgBuilderScope(
+        opCtx, opCtx->getClient()->isInDirectClient() ? nullptr : replyBuilder->getOpMsgBuilder());
+
     if (!invocation->supportsWriteConcern()) {
         behaviors.uassertCommandDoesNotSpecifyWriteConcern(request.body);
         invokeInTransaction(opCtx, invocation, &crb);
@@ -931,6 +936,7 @@ DbResponse runCommands(OperationContext* opCtx,
                        const Message& message,
                        const ServiceEntryPointCommon::Hooks& behaviors) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    bool shouldRunAgainForExhaust = false;
     [&] {
         OpMsgRequest request;
         try {  // Parse.
@@ -984,6 +990,8 @@ DbResponse runCommands(OperationContext* opCtx,
             }
 
             execCommandDatabase(opCtx, c, request, replyBuilder.get(), behaviors);
+            shouldRunAgainForExhaust =
+                CommandHelpers::shouldRunAgainForExhaust(message, request, replyBuilder.get());
         } catch (const DBException& ex) {
             BSONObjBuilder metadataBob;
             appendReplyMetadataOnError(opCtx, &metadataBob);
@@ -1012,8 +1020,9 @@ DbResponse runCommands(OperationContext* opCtx,
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
-    return DbResponse{std::move(response)};
+    DbResponse dbResponse{std::move(response)};
+    dbResponse.shouldRunAgainForExhaust = shouldRunAgainForExhaust;
+    return dbResponse;
 }
 
 DbResponse receivedQuery(OperationContext* opCtx,
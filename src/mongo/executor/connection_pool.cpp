@@ -32,6 +32,8 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <cmath>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/remote_command_request.h"
@@ -43,7 +45,7 @@
 #include "mongo/util/scopeguard.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -68,7 +70,7 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
+     * and unlock the pool's mutex (and can leave unlocked), we want to start the client with the
      * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
      * out.
      *
@@ -78,8 +80,7 @@ public:
      */
     template <typename Callback>
     auto runWithActiveClient(Callback&& cb) {
-        return runWithActiveClient(stdx::unique_lock<stdx::mutex>(_parent->_mutex),
-                                   std::forward<Callback>(cb));
+        return runWithActiveClient(lockPool(), std::forward<Callback>(cb));
     }
 
     template <typename Callback>
@@ -90,7 +91,7 @@ public:
 
         const auto guard = MakeGuard([&] {
             invariant(!lk.owns_lock());
-            stdx::lock_guard<stdx::mutex> lk(_parent->_mutex);
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
             _activeClients--;
         });
 
@@ -104,8 +105,16 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires the mutex which guards this specific pool. If the parent's mutex is also needed, it
+     * must be acquired first.
+     */
+    stdx::unique_lock<stdx::mutex> lockPool() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on the
+     * pool's mutex to preserve the lock on _mutex
      */
     Future<ConnectionHandle> getConnection(const HostAndPort& hostAndPort,
                                            Milliseconds timeout,
@@ -119,8 +128,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on the
+     * pool's mutex to preserve the lock on _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -151,6 +160,11 @@ public:
      */
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the connection statistics of this pool, as reported by connPoolStats.
+     */
+    ConnectionStatsPer getStats(const stdx::unique_lock<stdx::mutex>& lk);
+
     /**
      * Return true if the tags on the specific pool match the passed in tags
      */
@@ -184,13 +198,28 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, SharedPromise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t requested;
+        SharedPromise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
+    /**
+     * Running totals of the pool's traffic, used both for connPoolStats and for adaptive sizing.
+     */
+    struct Counters {
+        size_t requested = 0;
+        size_t acquired = 0;
+        size_t returned = 0;
+        Milliseconds waitTime{0};
+        Milliseconds inUseTime{0};
+    };
+
     void addToReady(stdx::unique_lock<stdx::mutex>& lk, OwnedConnection conn);
 
     void fulfillRequests(stdx::unique_lock<stdx::mutex>& lk);
@@ -207,11 +236,20 @@ private:
 
     void updateStateInLock();
 
+    /**
+     * Recomputes _adaptiveTarget once every kAdaptiveSizingWindow, from the traffic the pool saw
+     * since the last time. Does nothing unless Options::adaptiveSizing is set.
+     */
+    void updateAdaptiveTarget(Date_t now);
+
 private:
     ConnectionPool* const _parent;
 
     const HostAndPort _hostAndPort;
 
+    // Guards all of the members below.
+    stdx::mutex _mutex;
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -228,6 +266,18 @@ private:
 
     size_t _created;
 
+    // When each connection in _checkedOutPool was handed to a user, to measure in-use time.
+    stdx::unordered_map<ConnectionInterface*, Date_t> _checkOutTimes;
+
+    Counters _counters;
+
+    // The counters and the time at the start of the current adaptive sizing window.
+    Counters _windowStartCounters;
+    Date_t _windowStart;
+
+    // The number of connections adaptive sizing expects the pool to need.
+    size_t _adaptiveTarget = 0;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -262,6 +312,7 @@ size_t const ConnectionPool::kDefaultMinConns = 1;
 size_t const ConnectionPool::kDefaultMaxConnecting = std::numeric_limits<size_t>::max();
 constexpr Milliseconds ConnectionPool::kDefaultRefreshRequirement;
 constexpr Milliseconds ConnectionPool::kDefaultRefreshTimeout;
+constexpr Milliseconds ConnectionPool::kAdaptiveSizingWindow;
 
 const Status ConnectionPool::kConnectionStateUnknown =
     Status(ErrorCodes::InternalError, "Connection is in an unknown state");
@@ -289,24 +340,24 @@ ConnectionPool::~ConnectionPool() {
 }
 
 void ConnectionPool::shutdown() {
-    std::vector<SpecificPool*> pools;
+    std::vector<std::shared_ptr<SpecificPool>> pools;
 
     // Ensure we decrement active clients for all pools that we inc on (because we intend to process
     // failures)
     const auto guard = MakeGuard([&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
         for (const auto& pool : pools) {
+            auto lk = pool->lockPool();
             pool->decActiveClients(lk);
         }
     });
 
     // Grab all current pools (under the lock)
     {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
         for (auto& pair : _pools) {
-            pools.push_back(pair.second.get());
+            auto lk = pair.second->lockPool();
+            pools.push_back(pair.second);
             pair.second->incActiveClients(lk);
         }
     }
@@ -314,48 +365,54 @@ void ConnectionPool::shutdown() {
     // Reacquire the lock per pool and process failures.  We'll dec active clients when we're all
     // through in the guard
     for (const auto& pool : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
         pool->processFailure(
             Status(ErrorCodes::ShutdownInProgress, "Shuting down the connection pool"),
-            std::move(lk));
+            pool->lockPool());
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    std::shared_ptr<SpecificPool> pool;
+    stdx::unique_lock<stdx::mutex> lk;
+    {
+        stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
-    auto iter = _pools.find(hostAndPort);
+        auto iter = _pools.find(hostAndPort);
 
-    if (iter == _pools.end())
-        return;
+        if (iter == _pools.end())
+            return;
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->processFailure(
+        pool = iter->second;
+        lk = pool->lockPool();
+    }
+
+    pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
             std::move(lk));
     });
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
-    std::vector<SpecificPool*> pools;
+    std::vector<std::shared_ptr<SpecificPool>> pools;
 
     // Ensure we decrement active clients for all pools that we inc on (because we intend to process
     // failures)
     const auto guard = MakeGuard([&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
         for (const auto& pool : pools) {
+            auto lk = pool->lockPool();
             pool->decActiveClients(lk);
         }
     });
 
     // Grab all current pools that don't match tags (under the lock)
     {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
         for (auto& pair : _pools) {
+            auto lk = pair.second->lockPool();
             if (!pair.second->matchesTags(lk, tags)) {
-                pools.push_back(pair.second.get());
+                pools.push_back(pair.second);
                 pair.second->incActiveClients(lk);
             }
         }
@@ -364,23 +421,23 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     // Reacquire the lock per pool and process failures.  We'll dec active clients when we're all
     // through in the guard
     for (const auto& pool : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
         pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
-            std::move(lk));
+            pool->lockPool());
     }
 }
 
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
     auto iter = _pools.find(hostAndPort);
 
     if (iter == _pools.end())
         return;
 
+    auto lk = iter->second->lockPool();
     iter->second->mutateTags(lk, mutateFunc);
 }
 
@@ -392,46 +449,41 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
 
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                              Milliseconds timeout) {
-    SpecificPool* pool;
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    std::shared_ptr<SpecificPool> pool;
+    stdx::unique_lock<stdx::mutex> lk;
+    {
+        stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
-    auto iter = _pools.find(hostAndPort);
+        auto& slot = _pools[hostAndPort];
+        if (!slot) {
+            slot = std::make_shared<SpecificPool>(this, hostAndPort);
+        }
+        pool = slot;
 
-    if (iter == _pools.end()) {
-        auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
-        pool = handle.get();
-        _pools[hostAndPort] = std::move(handle);
-    } else {
-        pool = iter->second.get();
+        // Lock the specific pool before releasing '_pools', so that it cannot shut down before
+        // runWithActiveClient() registers us below.
+        lk = pool->lockPool();
     }
 
-    invariant(pool);
-
     return pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
         return pool->getConnection(hostAndPort, timeout, std::move(lk));
     });
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
     for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
-
-        auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
-        stats->updateStatsForHost(_name, host, hostStats);
+        auto lk = kv.second->lockPool();
+        stats->updateStatsForHost(_name, kv.first, kv.second->getStats(lk));
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
     auto iter = _pools.find(hostAndPort);
     if (iter != _pools.end()) {
+        auto lk = iter->second->lockPool();
         return iter->second->openConnections(lk);
     }
 
@@ -439,16 +491,23 @@ size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort)
 }
 
 void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    std::shared_ptr<SpecificPool> pool;
+    stdx::unique_lock<stdx::mutex> lk;
+    {
+        stdx::lock_guard<stdx::mutex> poolsLk(_mutex);
 
-    auto iter = _pools.find(conn->getHostAndPort());
+        auto iter = _pools.find(conn->getHostAndPort());
 
-    invariant(iter != _pools.end(),
-              str::stream() << "Tried to return connection but no pool found for "
-                            << conn->getHostAndPort());
+        invariant(iter != _pools.end(),
+                  str::stream() << "Tried to return connection but no pool found for "
+                                << conn->getHostAndPort());
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->returnConnection(conn, std::move(lk));
+        pool = iter->second;
+        lk = pool->lockPool();
+    }
+
+    pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        pool->returnConnection(conn, std::move(lk));
     });
 }
 
@@ -490,20 +549,37 @@ size_t ConnectionPool::SpecificPool::openConnections(const stdx::unique_lock<std
     return _checkedOutPool.size() + _readyPool.size() + _processingPool.size();
 }
 
+ConnectionStatsPer ConnectionPool::SpecificPool::getStats(
+    const stdx::unique_lock<stdx::mutex>& lk) {
+    ConnectionStatsPer stats{inUseConnections(lk),
+                             availableConnections(lk),
+                             createdConnections(lk),
+                             refreshingConnections(lk)};
+    stats.waiting = _requests.size();
+    stats.acquired = _counters.acquired;
+    stats.totalWaitTime = _counters.waitTime;
+    stats.totalInUseTime = _counters.inUseTime;
+    return stats;
+}
+
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnection(
     const HostAndPort& hostAndPort, Milliseconds timeout, stdx::unique_lock<stdx::mutex> lk) {
     if (timeout < Milliseconds(0) || timeout > _parent->_options.refreshTimeout) {
         timeout = _parent->_options.refreshTimeout;
     }
 
-    const auto expiration = _parent->_factory->now() + timeout;
+    const auto now = _parent->_factory->now();
+    const auto expiration = now + timeout;
 
     Promise<ConnectionHandle> promise;
     auto future = promise.getFuture();
 
-    _requests.push_back(make_pair(expiration, promise.share()));
+    _requests.push_back(Request{expiration, now, promise.share()});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
+    ++_counters.requested;
+    updateAdaptiveTarget(now);
+
     updateStateInLock();
 
     spawnConnections(lk);
@@ -518,6 +594,13 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
 
     auto conn = takeFromPool(_checkedOutPool, connPtr);
 
+    auto checkOutIter = _checkOutTimes.find(connPtr);
+    if (checkOutIter != _checkOutTimes.end()) {
+        ++_counters.returned;
+        _counters.inUseTime += _parent->_factory->now() - checkOutIter->second;
+        _checkOutTimes.erase(checkOutIter);
+    }
+
     updateStateInLock();
 
     // Users are required to call indicateSuccess() or indicateFailure() before allowing
@@ -677,7 +760,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     for (auto& request : requestsToFail) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 }
 
@@ -719,7 +802,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        const auto requested = _requests.front().requested;
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -728,6 +812,11 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         // check out the connection
         _checkedOutPool[connPtr] = std::move(conn);
 
+        const auto now = _parent->_factory->now();
+        _checkOutTimes[connPtr] = now;
+        ++_counters.acquired;
+        _counters.waitTime += now - requested;
+
         updateStateInLock();
 
         // pass it to the user
@@ -749,11 +838,12 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     _inSpawnConnections = true;
     auto guard = MakeGuard([&] { _inSpawnConnections = false; });
 
-    // We want minConnections <= outstanding requests <= maxConnections
+    // We want minConnections <= outstanding requests <= maxConnections. With adaptive sizing we
+    // also keep the connections we expect to need open ahead of the requests for them.
     auto target = [&] {
-        return std::max(
-            _parent->_options.minConnections,
-            std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
+        const auto wanted = std::max(_requests.size() + _checkedOutPool.size(), _adaptiveTarget);
+        return std::max(_parent->_options.minConnections,
+                        std::min(wanted, _parent->_options.maxConnections));
     };
 
     // While all of our inflight connections are less than our target
@@ -809,7 +899,11 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    // Keeps this pool alive until both locks below are released, if we remove it from '_pools'.
+    std::shared_ptr<SpecificPool> self;
+
+    stdx::lock_guard<stdx::mutex> poolsLk(_parent->_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     // We're racing:
     //
@@ -843,7 +937,13 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
-    _parent->_pools.erase(_hostAndPort);
+    // Someone who looked this pool up before it went idle may still hold it after a new pool for
+    // the same host has replaced it. Only remove the entry if it is still ours.
+    auto iter = _parent->_pools.find(_hostAndPort);
+    if (iter != _parent->_pools.end() && iter->second.get() == this) {
+        self = std::move(iter->second);
+        _parent->_pools.erase(iter);
+    }
 }
 
 template <typename OwnershipPoolType>
@@ -873,16 +973,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.front().first;
+        _requestTimerExpiration = _requests.front().expiration;
 
-        auto timeout = _requests.front().first - _parent->_factory->now();
+        auto timeout = _requests.front().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -893,8 +993,8 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
                 while (_requests.size()) {
                     auto& x = _requests.front();
 
-                    if (x.first <= now) {
-                        auto promise = std::move(x.second);
+                    if (x.expiration <= now) {
+                        auto promise = std::move(x.promise);
                         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
                         _requests.pop_back();
 
@@ -937,5 +1037,36 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
     }
 }
 
+void ConnectionPool::SpecificPool::updateAdaptiveTarget(Date_t now) {
+    if (!_parent->_options.adaptiveSizing)
+        return;
+
+    if (_windowStart == Date_t()) {
+        _windowStart = now;
+        _windowStartCounters = _counters;
+        return;
+    }
+
+    const auto elapsed = now - _windowStart;
+    if (elapsed < kAdaptiveSizingWindow)
+        return;
+
+    const double requestsPerMilli =
+        double(_counters.requested - _windowStartCounters.requested) / elapsed.count();
+
+    auto averageMillis = [](Milliseconds total, size_t count) {
+        return count ? double(total.count()) / count : 0.0;
+    };
+    const double waitMillis = averageMillis(_counters.waitTime - _windowStartCounters.waitTime,
+                                            _counters.acquired - _windowStartCounters.acquired);
+    const double inUseMillis = averageMillis(_counters.inUseTime - _windowStartCounters.inUseTime,
+                                             _counters.returned - _windowStartCounters.returned);
+
+    _adaptiveTarget = static_cast<size_t>(std::ceil(requestsPerMilli * (waitMillis + inUseMillis)));
+
+    _windowStart = now;
+    _windowStartCounters = _counters;
+}
+
 }  // namespace executor
 }  // namespace mongo
@@ -78,6 +78,7 @@ public:
     static const size_t kDefaultMaxConnecting;
     static constexpr Milliseconds kDefaultRefreshRequirement = Milliseconds(60000);  // 1min
     static constexpr Milliseconds kDefaultRefreshTimeout = Milliseconds(20000);      // 20secs
+    static constexpr Milliseconds kAdaptiveSizingWindow = Milliseconds(1000);        // 1sec
 
     static const Status kConnectionStateUnknown;
 
@@ -122,6 +123,27 @@ public:
          */
         Milliseconds hostTimeout = kDefaultHostTimeout;
 
+        /**
+         * If true, each specific pool keeps as many connections open as it expects to need, rather
+         * than opening connections only once requests are waiting for them. The expected number
+         * is the average number of requests in flight to the host over the last
+         * kAdaptiveSizingWindow (Little's law): the observed request rate multiplied by the sum
+         * of the observed wait and in-use times. minConnections and maxConnections still bound the
+         * pool size.
+         */
+        bool adaptiveSizing = false;
+
+        /**
+         * If non-zero, a NetworkInterfaceTL using this pool shares up to this many connections
+         * per host between concurrent requests, instead of giving each request a connection of
+         * its own. Each shared connection carries up to maxInFlightPerMultiplexedConnection
+         * requests at once, matched to their responses by message id; requests beyond that get
+         * connections of their own.
+         */
+        size_t multiplexedConnectionsPerHost = 0;
+
+        size_t maxInFlightPerMultiplexedConnection = 16;
+
         /**
          * An egress tag closer manager which will provide global access to this connection pool.
          * The manager set's tags and potentially drops connections that don't match those tags.
@@ -165,9 +187,11 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards '_pools' only. Each specific pool has a mutex of its own for its connections and
+    // requests, so traffic to different hosts does not contend. When both are needed, this mutex
+    // must be acquired first.
     mutable stdx::mutex _mutex;
-    stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
+    stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
 
     EgressTagCloserManager* _manager;
 };
@@ -44,11 +44,32 @@ ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
 
 ConnectionStatsPer::ConnectionStatsPer() = default;
 
+namespace {
+
+void appendHostStats(const ConnectionStatsPer& hostStats, BSONObjBuilder* hostInfo) {
+    hostInfo->appendNumber("inUse", hostStats.inUse);
+    hostInfo->appendNumber("available", hostStats.available);
+    hostInfo->appendNumber("created", hostStats.created);
+    hostInfo->appendNumber("refreshing", hostStats.refreshing);
+    hostInfo->appendNumber("waiting", hostStats.waiting);
+    hostInfo->appendNumber("acquired", hostStats.acquired);
+    hostInfo->appendNumber("totalWaitTimeMillis",
+                           durationCount<Milliseconds>(hostStats.totalWaitTime));
+    hostInfo->appendNumber("totalInUseTimeMillis",
+                           durationCount<Milliseconds>(hostStats.totalInUseTime));
+}
+
+}  // namespace
+
 ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& other) {
     inUse += other.inUse;
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    waiting += other.waiting;
+    acquired += other.acquired;
+    totalWaitTime += other.totalWaitTime;
+    totalInUseTime += other.totalInUseTime;
 
     return *this;
 }
@@ -85,11 +106,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
-                auto hostStats = host.second;
-                hostInfo.appendNumber("inUse", hostStats.inUse);
-                hostInfo.appendNumber("available", hostStats.available);
-                hostInfo.appendNumber("created", hostStats.created);
-                hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                appendHostStats(host.second, &hostInfo);
             }
         }
     }
@@ -97,11 +114,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
         BSONObjBuilder hostBuilder(result.subobjStart("hosts"));
         for (auto&& host : statsByHost) {
             BSONObjBuilder hostInfo(hostBuilder.subobjStart(host.first.toString()));
-            auto hostStats = host.second;
-            hostInfo.appendNumber("inUse", hostStats.inUse);
-            hostInfo.appendNumber("available", hostStats.available);
-            hostInfo.appendNumber("created", hostStats.created);
-            hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            appendHostStats(host.second, &hostInfo);
         }
     }
 }
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -49,6 +50,14 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // Requests currently waiting for a connection.
+    size_t waiting = 0u;
+
+    // Connections ever handed out, and the total time requests waited for them and held them.
+    size_t acquired = 0u;
+    Milliseconds totalWaitTime{0};
+    Milliseconds totalInUseTime{0};
 };
 
 /**
@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1376,6 +1377,106 @@ TEST_F(ConnectionPoolTest, DropConnectionsByTagInMultipleViaManager) {
     dropConnectionsByTagTest(pool, manager);
 }
 
+/**
+ * Verify that connPoolStats reports how long requests waited for and held connections.
+ */
+TEST_F(ConnectionPoolTest, StatsReportWaitAndInUseTime) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool::ConnectionHandle conn;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn = std::move(swConn.getValue());
+             });
+
+    {
+        ConnectionPoolStats stats;
+        pool.appendConnectionStats(&stats);
+        ASSERT_EQ(1u, stats.statsByHost[HostAndPort()].waiting);
+        ASSERT_EQ(0u, stats.statsByHost[HostAndPort()].acquired);
+    }
+
+    // The request waits 10ms for its connection, then holds it for 20ms.
+    PoolImpl::setNow(now + Milliseconds(10));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn);
+
+    PoolImpl::setNow(now + Milliseconds(30));
+    doneWith(conn);
+    conn.reset();
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    const auto& hostStats = stats.statsByHost[HostAndPort()];
+    ASSERT_EQ(0u, hostStats.waiting);
+    ASSERT_EQ(1u, hostStats.acquired);
+    ASSERT_EQ(Milliseconds(10), hostStats.totalWaitTime);
+    ASSERT_EQ(Milliseconds(20), hostStats.totalInUseTime);
+}
+
+/**
+ * Verify that with adaptive sizing, a pool whose connections were dropped reopens as many
+ * connections as its recent traffic needed, rather than one per waiting request.
+ */
+TEST_F(ConnectionPoolTest, AdaptiveSizingReopensExpectedConnections) {
+    ConnectionPool::Options options;
+    options.adaptiveSizing = true;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    std::vector<ConnectionPool::ConnectionHandle> conns;
+    auto getConnection = [&] {
+        pool.get(HostAndPort(),
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     conns.push_back(std::move(swConn.getValue()));
+                 });
+    };
+    auto returnConnections = [&] {
+        for (auto& conn : conns) {
+            doneWith(conn);
+        }
+        conns.clear();
+    };
+
+    // Keep four requests in flight for a second, each holding its connection for 100ms.
+    for (int round = 0; round < 10; ++round) {
+        PoolImpl::setNow(now + Milliseconds(100 * round));
+        returnConnections();
+        for (int i = 0; i < 4; ++i) {
+            if (round == 0) {
+                ConnectionImpl::pushSetup(Status::OK());
+            }
+            getConnection();
+        }
+        ASSERT_EQ(4u, conns.size());
+    }
+
+    PoolImpl::setNow(now + Milliseconds(1000));
+    returnConnections();
+    pool.dropConnections(HostAndPort());
+    ASSERT_EQ(0u, pool.getNumConnectionsPerHost(HostAndPort()));
+
+    // A single request now reopens all four connections at once.
+    getConnection();
+    ASSERT_EQ(4u, ConnectionImpl::setupQueueDepth());
+
+    for (int i = 0; i < 4; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+    }
+    ASSERT_EQ(1u, conns.size());
+    ASSERT_EQ(4u, pool.getNumConnectionsPerHost(HostAndPort()));
+    returnConnections();
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -45,8 +45,7 @@
 namespace mongo {
 namespace executor {
 
-void NetworkInterfaceIntegrationFixture::startNet(
-    std::unique_ptr<NetworkConnectionHook> connectHook) {
+ConnectionPool::Options NetworkInterfaceIntegrationFixture::makeConnectionPoolOptions() {
     ConnectionPool::Options options;
 #ifdef _WIN32
     // Connections won't queue on widnows, so attempting to open too many connections
@@ -55,8 +54,15 @@ void NetworkInterfaceIntegrationFixture::startNet(
 #else
     options.maxConnections = 256u;
 #endif
-    _net = makeNetworkInterface(
-        "NetworkInterfaceIntegrationFixture", std::move(connectHook), nullptr, std::move(options));
+    return options;
+}
+
+void NetworkInterfaceIntegrationFixture::startNet(
+    std::unique_ptr<NetworkConnectionHook> connectHook) {
+    _net = makeNetworkInterface("NetworkInterfaceIntegrationFixture",
+                                std::move(connectHook),
+                                nullptr,
+                                makeConnectionPoolOptions());
 
     _net->startup();
 }
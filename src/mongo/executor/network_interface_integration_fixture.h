@@ -30,6 +30,7 @@
 #include "mongo/unittest/unittest.h"
 
 #include "mongo/client/connection_string.h"
+#include "mongo/executor/connection_pool.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/executor/task_executor.h"
@@ -100,6 +101,12 @@ public:
                           ErrorCodes::Error reason,
                           Milliseconds timeoutMillis = Minutes(5));
 
+protected:
+    /**
+     * Options for the connection pool of the network interface made by startNet().
+     */
+    virtual ConnectionPool::Options makeConnectionPoolOptions();
+
 private:
     std::unique_ptr<NetworkInterface> _net;
     PseudoRandom* _rng = nullptr;
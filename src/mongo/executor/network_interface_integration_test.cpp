@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/client/connection_string.h"
@@ -305,6 +306,60 @@ TEST_F(NetworkInterfaceTest, StartCommand) {
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+class NetworkInterfaceMultiplexingTest : public NetworkInterfaceTest {
+protected:
+    ConnectionPool::Options makeConnectionPoolOptions() override {
+        auto options = NetworkInterfaceTest::makeConnectionPoolOptions();
+        options.multiplexedConnectionsPerHost = 1;
+        options.maxInFlightPerMultiplexedConnection = 4;
+        return options;
+    }
+};
+
+TEST_F(NetworkInterfaceMultiplexingTest, ConcurrentCommandsGetTheirOwnReplies) {
+    const int kNumCommands = 16;
+
+    std::vector<BSONObj> commandRequests;
+    std::vector<Future<RemoteCommandResponse>> deferreds;
+    for (int i = 0; i < kNumCommands; ++i) {
+        commandRequests.push_back(BSON("echo" << 1 << "i" << i));
+        deferreds.push_back(runCommand(
+            makeCallbackHandle(), makeTestCommand(Milliseconds{30000}, commandRequests.back())));
+    }
+
+    for (int i = 0; i < kNumCommands; ++i) {
+        auto res = std::move(deferreds[i]).get();
+        uassertStatusOK(res.status);
+
+        BSONObjBuilder expectedCommandReply;
+        expectedCommandReply.appendElements(commandRequests[i]);
+        expectedCommandReply << "$db"
+                             << "admin";
+        ASSERT_BSONOBJ_EQ(res.data.getObjectField("echo"), expectedCommandReply.obj());
+    }
+
+    assertNumOps(0u, 0u, 0u, kNumCommands);
+}
+
+TEST_F(NetworkInterfaceMultiplexingTest, TimedOutCommandDoesNotHoldUpLaterOnes) {
+    auto request = makeTestCommand(Milliseconds{100});
+    request.cmdObj = BSON("sleep" << 1 << "lock"
+                                  << "none"
+                                  << "secs"
+                                  << 30);
+    auto result = runCommand(makeCallbackHandle(), request).get();
+    if (pingCommandMissing(result)) {
+        return;
+    }
+    ASSERT_EQ(ErrorCodes::NetworkInterfaceExceededTimeLimit, result.status);
+
+    // The remote is still sleeping on the shared connection, so this only finishes in time on
+    // another one.
+    auto res = runCommand(makeCallbackHandle(), makeTestCommand(Milliseconds{5000})).get();
+    uassertStatusOK(res.status);
+    ASSERT_EQ(res.data.getIntField("ok"), 1);
+}
+
 TEST_F(NetworkInterfaceTest, SetAlarm) {
     // set a first alarm, to execute after "expiration"
     Date_t expiration = net().now() + Milliseconds(100);
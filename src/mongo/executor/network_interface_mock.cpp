@@ -273,6 +273,15 @@ bool NetworkInterfaceMock::hasReadyRequests() {
     return _hasReadyRequests_inlock();
 }
 
+size_t NetworkInterfaceMock::getNumReadyRequests() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_currentlyRunning == kNetworkThread);
+    const Date_t now = _now_inlock();
+    return std::count_if(_unscheduled.begin(), _unscheduled.end(), [&](const NetworkOperation& op) {
+        return op.getNextConsiderationDate() <= now;
+    });
+}
+
 bool NetworkInterfaceMock::_hasReadyRequests_inlock() {
     if (_unscheduled.empty())
         return false;
@@ -173,6 +173,11 @@ public:
      */
     bool hasReadyRequests();
 
+    /**
+     * Returns the number of unscheduled network requests which are ready to be processed.
+     */
+    size_t getNumReadyRequests();
+
     /**
      * Gets the next unscheduled request to process, blocking until one is available.
      *
@@ -32,6 +32,8 @@
 
 #include "mongo/executor/network_interface_tl.h"
 
+#include <algorithm>
+
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/server_options.h"
 #include "mongo/executor/connection_pool_tl.h"
@@ -200,26 +202,22 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     // return on the reactor thread.
     //
     // TODO: get rid of this cruft once we have a connection pool that's executor aware.
-    auto connFuture = _reactor->execute([this, state, request, baton] {
-        return makeReadyFutureWith(
-                   [this, request] { return _pool->get(request.target, request.timeout); })
+    auto connFuture = _reactor->execute([this, state, request] {
+        return makeReadyFutureWith([this, request] { return _acquireConn(request); })
             .tapError([state](Status error) {
                 LOG(2) << "Failed to get connection from pool for request " << state->request.id
                        << ": " << error;
-            })
-            .then([this, baton](ConnectionPool::ConnectionHandle conn) {
-                auto deleter = conn.get_deleter();
-
-                // TODO: drop out this shared_ptr once we have a unique_function capable future
-                return std::make_shared<CommandState::ConnHandle>(
-                    conn.release(), CommandState::Deleter{deleter, _reactor});
             });
     });
 
-    auto remainingWork = [this, state, baton, onFinish](
-        StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) {
-        makeReadyFutureWith(
-            [&] { return _onAcquireConn(state, std::move(*uassertStatusOK(swConn)), baton); })
+    auto remainingWork = [this, state, baton, onFinish](StatusWith<AcquiredConn> swConn) {
+        makeReadyFutureWith([&] {
+            auto acquired = uassertStatusOK(std::move(swConn));
+            if (acquired.multiplexed) {
+                return _onAcquireMultiplexedConn(state, std::move(acquired.multiplexed), baton);
+            }
+            return _onAcquireConn(state, std::move(*acquired.exclusive), baton);
+        })
             .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
                 // The TransportLayer has, for historical reasons returned SocketException for
                 // network errors, but sharding assumes HostUnreachable on network errors.
@@ -247,7 +245,7 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         std::move(connFuture).getAsync([
             baton,
             rw = std::move(remainingWork)
-        ](StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) mutable {
+        ](StatusWith<AcquiredConn> swConn) mutable {
             baton->schedule([ rw = std::move(rw), swConn = std::move(swConn) ]() mutable {
                 std::move(rw)(std::move(swConn));
             });
@@ -255,8 +253,7 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     } else {
         // otherwise we're happy to run inline
         std::move(connFuture)
-            .getAsync([rw = std::move(remainingWork)](
-                StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) mutable {
+            .getAsync([rw = std::move(remainingWork)](StatusWith<AcquiredConn> swConn) mutable {
                 std::move(rw)(std::move(swConn));
             });
     }
@@ -264,6 +261,243 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     return Status::OK();
 }
 
+AsyncDBClient* NetworkInterfaceTL::MultiplexedConnection::client() const {
+    return checked_cast<connection_pool_tl::TLConnection*>(conn.get())->client();
+}
+
+bool NetworkInterfaceTL::_shouldMultiplex(const RemoteCommandRequest& request) const {
+    if (_connPoolOpts.multiplexedConnectionsPerHost == 0) {
+        return false;
+    }
+
+    // The remote works through the requests of a connection one at a time, so a request which
+    // may sit on the remote for long would hold up everything queued behind it. Those without a
+    // deadline could do so for good, as nothing abandons them.
+    if (request.timeout == RemoteCommandRequest::kNoTimeout) {
+        return false;
+    }
+
+    // A getMore on a tailable awaitData cursor may wait for its whole maxTimeMS, and the others
+    // wait for a migration or a routing table refresh to complete.
+    const StringData commandName = request.cmdObj.firstElementFieldName();
+    if (commandName == "getMore"_sd || commandName == "moveChunk"_sd ||
+        commandName == "_configsvrMoveChunk"_sd ||
+        commandName == "_flushRoutingTableCacheUpdates"_sd) {
+        return false;
+    }
+
+    // So does a write waiting for replication.
+    const auto writeConcern = request.cmdObj["writeConcern"];
+    if (writeConcern.type() == Object) {
+        const auto w = writeConcern.Obj()["w"];
+        if (w.type() == String || (w.isNumber() && w.numberLong() > 1)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Future<NetworkInterfaceTL::AcquiredConn> NetworkInterfaceTL::_acquireConn(
+    const RemoteCommandRequest& request) {
+    auto getExclusive = [this, request] {
+        return _pool->get(request.target, request.timeout)
+            .then([this](ConnectionPool::ConnectionHandle conn) {
+                auto deleter = conn.get_deleter();
+
+                AcquiredConn acquired;
+                acquired.exclusive = std::make_shared<CommandState::ConnHandle>(
+                    conn.release(), CommandState::Deleter{deleter, _reactor});
+                return acquired;
+            });
+    };
+
+    if (!_shouldMultiplex(request)) {
+        return getExclusive();
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        auto& host = _multiplexedHosts[request.target];
+
+        std::shared_ptr<MultiplexedConnection> leastLoaded;
+        for (const auto& conn : host.conns) {
+            if (conn->inFlight < _connPoolOpts.maxInFlightPerMultiplexedConnection &&
+                (!leastLoaded || conn->inFlight < leastLoaded->inFlight)) {
+                leastLoaded = conn;
+            }
+        }
+
+        if (leastLoaded) {
+            leastLoaded->inFlight++;
+
+            AcquiredConn acquired;
+            acquired.multiplexed = std::move(leastLoaded);
+            return Future<AcquiredConn>::makeReady(std::move(acquired));
+        }
+
+        if (host.conns.size() + host.connecting >= _connPoolOpts.multiplexedConnectionsPerHost) {
+            // Every shared connection to this host is full, so this request gets one to itself
+            // rather than queueing behind the others.
+            return getExclusive();
+        }
+
+        host.connecting++;
+    }
+
+    auto target = request.target;
+    return _pool->get(request.target, request.timeout)
+        .tapError([this, target](Status) {
+            stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+            auto it = _multiplexedHosts.find(target);
+            invariant(it != _multiplexedHosts.end());
+            if (--it->second.connecting == 0 && it->second.conns.empty()) {
+                _multiplexedHosts.erase(it);
+            }
+        })
+        .then([this, target](ConnectionPool::ConnectionHandle conn) {
+            auto deleter = conn.get_deleter();
+            CommandState::ConnHandle handle(conn.release(),
+                                            CommandState::Deleter{deleter, _reactor});
+
+            auto client = checked_cast<connection_pool_tl::TLConnection*>(handle.get())->client();
+            const bool canMultiplex = client->canMultiplex();
+            if (canMultiplex) {
+                client->enableMultiplexing();
+            }
+
+            AcquiredConn acquired;
+
+            stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+            auto it = _multiplexedHosts.find(target);
+            invariant(it != _multiplexedHosts.end());
+            auto& host = it->second;
+            host.connecting--;
+
+            if (!canMultiplex) {
+                // The remote doesn't speak OP_MSG or the session can't read and write at once.
+                if (host.connecting == 0 && host.conns.empty()) {
+                    _multiplexedHosts.erase(it);
+                }
+                acquired.exclusive = std::make_shared<CommandState::ConnHandle>(std::move(handle));
+                return acquired;
+            }
+
+            acquired.multiplexed =
+                std::make_shared<MultiplexedConnection>(target, std::move(handle));
+            acquired.multiplexed->inFlight = 1;
+            host.conns.push_back(acquired.multiplexed);
+            return acquired;
+        });
+}
+
+void NetworkInterfaceTL::_releaseMultiplexedConn(const std::shared_ptr<CommandState>& state,
+                                                 const Status& status) {
+    const auto& conn = state->multiplexedConn;
+    bool idle;
+    Status finalStatus = Status::OK();
+    std::shared_ptr<AsyncDBClient> clientToCancel;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        invariant(!state->releasedMultiplexedConn);
+        state->releasedMultiplexedConn = true;
+        if (state->abandonedMultiplexedConn) {
+            invariant(conn->abandoned > 0);
+            conn->abandoned--;
+        }
+
+        if (!status.isOK() && conn->status.isOK()) {
+            conn->status = status;
+        }
+
+        invariant(conn->inFlight > 0);
+        idle = --conn->inFlight == 0;
+
+        // Stop handing out a connection which has failed or gone idle, so that idle ones go back
+        // to the pool and are subject to its refresh and expiry.
+        if (idle || !conn->status.isOK()) {
+            _removeMultiplexedConn_inlock(conn);
+        }
+
+        if (idle) {
+            finalStatus = conn->status;
+        } else {
+            clientToCancel = _cancelIfAbandoned_inlock(conn);
+        }
+    }
+
+    if (!idle) {
+        if (clientToCancel) {
+            clientToCancel->cancel();
+        }
+        return;
+    }
+
+    // Nothing else holds a slot on the connection anymore, and it can't be handed out again.
+    if (finalStatus.isOK()) {
+        conn->conn->indicateSuccess();
+    } else {
+        conn->conn->indicateFailure(finalStatus);
+    }
+    conn->conn.reset();
+}
+
+void NetworkInterfaceTL::_removeMultiplexedConn_inlock(
+    const std::shared_ptr<MultiplexedConnection>& conn) {
+    auto hostIt = _multiplexedHosts.find(conn->target);
+    if (hostIt == _multiplexedHosts.end()) {
+        return;
+    }
+
+    auto& conns = hostIt->second.conns;
+    conns.erase(std::remove(conns.begin(), conns.end(), conn), conns.end());
+    if (conns.empty() && hostIt->second.connecting == 0) {
+        _multiplexedHosts.erase(hostIt);
+    }
+}
+
+std::shared_ptr<AsyncDBClient> NetworkInterfaceTL::_cancelIfAbandoned_inlock(
+    const std::shared_ptr<MultiplexedConnection>& conn) {
+    if (conn->canceled || conn->abandoned < conn->inFlight) {
+        return nullptr;
+    }
+
+    // Failing the connection's I/O only fails requests nobody waits on anymore, and then the
+    // connection goes back to the pool as failed, instead of waiting for the remote to finish.
+    LOG(2) << "Canceling shared connection to " << conn->target << " after its "
+           << conn->inFlight << " requests in flight were abandoned";
+    conn->canceled = true;
+    if (conn->status.isOK()) {
+        conn->status = Status(ErrorCodes::CallbackCanceled,
+                              "Requests in flight on a shared connection were abandoned");
+    }
+    return conn->client()->shared_from_this();
+}
+
+void NetworkInterfaceTL::_drainMultiplexedConn(const std::shared_ptr<CommandState>& state) {
+    const auto& conn = state->multiplexedConn;
+    std::shared_ptr<AsyncDBClient> clientToCancel;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        if (state->releasedMultiplexedConn) {
+            return;
+        }
+
+        // The remote runs the requests of a connection one at a time, so those sent after a
+        // request which is stuck would wait behind it. The other requests already in flight may
+        // have been applied, so they are left to finish.
+        state->abandonedMultiplexedConn = true;
+        conn->abandoned++;
+        _removeMultiplexedConn_inlock(conn);
+
+        clientToCancel = _cancelIfAbandoned_inlock(conn);
+    }
+
+    if (clientToCancel) {
+        clientToCancel->cancel();
+    }
+}
+
 // This is only called from within a then() callback on a future, so throwing is equivalent to
 // returning a ready Future with a not-OK status.
 Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
@@ -282,11 +516,45 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
 
     state->conn = std::move(conn);
     auto tlconn = checked_cast<connection_pool_tl::TLConnection*>(state->conn.get());
-    auto client = tlconn->client();
+    return _runCommand(std::move(state), tlconn->client(), baton);
+}
+
+// Same as _onAcquireConn, but for a request holding a slot on a shared connection.
+Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireMultiplexedConn(
+    std::shared_ptr<CommandState> state,
+    std::shared_ptr<MultiplexedConnection> conn,
+    const transport::BatonHandle& baton) {
+    state->multiplexedConn = std::move(conn);
+
+    if (MONGO_FAIL_POINT(networkInterfaceDiscardCommandsAfterAcquireConn)) {
+        _releaseMultiplexedConn(state, Status::OK());
+        return std::move(state->mergedFuture);
+    }
+
+    if (state->done.load()) {
+        _releaseMultiplexedConn(state, Status::OK());
+        uasserted(ErrorCodes::CallbackCanceled, "Command was canceled");
+    }
+
+    auto client = state->multiplexedConn->client();
+    return _runCommand(std::move(state), client, baton);
+}
+
+Future<RemoteCommandResponse> NetworkInterfaceTL::_runCommand(std::shared_ptr<CommandState> state,
+                                                              AsyncDBClient* client,
+                                                              const transport::BatonHandle& baton) {
+    // Requests sharing a connection can't cancel its outstanding I/O or wait on a baton, as that
+    // would affect the others. A canceled or timed out request drops its response and drains the
+    // connection instead.
+    const bool multiplexed = static_cast<bool>(state->multiplexedConn);
 
     if (state->deadline != RemoteCommandRequest::kNoExpirationDate) {
         auto nowVal = now();
         if (nowVal >= state->deadline) {
+            if (multiplexed) {
+                _releaseMultiplexedConn(state, Status::OK());
+            }
+
             auto connDuration = nowVal - state->start;
             uasserted(ErrorCodes::NetworkInterfaceExceededTimeLimit,
                       str::stream() << "Remote command timed out while waiting to get a "
@@ -298,7 +566,7 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
 
         state->timer = _reactor->makeTimer();
         state->timer->waitUntil(state->deadline, baton)
-            .getAsync([this, client, state, baton](Status status) {
+            .getAsync([this, client, state, baton, multiplexed](Status status) {
                 if (status == ErrorCodes::CallbackCanceled) {
                     invariant(state->done.load());
                     return;
@@ -319,18 +587,34 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
                 state->promise.setError(
                     Status(ErrorCodes::NetworkInterfaceExceededTimeLimit, "timed out"));
 
-                client->cancel(baton);
+                if (multiplexed) {
+                    _drainMultiplexedConn(state);
+                } else {
+                    client->cancel(baton);
+                }
             });
     }
 
-    client->runCommandRequest(state->request, baton)
+    client->runCommandRequest(state->request, multiplexed ? nullptr : baton)
+        .tap([this, state, multiplexed](const RemoteCommandResponse&) {
+            // A command error leaves the connection as good as it was for the other requests.
+            if (multiplexed) {
+                _releaseMultiplexedConn(state, Status::OK());
+            }
+        })
+        .tapError([this, state, multiplexed](const Status& status) {
+            if (multiplexed) {
+                _releaseMultiplexedConn(state, status);
+            }
+        })
         .then([this, state](RemoteCommandResponse response) {
             if (state->done.load()) {
                 uasserted(ErrorCodes::CallbackCanceled, "Callback was canceled");
             }
 
             if (_metadataHook && response.status.isOK()) {
-                auto target = state->conn->getHostAndPort().toString();
+                auto target = state->conn ? state->conn->getHostAndPort().toString()
+                                          : state->multiplexedConn->target.toString();
                 response.status =
                     _metadataHook->readReplyMetadata(nullptr, std::move(target), response.metadata);
             }
@@ -339,7 +623,9 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
         })
         .getAsync([this, state, baton](StatusWith<RemoteCommandResponse> swr) {
             _eraseInUseConn(state->cbHandle);
-            if (!swr.isOK()) {
+            if (!state->conn) {
+                // A shared connection has already been released above.
+            } else if (!swr.isOK()) {
                 state->conn->indicateFailure(swr.getStatus());
             } else if (!swr.getValue().isOK()) {
                 state->conn->indicateFailure(swr.getValue().status);
@@ -401,6 +687,8 @@ void NetworkInterfaceTL::cancelCommand(const TaskExecutor::CallbackHandle& cbHan
     if (state->conn) {
         auto client = checked_cast<connection_pool_tl::TLConnection*>(state->conn.get());
         client->client()->cancel(baton);
+    } else if (state->multiplexedConn) {
+        _drainMultiplexedConn(state);
     }
 }
 
@@ -468,6 +756,25 @@ bool NetworkInterfaceTL::onNetworkThread() {
 }
 
 void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexMutex);
+        auto it = _multiplexedHosts.find(hostAndPort);
+        if (it != _multiplexedHosts.end()) {
+            // The shared connections get no new requests, and go back to the pool as failed once
+            // the requests in flight on them finish.
+            for (const auto& conn : it->second.conns) {
+                if (conn->status.isOK()) {
+                    conn->status =
+                        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped");
+                }
+            }
+            it->second.conns.clear();
+            if (it->second.connecting == 0) {
+                _multiplexedHosts.erase(it);
+            }
+        }
+    }
+
     _pool->dropConnections(hostAndPort);
 }
 
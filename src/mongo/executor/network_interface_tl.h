@@ -29,6 +29,7 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
@@ -79,6 +80,8 @@ public:
     void dropConnections(const HostAndPort& hostAndPort) override;
 
 private:
+    struct MultiplexedConnection;
+
     struct CommandState {
         CommandState(RemoteCommandRequest request_, TaskExecutor::CallbackHandle cbHandle_)
             : request(std::move(request_)), cbHandle(std::move(cbHandle_)) {}
@@ -100,17 +103,101 @@ private:
         using ConnHandle = std::unique_ptr<ConnectionPool::ConnectionInterface, Deleter>;
 
         ConnHandle conn;
+        std::shared_ptr<MultiplexedConnection> multiplexedConn;
         std::unique_ptr<transport::ReactorTimer> timer;
 
+        // Guarded by _multiplexMutex. Whether the request timed out or was canceled while it held
+        // a slot on multiplexedConn, and whether it gave that slot back.
+        bool abandonedMultiplexedConn = false;
+        bool releasedMultiplexedConn = false;
+
         AtomicBool done;
         Promise<RemoteCommandResponse> promise;
         Future<RemoteCommandResponse> mergedFuture;
     };
 
+    /**
+     * A pooled connection which requests to its host share, see
+     * ConnectionPool::Options::multiplexedConnectionsPerHost. It goes back to the pool once it has
+     * no requests in flight.
+     */
+    struct MultiplexedConnection {
+        MultiplexedConnection(HostAndPort target_, CommandState::ConnHandle conn_)
+            : target(std::move(target_)), conn(std::move(conn_)) {}
+
+        AsyncDBClient* client() const;
+
+        const HostAndPort target;
+        CommandState::ConnHandle conn;
+
+        // Guarded by _multiplexMutex.
+        size_t inFlight = 0;
+        Status status = Status::OK();
+
+        // Requests in flight whose callers no longer wait on them. The connection is no longer
+        // handed out once there is one, and its I/O is canceled once all of them are.
+        size_t abandoned = 0;
+        bool canceled = false;
+    };
+
+    struct MultiplexedHost {
+        std::vector<std::shared_ptr<MultiplexedConnection>> conns;
+
+        // Connections being acquired from the pool to be shared.
+        size_t connecting = 0;
+    };
+
+    /**
+     * What a request runs on: a slot on a shared connection, or a connection of its own.
+     */
+    struct AcquiredConn {
+        std::shared_ptr<MultiplexedConnection> multiplexed;
+
+        // TODO: drop out this shared_ptr once we have a unique_function capable future
+        std::shared_ptr<CommandState::ConnHandle> exclusive;
+    };
+
     void _eraseInUseConn(const TaskExecutor::CallbackHandle& handle);
+
+    bool _shouldMultiplex(const RemoteCommandRequest& request) const;
+
+    /**
+     * Gets a connection for 'request', sharing one if multiplexing is enabled and a shared
+     * connection to the target has room. Must run on the reactor.
+     */
+    Future<AcquiredConn> _acquireConn(const RemoteCommandRequest& request);
+
+    /**
+     * Gives back the slot of the request of 'state' on its shared connection, once the request
+     * finished with 'status'.
+     */
+    void _releaseMultiplexedConn(const std::shared_ptr<CommandState>& state, const Status& status);
+
+    /**
+     * Stops handing out the shared connection of 'state', whose request timed out or was canceled
+     * while its remote might still be working on it. The requests still in flight on the
+     * connection finish as usual, and the connection goes back to the pool once they have.
+     */
+    void _drainMultiplexedConn(const std::shared_ptr<CommandState>& state);
+    void _removeMultiplexedConn_inlock(const std::shared_ptr<MultiplexedConnection>& conn);
+
+    /**
+     * Returns the client of 'conn' for the caller to cancel its I/O if no caller waits on any of
+     * the requests in flight on it anymore, and marks it failed. Returns nullptr otherwise.
+     */
+    std::shared_ptr<AsyncDBClient> _cancelIfAbandoned_inlock(
+        const std::shared_ptr<MultiplexedConnection>& conn);
+
     Future<RemoteCommandResponse> _onAcquireConn(std::shared_ptr<CommandState> state,
                                                  CommandState::ConnHandle conn,
                                                  const transport::BatonHandle& baton);
+    Future<RemoteCommandResponse> _onAcquireMultiplexedConn(
+        std::shared_ptr<CommandState> state,
+        std::shared_ptr<MultiplexedConnection> conn,
+        const transport::BatonHandle& baton);
+    Future<RemoteCommandResponse> _runCommand(std::shared_ptr<CommandState> state,
+                                              AsyncDBClient* client,
+                                              const transport::BatonHandle& baton);
 
     std::string _instanceName;
     ServiceContext* _svcCtx;
@@ -133,6 +220,9 @@ private:
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::shared_ptr<CommandState>> _inProgress;
     stdx::unordered_set<std::shared_ptr<transport::ReactorTimer>> _inProgressAlarms;
 
+    stdx::mutex _multiplexMutex;
+    stdx::unordered_map<HostAndPort, MultiplexedHost> _multiplexedHosts;
+
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
 };
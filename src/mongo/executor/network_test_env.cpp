@@ -87,6 +87,20 @@ void NetworkTestEnv::onCommandWithMetadata(OnCommandWithMetadataFunction func) {
     _mockNetwork->exitNetwork();
 }
 
+void NetworkTestEnv::waitForReadyRequests(size_t numRequests, Milliseconds timeout) {
+    const Date_t deadline = Date_t::now() + timeout;
+
+    _mockNetwork->enterNetwork();
+    while (_mockNetwork->getNumReadyRequests() < numRequests) {
+        _mockNetwork->exitNetwork();
+        ASSERT_LT(Date_t::now(), deadline) << "timed out waiting for " << numRequests
+                                           << " network requests";
+        sleepmillis(1);
+        _mockNetwork->enterNetwork();
+    }
+    _mockNetwork->exitNetwork();
+}
+
 void NetworkTestEnv::onFindCommand(OnFindCommandFunction func) {
     onCommand([&func](const RemoteCommandRequest& request) -> StatusWith<BSONObj> {
         const auto& resultStatus = func(request);
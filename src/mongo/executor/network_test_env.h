@@ -176,6 +176,12 @@ public:
     void onFindCommand(OnFindCommandFunction func);
     void onFindWithMetadataCommand(OnFindCommandWithMetadataFunction func);
 
+    /**
+     * Blocks until at least 'numRequests' requests are waiting on the network to be answered.
+     * Fails the test if that does not happen within 'timeout'.
+     */
+    void waitForReadyRequests(size_t numRequests, Milliseconds timeout);
+
 private:
     // Task executor used for running asynchronous operations.
     TaskExecutor* _executor;
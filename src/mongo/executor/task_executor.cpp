@@ -39,6 +39,9 @@ TaskExecutor::~TaskExecutor() = default;
 TaskExecutor::CallbackState::CallbackState() = default;
 TaskExecutor::CallbackState::~CallbackState() = default;
 
+TaskExecutor::RemoteCommandBatch::RemoteCommandBatch() = default;
+TaskExecutor::RemoteCommandBatch::~RemoteCommandBatch() = default;
+
 TaskExecutor::CallbackHandle::CallbackHandle() = default;
 TaskExecutor::CallbackHandle::CallbackHandle(std::shared_ptr<CallbackState> callback)
     : _callback(std::move(callback)) {}
@@ -67,6 +70,40 @@ TaskExecutor::RemoteCommandCallbackArgs::RemoteCommandCallbackArgs(
     const ResponseStatus& theResponse)
     : executor(theExecutor), myHandle(theHandle), request(theRequest), response(theResponse) {}
 
+TaskExecutor::RemoteCommandBatchHandle TaskExecutor::makeRemoteCommandBatch() {
+    return nullptr;
+}
+
+StatusWith<TaskExecutor::CallbackHandle> TaskExecutor::scheduleRemoteCommandInBatch(
+    const RemoteCommandRequest& request,
+    const RemoteCommandCallbackFn& cb,
+    const RemoteCommandBatchHandle& batch,
+    const transport::BatonHandle& baton) {
+    return scheduleRemoteCommand(request, cb, baton);
+}
+
+Future<RemoteCommandResponse> TaskExecutor::scheduleRemoteCommandAsFuture(
+    const RemoteCommandRequest& request,
+    CallbackHandle* cbHandle,
+    const RemoteCommandBatchHandle& batch,
+    const transport::BatonHandle& baton) {
+    // The callback has to be copyable, so it shares the promise.
+    auto promise = std::make_shared<Promise<RemoteCommandResponse>>();
+    auto future = promise->getFuture();
+
+    auto swHandle = scheduleRemoteCommandInBatch(
+        request,
+        [promise](const RemoteCommandCallbackArgs& args) { promise->emplaceValue(args.response); },
+        batch,
+        baton);
+    if (!swHandle.isOK()) {
+        return Future<RemoteCommandResponse>::makeReady(swHandle.getStatus());
+    }
+
+    *cbHandle = std::move(swHandle.getValue());
+    return future;
+}
+
 TaskExecutor::CallbackState* TaskExecutor::getCallbackFromHandle(const CallbackHandle& cbHandle) {
     return cbHandle.getCallback();
 }
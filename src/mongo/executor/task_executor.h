@@ -82,7 +82,9 @@ public:
     class CallbackHandle;
     class EventState;
     class EventHandle;
+    class RemoteCommandBatch;
 
+    using RemoteCommandBatchHandle = std::shared_ptr<RemoteCommandBatch>;
     using ResponseStatus = RemoteCommandResponse;
 
     /**
@@ -266,6 +268,39 @@ public:
      */
     virtual void appendConnectionStats(ConnectionPoolStats* stats) const = 0;
 
+    /**
+     * Returns a new batch for scheduleRemoteCommandInBatch(), typically one per scatter-gather
+     * fan-out, or nullptr if this executor delivers each remote command response separately.
+     */
+    virtual RemoteCommandBatchHandle makeRemoteCommandBatch();
+
+    /**
+     * Schedules "cb" like scheduleRemoteCommand(), except that when "batch" is not null, the
+     * response is delivered through it: responses of the batch that arrive while an earlier one is
+     * still waiting to be delivered are run by the same executor task, one after the other, rather
+     * than each getting a task of its own. All the requests of a batch must use the same baton.
+     *
+     * The default implementation ignores "batch".
+     */
+    virtual StatusWith<CallbackHandle> scheduleRemoteCommandInBatch(
+        const RemoteCommandRequest& request,
+        const RemoteCommandCallbackFn& cb,
+        const RemoteCommandBatchHandle& batch,
+        const transport::BatonHandle& baton = nullptr);
+
+    /**
+     * Schedules "request" like scheduleRemoteCommandInBatch() and returns a future for the
+     * response instead of running a callback. The future becomes ready when the callback would
+     * have run, with a response whose status holds any failure to run the command, including
+     * CallbackCanceled. On success, "cbHandle" is set to the handle with which to cancel() or
+     * wait() on the request; otherwise the future holds the scheduling error.
+     */
+    Future<RemoteCommandResponse> scheduleRemoteCommandAsFuture(
+        const RemoteCommandRequest& request,
+        CallbackHandle* cbHandle,
+        const RemoteCommandBatchHandle& batch = nullptr,
+        const transport::BatonHandle& baton = nullptr);
+
 protected:
     // Retrieves the Callback from a given CallbackHandle
     static CallbackState* getCallbackFromHandle(const CallbackHandle& cbHandle);
@@ -283,6 +318,19 @@ protected:
     TaskExecutor();
 };
 
+/**
+ * State shared by the remote commands of a batch. Only the executor that made it interprets it.
+ */
+class TaskExecutor::RemoteCommandBatch {
+    MONGO_DISALLOW_COPYING(RemoteCommandBatch);
+
+public:
+    virtual ~RemoteCommandBatch();
+
+protected:
+    RemoteCommandBatch();
+};
+
 /**
  * Class representing a scheduled callback and providing methods for interacting with it.
  */
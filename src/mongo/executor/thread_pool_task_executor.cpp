@@ -35,6 +35,7 @@
 #include <boost/optional.hpp>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/disallow_copying.h"
@@ -128,6 +129,21 @@ public:
     WorkQueue waiters;
 };
 
+class ThreadPoolTaskExecutor::RemoteCommandBatchState : public TaskExecutor::RemoteCommandBatch {
+    MONGO_DISALLOW_COPYING(RemoteCommandBatchState);
+
+public:
+    RemoteCommandBatchState() = default;
+
+    // All fields guarded by the owning task executor's _mutex.
+
+    // Completed network operations, in _poolInProgressQueue, whose callbacks have yet to run.
+    std::vector<std::shared_ptr<CallbackState>> completed;
+
+    // Whether a task to run the callbacks in "completed" is scheduled or running.
+    bool deliveryScheduled = false;
+};
+
 ThreadPoolTaskExecutor::ThreadPoolTaskExecutor(std::unique_ptr<ThreadPoolInterface> pool,
                                                std::shared_ptr<NetworkInterface> net)
     : _net(std::move(net)), _pool(std::move(pool)) {}
@@ -397,6 +413,19 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
     const RemoteCommandRequest& request,
     const RemoteCommandCallbackFn& cb,
     const transport::BatonHandle& baton) {
+    return scheduleRemoteCommandInBatch(request, cb, nullptr, baton);
+}
+
+TaskExecutor::RemoteCommandBatchHandle ThreadPoolTaskExecutor::makeRemoteCommandBatch() {
+    return std::make_shared<RemoteCommandBatchState>();
+}
+
+StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteCommandInBatch(
+    const RemoteCommandRequest& request,
+    const RemoteCommandCallbackFn& cb,
+    const RemoteCommandBatchHandle& batchHandle,
+    const transport::BatonHandle& baton) {
+    auto batch = checked_pointer_cast<RemoteCommandBatchState>(batchHandle);
     RemoteCommandRequest scheduledRequest = request;
     if (request.timeout == RemoteCommandRequest::kNoTimeout) {
         scheduledRequest.expirationDate = RemoteCommandRequest::kNoExpirationDate;
@@ -422,7 +451,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
     _net->startCommand(
             cbHandle.getValue(),
             scheduledRequest,
-            [this, scheduledRequest, cbState, cb](const ResponseStatus& response) {
+            [this, scheduledRequest, cbState, cb, batch](const ResponseStatus& response) {
                 using std::swap;
                 CallbackFn newCb = [cb, scheduledRequest, response](const CallbackArgs& cbData) {
                     remoteCommandFinished(cbData, cb, scheduledRequest, response);
@@ -435,7 +464,11 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
                        << redact(response.isOK() ? response.toString()
                                                  : response.status.toString());
                 swap(cbState->callback, newCb);
-                scheduleIntoPool_inlock(&_networkInProgressQueue, cbState->iter, std::move(lk));
+                if (batch) {
+                    scheduleIntoBatch_inlock(batch, cbState->iter, std::move(lk));
+                } else {
+                    scheduleIntoPool_inlock(&_networkInProgressQueue, cbState->iter, std::move(lk));
+                }
             },
             baton)
         .transitional_ignore();
@@ -570,6 +603,31 @@ void ThreadPoolTaskExecutor::scheduleIntoPool_inlock(WorkQueue* fromQueue,
     _net->signalWorkAvailable();
 }
 
+void ThreadPoolTaskExecutor::scheduleIntoBatch_inlock(
+    const std::shared_ptr<RemoteCommandBatchState>& batch,
+    const WorkQueue::iterator& iter,
+    stdx::unique_lock<stdx::mutex> lk) {
+    const auto cbState = *iter;
+    _poolInProgressQueue.splice(_poolInProgressQueue.end(), _networkInProgressQueue, iter);
+    batch->completed.push_back(cbState);
+    if (batch->deliveryScheduled) {
+        return;
+    }
+    batch->deliveryScheduled = true;
+
+    lk.unlock();
+
+    if (cbState->baton) {
+        cbState->baton->schedule([this, batch] { runBatch(batch); });
+    } else {
+        const auto status = _pool->schedule([this, batch] { runBatch(batch); });
+        if (status == ErrorCodes::ShutdownInProgress)
+            return;
+        fassert(50866, status);
+    }
+    _net->signalWorkAvailable();
+}
+
 void ThreadPoolTaskExecutor::runCallback(std::shared_ptr<CallbackState> cbStateArg) {
     CallbackHandle cbHandle;
     setCallbackForHandle(&cbHandle, cbStateArg);
@@ -596,6 +654,20 @@ void ThreadPoolTaskExecutor::runCallback(std::shared_ptr<CallbackState> cbStateA
     }
 }
 
+void ThreadPoolTaskExecutor::runBatch(std::shared_ptr<RemoteCommandBatchState> batch) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (!batch->completed.empty()) {
+        std::vector<std::shared_ptr<CallbackState>> completed;
+        completed.swap(batch->completed);
+        lk.unlock();
+        for (auto& cbState : completed) {
+            runCallback(std::move(cbState));
+        }
+        lk.lock();
+    }
+    batch->deliveryScheduled = false;
+}
+
 bool ThreadPoolTaskExecutor::_inShutdown_inlock() const {
     return _state >= joinRequired;
 }
@@ -84,6 +84,12 @@ public:
         const RemoteCommandRequest& request,
         const RemoteCommandCallbackFn& cb,
         const transport::BatonHandle& baton = nullptr) override;
+    RemoteCommandBatchHandle makeRemoteCommandBatch() override;
+    StatusWith<CallbackHandle> scheduleRemoteCommandInBatch(
+        const RemoteCommandRequest& request,
+        const RemoteCommandCallbackFn& cb,
+        const RemoteCommandBatchHandle& batch,
+        const transport::BatonHandle& baton = nullptr) override;
     void cancel(const CallbackHandle& cbHandle) override;
     void wait(const CallbackHandle& cbHandle) override;
 
@@ -97,6 +103,7 @@ public:
 private:
     class CallbackState;
     class EventState;
+    class RemoteCommandBatchState;
     using WorkQueue = stdx::list<std::shared_ptr<CallbackState>>;
     using EventList = stdx::list<std::shared_ptr<EventState>>;
 
@@ -169,11 +176,24 @@ private:
                                  const WorkQueue::iterator& end,
                                  stdx::unique_lock<stdx::mutex> lk);
 
+    /**
+     * Moves the given completed network operation into _poolInProgressQueue and hands it to
+     * "batch", scheduling a task to deliver the batch unless one is already pending.
+     */
+    void scheduleIntoBatch_inlock(const std::shared_ptr<RemoteCommandBatchState>& batch,
+                                  const WorkQueue::iterator& iter,
+                                  stdx::unique_lock<stdx::mutex> lk);
+
     /**
      * Executes the callback specified by "cbState".
      */
     void runCallback(std::shared_ptr<CallbackState> cbState);
 
+    /**
+     * Executes the callbacks handed to "batch", including those handed to it while running.
+     */
+    void runBatch(std::shared_ptr<RemoteCommandBatchState> batch);
+
     bool _inShutdown_inlock() const;
     void _setState_inlock(State newState);
     stdx::unique_lock<stdx::mutex> _join(stdx::unique_lock<stdx::mutex> lk);
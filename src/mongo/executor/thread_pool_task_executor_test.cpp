@@ -117,6 +117,76 @@ TEST_F(ThreadPoolExecutorTest,
     ASSERT_TRUE(sharedCallbackStateDestroyed);
 }
 
+TEST_F(ThreadPoolExecutorTest, RemoteCommandsInBatchFulfillFutures) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    const RemoteCommandRequest request(
+        HostAndPort("localhost", 27017), "mydb", BSON("ping" << 1), nullptr);
+    auto batch = executor.makeRemoteCommandBatch();
+    ASSERT(batch);
+
+    TaskExecutor::CallbackHandle cbHandle1;
+    TaskExecutor::CallbackHandle cbHandle2;
+    auto future1 = executor.scheduleRemoteCommandAsFuture(request, &cbHandle1, batch);
+    auto future2 = executor.scheduleRemoteCommandAsFuture(request, &cbHandle2, batch);
+    ASSERT(cbHandle1.isValid());
+    ASSERT(cbHandle2.isValid());
+
+    // Both responses arrive before the batch's delivery task can run, so it delivers both.
+    net->enterNetwork();
+    net->scheduleSuccessfulResponse(BSON("ok" << 1 << "n" << 1));
+    net->scheduleSuccessfulResponse(BSON("ok" << 1 << "n" << 2));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    auto response1 = std::move(future1).get();
+    auto response2 = std::move(future2).get();
+    ASSERT_OK(response1.status);
+    ASSERT_OK(response2.status);
+    ASSERT_EQ(response1.data["n"].numberInt(), 1);
+    ASSERT_EQ(response2.data["n"].numberInt(), 2);
+
+    executor.wait(cbHandle1);
+    executor.wait(cbHandle2);
+}
+
+TEST_F(ThreadPoolExecutorTest, CanceledRemoteCommandInBatchFulfillsFutureWithCallbackCanceled) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    const RemoteCommandRequest request(
+        HostAndPort("localhost", 27017), "mydb", BSON("ping" << 1), nullptr);
+    auto batch = executor.makeRemoteCommandBatch();
+
+    TaskExecutor::CallbackHandle cbHandle;
+    auto future = executor.scheduleRemoteCommandAsFuture(request, &cbHandle, batch);
+    executor.cancel(cbHandle);
+
+    net->enterNetwork();
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ASSERT_EQ(std::move(future).get().status, ErrorCodes::CallbackCanceled);
+}
+
+TEST_F(ThreadPoolExecutorTest, ScheduleRemoteCommandAsFutureReturnsSchedulingError) {
+    auto& executor = getExecutor();
+    launchExecutorThread();
+    executor.shutdown();
+
+    const RemoteCommandRequest request(
+        HostAndPort("localhost", 27017), "mydb", BSON("ping" << 1), nullptr);
+    TaskExecutor::CallbackHandle cbHandle;
+    auto future = executor.scheduleRemoteCommandAsFuture(request, &cbHandle);
+    ASSERT_FALSE(cbHandle.isValid());
+    ASSERT_EQ(std::move(future).getNoThrow().getStatus(), ErrorCodes::ShutdownInProgress);
+
+    joinExecutorThread();
+}
+
 TEST_F(ThreadPoolExecutorTest, ShutdownAndScheduleRaceDoesNotCrash) {
     // This is a regression test for SERVER-23686. It works by scheduling a work item in the
     // ThreadPoolTaskExecutor that blocks waiting to be signaled by this thread. Once that work item
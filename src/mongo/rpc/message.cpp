@@ -30,7 +30,10 @@
 
 #include "mongo/rpc/message.h"
 
+#include <cstring>
+
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -42,4 +45,44 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+std::vector<ConstDataRange> Message::gatherBuffers() const {
+    std::vector<ConstDataRange> buffers;
+    buffers.reserve(_splices.size() * 2 + 1);
+
+    // The buffer holds everything but the spliced bytes, so its own length is the message length
+    // less the total size of the splices.
+    int bufferLen = size();
+    for (const auto& splice : _splices) {
+        bufferLen -= splice.data.length();
+    }
+
+    int pos = 0;
+    for (const auto& splice : _splices) {
+        invariant(splice.offset >= pos && splice.offset <= bufferLen);
+        if (splice.offset > pos) {
+            buffers.emplace_back(_buf.get() + pos, splice.offset - pos);
+        }
+        buffers.push_back(splice.data);
+        pos = splice.offset;
+    }
+    if (bufferLen > pos) {
+        buffers.emplace_back(_buf.get() + pos, bufferLen - pos);
+    }
+
+    return buffers;
+}
+
+void Message::_flattenSlow() const {
+    auto buffers = gatherBuffers();
+    auto flat = SharedBuffer::allocatePooled(size());
+    char* out = flat.get();
+    for (const auto& buffer : buffers) {
+        memcpy(out, buffer.data(), buffer.length());
+        out += buffer.length();
+    }
+
+    _buf = std::move(flat);
+    _splices.clear();
+}
+
 }  // namespace mongo
@@ -29,12 +29,15 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
+#include "mongo/base/data_range.h"
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -395,9 +398,29 @@ inline int ConstView::dataLen() const {
 
 class Message {
 public:
+    /**
+     * Bytes sent as part of a message without having been copied into its buffer. They go
+     * immediately before byte 'offset' of the buffer, after any earlier splice at that offset.
+     */
+    struct Splice {
+        int offset;
+        ConstSharedBuffer owner;  // Keeps 'data' alive.
+        ConstDataRange data;
+    };
+
     Message() = default;
     explicit Message(SharedBuffer data) : _buf(std::move(data)) {}
 
+    /**
+     * Constructs a message whose contents are spread over 'data' and 'splices'. The length in the
+     * header of 'data' must already count the spliced bytes.
+     */
+    Message(SharedBuffer data, std::vector<Splice> splices)
+        : _buf(std::move(data)), _splices(std::move(splices)) {}
+
+    /**
+     * The header is always in the message's own buffer, so this never copies spliced bytes in.
+     */
     MsgData::View header() const {
         verify(!empty());
         return _buf.get();
@@ -409,9 +432,24 @@ public:
 
     MsgData::View singleData() const {
         massert(13273, "single data buffer expected", _buf);
+        _flatten();
         return header();
     }
 
+    /**
+     * Returns true if some of this message's bytes live outside of its buffer. Accessing the
+     * message's data through singleData(), buf() or sharedBuffer() first copies them in.
+     */
+    bool hasSplices() const {
+        return !_splices.empty();
+    }
+
+    /**
+     * Returns the message's bytes in order as a list of ranges suitable for gather I/O. The ranges
+     * stay valid as long as this message does.
+     */
+    std::vector<ConstDataRange> gatherBuffers() const;
+
     bool empty() const {
         return !_buf;
     }
@@ -429,6 +467,7 @@ public:
 
     void reset() {
         _buf = {};
+        _splices.clear();
     }
 
     // use to set first buffer if empty
@@ -451,23 +490,38 @@ public:
     }
 
     char* buf() {
+        _flatten();
         return _buf.get();
     }
 
     const char* buf() const {
+        _flatten();
         return _buf.get();
     }
 
     SharedBuffer sharedBuffer() {
+        _flatten();
         return _buf;
     }
 
     ConstSharedBuffer sharedBuffer() const {
+        _flatten();
         return _buf;
     }
 
 private:
-    SharedBuffer _buf;
+    /**
+     * Copies any spliced bytes into a single buffer holding the whole message. This is logically
+     * const: the message's contents don't change, only where they are stored.
+     */
+    void _flatten() const {
+        if (!_splices.empty())
+            _flattenSlow();
+    }
+    void _flattenSlow() const;
+
+    mutable SharedBuffer _buf;
+    mutable std::vector<Splice> _splices;
 };
 
 /**
@@ -40,12 +40,13 @@
 #include "mongo/rpc/object_check.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/hex.h"
+#include "mongo/util/itoa.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 namespace {
 
-auto kAllSupportedFlags = OpMsg::kChecksumPresent | OpMsg::kMoreToCome;
+auto kAllSupportedFlags = OpMsg::kChecksumPresent | OpMsg::kMoreToCome | OpMsg::kExhaustAllowed;
 
 bool containsUnknownRequiredFlags(uint32_t flags) {
     const uint32_t kRequiredFlagMask = 0xffff;  // Low 2 bytes are required, high 2 are optional.
@@ -63,8 +64,8 @@ uint32_t OpMsg::flags(const Message& message) {
     if (message.operation() != dbMsg)
         return 0;  // Other command protocols are the same as no flags set.
 
-    return BufReader(message.singleData().data(), message.dataSize())
-        .read<LittleEndian<uint32_t>>();
+    // The flags always precede any spliced bytes, so read them without flattening the message.
+    return BufReader(message.header().data(), message.dataSize()).read<LittleEndian<uint32_t>>();
 }
 
 void OpMsg::replaceFlags(Message* message, uint32_t flags) {
@@ -72,7 +73,7 @@ void OpMsg::replaceFlags(Message* message, uint32_t flags) {
     invariant(message->operation() == dbMsg);
     invariant(message->dataSize() >= static_cast<int>(sizeof(uint32_t)));
 
-    DataView(message->singleData().data()).write<LittleEndian<uint32_t>>(flags);
+    DataView(message->header().data()).write<LittleEndian<uint32_t>>(flags);
 }
 
 OpMsg OpMsg::parse(const Message& message) try {
@@ -219,6 +220,138 @@ BSONObjBuilder OpMsgBuilder::resumeBody() {
     return BSONObjBuilder(BSONObjBuilder::ResumeBuildingTag(), _buf, _bodyStart);
 }
 
+size_t OpMsgBuilder::beginSplicedArray(std::vector<int> enclosingOffsets) {
+    invariant(_state == kBody);
+    invariant(!enclosingOffsets.empty());
+    for (auto offset : enclosingOffsets) {
+        invariant(offset > _bodyStart);
+    }
+
+    _splicedArrays.emplace_back();
+    _splicedArrays.back().enclosingOffsets = std::move(enclosingOffsets);
+    return _splicedArrays.size() - 1;
+}
+
+void OpMsgBuilder::spliceArrayElement(size_t array, int offset, uint32_t index, BSONObj obj) {
+    invariant(array < _splicedArrays.size());
+    invariant(!_splicedArrays[array].ended);
+    invariant(obj.isOwned());
+    invariant(_splicedElements.empty() || _splicedElements.back().offset <= offset);
+    _splicedElements.push_back({array, offset, index, std::move(obj)});
+}
+
+void OpMsgBuilder::endSplicedArray(size_t array) {
+    invariant(array < _splicedArrays.size());
+    auto& spliced = _splicedArrays[array];
+    invariant(!spliced.ended);
+
+    spliced.ended = true;
+    for (auto offset : spliced.enclosingOffsets) {
+        spliced.enclosingSizes.push_back(
+            ConstDataView(_buf.buf() + offset).read<LittleEndian<int32_t>>());
+    }
+}
+
+void OpMsgBuilder::abandonSplicedArray(size_t array) {
+    invariant(array < _splicedArrays.size());
+    _splicedElements.erase(std::remove_if(_splicedElements.begin(),
+                                          _splicedElements.end(),
+                                          [&](const SplicedElement& element) {
+                                              return element.array == array;
+                                          }),
+                           _splicedElements.end());
+}
+
+bool OpMsgBuilder::isSplicedArrayIntact(const SplicedArray& array) const {
+    if (!array.ended)
+        return false;
+
+    const int bodyEnd = _buf.len();
+    for (size_t i = 0; i < array.enclosingOffsets.size(); i++) {
+        const auto offset = array.enclosingOffsets[i];
+        if (offset + int(sizeof(int32_t)) > bodyEnd)
+            return false;
+        const auto size = ConstDataView(_buf.buf() + offset).read<LittleEndian<int32_t>>();
+        if (size != array.enclosingSizes[i] || offset + size > bodyEnd)
+            return false;
+    }
+    return true;
+}
+
+Message OpMsgBuilder::finishWithSplices() {
+    // Work out which spliced elements still belong in the body, and how much each of the objects
+    // enclosing them grows.
+    std::vector<bool> intact;
+    for (const auto& array : _splicedArrays) {
+        intact.push_back(isSplicedArrayIntact(array));
+    }
+
+    std::vector<const SplicedElement*> insertions;
+    std::vector<int32_t> growth(_splicedArrays.size(), 0);
+    int headerBytes = 0;
+    int splicedBytes = 0;
+    for (const auto& element : _splicedElements) {
+        if (!intact[element.array])
+            continue;
+
+        const auto& array = _splicedArrays[element.array];
+        const auto arrayStart = array.enclosingOffsets.front();
+        const auto arrayEnd = arrayStart + array.enclosingSizes.front();
+        if (element.offset <= arrayStart || element.offset >= arrayEnd)
+            continue;
+
+        insertions.push_back(&element);
+        const int elementHeaderBytes = 1 + StringData(ItoA(element.index)).size() + 1;
+        headerBytes += elementHeaderBytes;
+        splicedBytes += element.obj.objsize();
+        growth[element.array] += elementHeaderBytes + element.obj.objsize();
+    }
+
+    if (insertions.empty())
+        return Message(_buf.release());
+
+    const auto grow = [this](int offset, int32_t bytes) {
+        DataView view(_buf.buf() + offset);
+        view.write<LittleEndian<int32_t>>(view.read<LittleEndian<int32_t>>() + bytes);
+    };
+    for (size_t i = 0; i < _splicedArrays.size(); i++) {
+        if (!growth[i])
+            continue;
+        for (auto offset : _splicedArrays[i].enclosingOffsets) {
+            grow(offset, growth[i]);
+        }
+    }
+    grow(_bodyStart, headerBytes + splicedBytes);
+
+    // Copy the buffer, writing the type and field name of each spliced element in front of where
+    // its document goes. The documents themselves are only referenced.
+    const int bufLen = _buf.len();
+    auto out = SharedBuffer::allocatePooled(bufLen + headerBytes);
+    std::vector<Message::Splice> splices;
+    splices.reserve(insertions.size());
+
+    int in = 0;
+    int pos = 0;
+    for (auto element : insertions) {
+        memcpy(out.get() + pos, _buf.buf() + in, element->offset - in);
+        pos += element->offset - in;
+        in = element->offset;
+
+        out.get()[pos++] = static_cast<char>(Object);
+        ItoA fieldName(element->index);
+        StringData(fieldName).copyTo(out.get() + pos, true);
+        pos += StringData(fieldName).size() + 1;
+
+        splices.push_back({pos,
+                           element->obj.sharedBuffer(),
+                           ConstDataRange(element->obj.objdata(), element->obj.objsize())});
+    }
+    memcpy(out.get() + pos, _buf.buf() + in, bufLen - in);
+
+    MSGHEADER::View(out.get()).setMessageLength(bufLen + headerBytes + splicedBytes);
+    return Message(std::move(out), std::move(splices));
+}
+
 AtomicBool OpMsgBuilder::disableDupeFieldCheck_forTest{false};
 
 Message OpMsgBuilder::finish() {
@@ -244,6 +377,9 @@ Message OpMsgBuilder::finish() {
     // header.setRequestMsgId(...); // These are currently filled in by the networking layer.
     // header.setResponseToMsgId(...);
     header.setOpCode(dbMsg);
+    if (!_splicedElements.empty()) {
+        return finishWithSplices();
+    }
     return Message(_buf.release());
 }
 
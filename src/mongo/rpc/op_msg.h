@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/rpc/message.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -46,6 +47,7 @@ struct OpMsg {
 
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
+    static constexpr uint32_t kExhaustAllowed = 1 << 16;
 
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
@@ -161,7 +163,10 @@ class OpMsgBuilder {
     MONGO_DISALLOW_COPYING(OpMsgBuilder);
 
 public:
-    OpMsgBuilder() {
+    OpMsgBuilder() : _buf(0) {
+        // Replies are usually sent and released soon after they are built, so their buffers are
+        // worth reusing.
+        _buf.useSharedBuffer(SharedBuffer::allocatePooled(SharedBufferPool::kMinSizeClassBytes));
         skipHeaderAndFlags();
     }
 
@@ -194,6 +199,55 @@ public:
         resumeBody().appendElements(body);
     }
 
+    /**
+     * Returns the body as built so far, without any spliced elements. Only legal once a body has
+     * been started and while no builder returned by beginBody() or resumeBody() is open. The
+     * returned object is only valid until this builder is next modified.
+     */
+    BSONObj peekBody() const {
+        invariant(_state == kBody);
+        return BSONObj(_buf.buf() + _bodyStart);
+    }
+
+    /**
+     * Returns true if 'bob' is building the top level of this message's body.
+     */
+    bool isBodyBuilder(const BSONObjBuilder& bob) const {
+        return _state == kBody && &bob.bb() == &_buf && bob.offset() == size_t(_bodyStart);
+    }
+
+    /**
+     * Splicing sends large owned documents as elements of an array in the body without copying
+     * them into the message buffer. finish() inserts them into the message it returns, which sends
+     * them straight from their own buffers. Until then the body reads as if the spliced elements
+     * weren't there, so it stays valid BSON while it is being built.
+     *
+     * These may be called while a builder returned by beginBody() or resumeBody() is still open.
+     *
+     * beginSplicedArray() starts splicing into an array. 'enclosingOffsets' are the buffer offsets
+     * of the size fields of the array and of each object between it and the body, innermost
+     * first. The returned id is passed to the other splicing methods.
+     */
+    size_t beginSplicedArray(std::vector<int> enclosingOffsets);
+
+    /**
+     * Splices 'obj', which must be owned, in as element number 'index' of the array, immediately
+     * before the byte at buffer offset 'offset'.
+     */
+    void spliceArrayElement(size_t array, int offset, uint32_t index, BSONObj obj);
+
+    /**
+     * Called once the array and every object enclosing it have been completed. Splices into
+     * arrays that are never ended are dropped, as are splices into arrays that have been cut
+     * back out of the body by the time finish() is called.
+     */
+    void endSplicedArray(size_t array);
+
+    /**
+     * Drops everything spliced into the array.
+     */
+    void abandonSplicedArray(size_t array);
+
     /**
      * Finish building and return a Message ready to give to the networking layer for transmission.
      * It is illegal to call any methods on this object after calling this.
@@ -211,6 +265,8 @@ public:
         _bodyStart = 0;
         _state = kEmpty;
         _openBuilder = false;
+        _splicedArrays.clear();
+        _splicedElements.clear();
     }
 
     /**
@@ -230,8 +286,29 @@ private:
         kDone,
     };
 
+    struct SplicedArray {
+        std::vector<int> enclosingOffsets;
+        std::vector<int32_t> enclosingSizes;  // Filled in by endSplicedArray().
+        bool ended = false;
+    };
+
+    struct SplicedElement {
+        size_t array;
+        int offset;
+        uint32_t index;
+        BSONObj obj;
+    };
+
     void finishDocumentStream(DocSequenceBuilder* docSequenceBuilder);
 
+    /**
+     * Returns true if the array and all of its enclosing objects still have the sizes recorded by
+     * endSplicedArray(), that is, nothing has cut them out of the body since.
+     */
+    bool isSplicedArrayIntact(const SplicedArray& array) const;
+
+    Message finishWithSplices();
+
     void skipHeaderAndFlags() {
         _buf.skip(sizeof(MSGHEADER::Layout));  // This is filled in by finish().
         _buf.appendNum(uint32_t(0));           // flags (currently always 0).
@@ -242,6 +319,8 @@ private:
     int _bodyStart = 0;
     State _state = kEmpty;
     bool _openBuilder = false;
+    std::vector<SplicedArray> _splicedArrays;
+    std::vector<SplicedElement> _splicedElements;
 };
 
 /**
@@ -71,6 +71,9 @@ public:
         _builder.resumeBody().appendElements(metadata);
         return *this;
     }
+    OpMsgBuilder* getOpMsgBuilder() override {
+        return &_builder;
+    }
     rpc::Protocol getProtocol() const override {
         return rpc::Protocol::kOpMsg;
     }
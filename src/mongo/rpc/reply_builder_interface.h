@@ -39,6 +39,7 @@ namespace mongo {
 class BSONObj;
 class BSONObjBuilder;
 class Message;
+class OpMsgBuilder;
 
 namespace rpc {
 
@@ -64,6 +65,14 @@ public:
 
     virtual ReplyBuilderInterface& setMetadata(const BSONObj& metadata) = 0;
 
+    /**
+     * Returns the OpMsgBuilder the reply is built in, or nullptr if this builder does not produce
+     * OP_MSG replies.
+     */
+    virtual OpMsgBuilder* getOpMsgBuilder() {
+        return nullptr;
+    }
+
     /**
      * Sets the reply for this command. If an engaged StatusWith<BSONObj> is passed, the command
      * reply will be set to the contained BSONObj, augmented with the element {ok, 1.0} if it
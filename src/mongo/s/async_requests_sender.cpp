@@ -64,11 +64,13 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
                                          Shard::RetryPolicy retryPolicy)
     : _opCtx(opCtx),
       _executor(executor),
+      _batch(executor->makeRemoteCommandBatch()),
       _baton(opCtx),
       _db(dbName.toString()),
       _readPreference(readPreference),
       _retryPolicy(retryPolicy) {
     for (const auto& request : requests) {
+        _remotesToSchedule.push_back(_remotes.size());
         _remotes.emplace_back(request.shardId, request.cmdObj);
     }
 
@@ -117,9 +119,26 @@ void AsyncRequestsSender::stopRetrying() {
     _stopRetrying = true;
 }
 
+void AsyncRequestsSender::addRequest(const Request& request) {
+    const size_t remoteIndex = _remotes.size();
+    _remotes.emplace_back(request.shardId, request.cmdObj);
+
+    if (_stopRetrying) {
+        _remotes.back().swResponse = !_interruptStatus.isOK()
+            ? _interruptStatus
+            : Status(ErrorCodes::CallbackCanceled,
+                     str::stream() << "Request to shard " << request.shardId
+                                   << " was not sent because the requests were stopped");
+        _remotesWithResponse.push_back(remoteIndex);
+        return;
+    }
+
+    _remotesToSchedule.push_back(remoteIndex);
+    _scheduleRequests();
+}
+
 bool AsyncRequestsSender::done() {
-    return std::all_of(
-        _remotes.begin(), _remotes.end(), [](const RemoteData& remote) { return remote.done; });
+    return _numRemotesDone == _remotes.size();
 }
 
 void AsyncRequestsSender::_cancelPendingRequests() {
@@ -145,84 +164,103 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
 
     // Check if any remote is ready.
     invariant(!_remotes.empty());
-    for (auto& remote : _remotes) {
-        if (remote.swResponse && !remote.done) {
-            remote.done = true;
-            if (remote.swResponse->isOK()) {
-                invariant(remote.shardHostAndPort);
-                return Response(std::move(remote.shardId),
-                                std::move(remote.swResponse->getValue()),
-                                std::move(*remote.shardHostAndPort));
-            } else {
-                // If _interruptStatus is set, promote CallbackCanceled errors to it.
-                if (!_interruptStatus.isOK() &&
-                    ErrorCodes::CallbackCanceled == remote.swResponse->getStatus().code()) {
-                    remote.swResponse = _interruptStatus;
-                }
-                return Response(std::move(remote.shardId),
-                                std::move(remote.swResponse->getStatus()),
-                                std::move(remote.shardHostAndPort));
-            }
-        }
+    if (_remotesWithResponse.empty()) {
+        return boost::none;
     }
-    // No remotes were ready.
-    return boost::none;
+
+    const size_t i = _remotesWithResponse.front();
+    _remotesWithResponse.pop_front();
+
+    auto& remote = _remotes[i];
+    invariant(remote.swResponse && !remote.done);
+    remote.done = true;
+    ++_numRemotesDone;
+
+    if (remote.swResponse->isOK()) {
+        invariant(remote.shardHostAndPort);
+        Response response(std::move(remote.shardId),
+                          std::move(remote.swResponse->getValue()),
+                          std::move(*remote.shardHostAndPort));
+        response.requestIndex = i;
+        return response;
+    }
+
+    // If _interruptStatus is set, promote CallbackCanceled errors to it.
+    if (!_interruptStatus.isOK() &&
+        ErrorCodes::CallbackCanceled == remote.swResponse->getStatus().code()) {
+        remote.swResponse = _interruptStatus;
+    }
+    Response response(std::move(remote.shardId),
+                      std::move(remote.swResponse->getStatus()),
+                      std::move(remote.shardHostAndPort));
+    response.requestIndex = i;
+    return response;
 }
 
 void AsyncRequestsSender::_scheduleRequests() {
     invariant(!_stopRetrying);
-    // Schedule remote work on hosts for which we have not sent a request or need to retry.
-    for (size_t i = 0; i < _remotes.size(); ++i) {
-        auto& remote = _remotes[i];
 
-        // First check if the remote had a retriable error, and if so, clear its response field so
-        // it will be retried.
-        if (remote.swResponse && !remote.done) {
-            // We check both the response status and command status for a retriable error.
-            Status status = remote.swResponse->getStatus();
-            if (status.isOK()) {
-                status = getStatusFromCommandResult(remote.swResponse->getValue().data);
-            }
+    // First check if the remotes which have a response had a retriable error, and if so, clear
+    // their response field so they will be retried.
+    for (auto it = _remotesWithResponse.begin(); it != _remotesWithResponse.end();) {
+        auto& remote = _remotes[*it];
 
-            if (!status.isOK()) {
-                // There was an error with either the response or the command.
-                auto shard = remote.getShard();
-                if (!shard) {
-                    remote.swResponse =
-                        Status(ErrorCodes::ShardNotFound,
-                               str::stream() << "Could not find shard " << remote.shardId);
-                } else {
-                    if (remote.shardHostAndPort) {
-                        shard->updateReplSetMonitor(*remote.shardHostAndPort, status);
-                    }
-                    if (shard->isRetriableError(status.code(), _retryPolicy) &&
-                        remote.retryCount < kMaxNumFailedHostRetryAttempts) {
-                        LOG(1) << "Command to remote " << remote.shardId << " at host "
-                               << *remote.shardHostAndPort
-                               << " failed with retriable error and will be retried "
-                               << causedBy(redact(status));
-                        ++remote.retryCount;
-                        remote.swResponse.reset();
-                    }
+        // We check both the response status and command status for a retriable error.
+        Status status = remote.swResponse->getStatus();
+        if (status.isOK()) {
+            status = getStatusFromCommandResult(remote.swResponse->getValue().data);
+        }
+
+        if (!status.isOK()) {
+            // There was an error with either the response or the command.
+            auto shard = remote.getShard();
+            if (!shard) {
+                remote.swResponse = Status(ErrorCodes::ShardNotFound,
+                                           str::stream() << "Could not find shard "
+                                                         << remote.shardId);
+            } else {
+                if (remote.shardHostAndPort) {
+                    shard->updateReplSetMonitor(*remote.shardHostAndPort, status);
+                }
+                if (shard->isRetriableError(status.code(), _retryPolicy) &&
+                    remote.retryCount < kMaxNumFailedHostRetryAttempts) {
+                    LOG(1) << "Command to remote " << remote.shardId << " at host "
+                           << *remote.shardHostAndPort
+                           << " failed with retriable error and will be retried "
+                           << causedBy(redact(status));
+                    ++remote.retryCount;
+                    remote.swResponse.reset();
+                    _remotesToSchedule.push_back(*it);
+                    it = _remotesWithResponse.erase(it);
+                    continue;
                 }
             }
         }
 
-        // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
-            auto scheduleStatus = _scheduleRequest(i);
-            if (!scheduleStatus.isOK()) {
-                remote.swResponse = std::move(scheduleStatus);
+        ++it;
+    }
 
-                if (_baton) {
-                    _batonRequests++;
-                    _baton->schedule([this] { _batonRequests--; });
-                }
+    // Schedule remote work on hosts for which we have not sent a request or need to retry.
+    std::vector<size_t> remotesToSchedule;
+    remotesToSchedule.swap(_remotesToSchedule);
+
+    for (const size_t i : remotesToSchedule) {
+        auto& remote = _remotes[i];
+        invariant(!remote.swResponse && !remote.cbHandle.isValid());
 
-                // Push a noop response to the queue to indicate that a remote is ready for
-                // re-processing due to failure.
-                _responseQueue.push(boost::none);
+        auto scheduleStatus = _scheduleRequest(i);
+        if (!scheduleStatus.isOK()) {
+            remote.swResponse = std::move(scheduleStatus);
+            _remotesWithResponse.push_back(i);
+
+            if (_baton) {
+                _batonRequests++;
+                _baton->schedule([this] { _batonRequests--; });
             }
+
+            // Push a noop response to the queue to indicate that a remote is ready for
+            // re-processing due to failure.
+            _responseQueue.push(boost::none);
         }
     }
 }
@@ -241,22 +279,26 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
     executor::RemoteCommandRequest request(
         *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
 
-    auto callbackStatus = _executor->scheduleRemoteCommand(
-        request,
-        [remoteIndex, this](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+    executor::TaskExecutor::CallbackHandle cbHandle;
+    auto response = _executor->scheduleRemoteCommandAsFuture(request, &cbHandle, _batch, _baton);
+    if (!cbHandle.isValid()) {
+        return response.getNoThrow().getStatus();
+    }
+
+    std::move(response).getAsync(
+        [remoteIndex, this](StatusWith<executor::RemoteCommandResponse> swResponse) {
             if (_baton) {
                 _batonRequests++;
                 _baton->schedule([this] { _batonRequests--; });
             }
 
-            _responseQueue.push(Job{cbData, remoteIndex});
-        },
-        _baton);
-    if (!callbackStatus.isOK()) {
-        return callbackStatus.getStatus();
-    }
+            _responseQueue.push(Job{swResponse.isOK()
+                                        ? std::move(swResponse.getValue())
+                                        : executor::RemoteCommandResponse(swResponse.getStatus()),
+                                    remoteIndex});
+        });
 
-    remote.cbHandle = callbackStatus.getValue();
+    remote.cbHandle = std::move(cbHandle);
     return Status::OK();
 }
 
@@ -290,11 +332,12 @@ void AsyncRequestsSender::_makeProgress(OperationContext* opCtx) {
     remote.cbHandle = executor::TaskExecutor::CallbackHandle();
 
     // Store the response or error.
-    if (job->cbData.response.status.isOK()) {
-        remote.swResponse = std::move(job->cbData.response);
+    if (job->response.status.isOK()) {
+        remote.swResponse = std::move(job->response);
     } else {
-        remote.swResponse = std::move(job->cbData.response.status);
+        remote.swResponse = std::move(job->response.status);
     }
+    _remotesWithResponse.push_back(job->remoteIndex);
 }
 
 AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -114,6 +115,11 @@ public:
         // The exact host on which the remote command was run. Is unset if the shard could not be
         // found or no shard hosts matching the readPreference could be found.
         boost::optional<HostAndPort> shardHostAndPort;
+
+        // The position of the request among all the requests given to the ARS, first through the
+        // constructor and then through addRequest(). Tells apart the responses of several requests
+        // to the same shard.
+        size_t requestIndex = 0;
     };
 
     /**
@@ -150,6 +156,15 @@ public:
      */
     Response next();
 
+    /**
+     * Adds a request to those being run by this ARS and schedules it immediately. Its response is
+     * returned by next() like the responses of the requests given at construction.
+     *
+     * If stopRetrying() has been called or the operation was interrupted, the request is not sent
+     * and its response is an error.
+     */
+    void addRequest(const Request& request);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -208,7 +223,7 @@ private:
      * off thread, and this wraps up the arguments for that call.
      */
     struct Job {
-        executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
+        executor::RemoteCommandResponse response;
         size_t remoteIndex;
     };
 
@@ -259,8 +274,8 @@ private:
     boost::optional<Response> _ready();
 
     /**
-     * For each remote that had a response, checks if it had a retriable error, and clears its
-     * response if so.
+     * For each remote that had a response which was not returned yet, checks if it had a
+     * retriable error, and clears its response if so.
      *
      * For each remote without a response or pending request, schedules the remote request.
      *
@@ -290,6 +305,10 @@ private:
     OperationContext* _opCtx;
 
     executor::TaskExecutor* _executor;
+
+    // Delivers the responses of the requests together when they arrive together.
+    executor::TaskExecutor::RemoteCommandBatchHandle _batch;
+
     BatonDetacher _baton;
     size_t _batonRequests = 0;
 
@@ -317,6 +336,17 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteData> _remotes;
 
+    // Indexes in '_remotes' of the remotes which have neither a response nor a pending request, so
+    // that scheduling does not need to go over every remote of a long stream of requests.
+    std::vector<size_t> _remotesToSchedule;
+
+    // Indexes in '_remotes' of the remotes which have a response which was not returned yet, in
+    // the order in which the responses were received.
+    std::deque<size_t> _remotesWithResponse;
+
+    // The number of remotes whose response was returned.
+    size_t _numRemotesDone = 0;
+
     // Thread safe queue which collects responses from the task executor for execution in next()
     //
     // The queue supports unset jobs for a signal to wake up and check for failure
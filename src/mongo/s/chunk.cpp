@@ -55,6 +55,8 @@ int64_t mkDataWritten() {
 
 }  // namespace
 
+constexpr Seconds ChunkInfo::kWriteRateWindow;
+
 ChunkInfo::ChunkInfo(const ChunkType& from)
     : _range(from.getMin(), from.getMax()),
       _shardId(from.getShard()),
@@ -120,6 +122,37 @@ bool ChunkInfo::shouldSplit(uint64_t desiredChunkSize, bool minIsInf, bool maxIs
     return _dataWritten >= splitThreshold / Chunk::kSplitTestFactor;
 }
 
+double ChunkInfo::addWrite(Date_t now, bool* startedWindow) {
+    const long long windowMillis = durationCount<Milliseconds>(kWriteRateWindow);
+    const long long nowMillis = now.toMillisSinceEpoch();
+
+    // Only the write which moves the window start forward rolls the counts over
+    long long windowStart = _writeWindowStartMillis.load();
+    *startedWindow = nowMillis - windowStart >= windowMillis &&
+        _writeWindowStartMillis.compareAndSwap(windowStart, nowMillis) == windowStart;
+    if (*startedWindow) {
+        const long long previousWrites = _writesInWindow.swap(0);
+        _writesInPreviousWindow.store(nowMillis - windowStart < 2 * windowMillis ? previousWrites
+                                                                                  : 0);
+    }
+
+    const long long writes = _writesInWindow.addAndFetch(1);
+    windowStart = _writeWindowStartMillis.load();
+
+    // Approximates a window ending at 'now' by taking the writes of the previous window as spread
+    // evenly over it
+    const long long elapsedMillis = std::min(std::max(nowMillis - windowStart, 0LL), windowMillis);
+    const double previousWrites = static_cast<double>(_writesInPreviousWindow.load()) *
+        (windowMillis - elapsedMillis) / windowMillis;
+
+    return (previousWrites + writes) * 1000 / windowMillis;
+}
+
+void ChunkInfo::clearWrites() {
+    _writesInWindow.store(0);
+    _writesInPreviousWindow.store(0);
+}
+
 std::string ChunkInfo::toString() const {
     return str::stream() << ChunkType::shard() << ": " << _shardId << ", " << ChunkType::lastmod()
                          << ": " << _lastmod.toString() << ", " << _range.toString();
@@ -28,9 +28,11 @@
 
 #pragma once
 
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -41,6 +43,9 @@ class BSONObj;
  */
 class ChunkInfo {
 public:
+    // Length of the windows over which the writes to a chunk are counted to estimate its rate
+    static constexpr Seconds kWriteRateWindow{10};
+
     explicit ChunkInfo(const ChunkType& from);
 
     const BSONObj& getMin() const {
@@ -85,6 +90,15 @@ public:
 
     bool shouldSplit(uint64_t desiredChunkSize, bool minIsInf, bool maxIsInf) const;
 
+    /**
+     * Counts a write to this chunk at 'now' and returns the estimated number of writes per second
+     * it received over the last kWriteRateWindow. Sets 'startedWindow' to whether the write was
+     * the first of a new window, which is the case for at most one write per window. Safe to call
+     * concurrently.
+     */
+    double addWrite(Date_t now, bool* startedWindow);
+    void clearWrites();
+
     /**
      * Marks this chunk as jumbo. Only moves from false to true once and is used by the balancer.
      */
@@ -105,6 +119,12 @@ private:
 
     // Statistics for the approximate data written to this chunk
     mutable uint64_t _dataWritten;
+
+    // Statistics for the rate of writes to this chunk: the start of the current window in
+    // milliseconds since the epoch, and the number of writes in the current and previous windows
+    AtomicInt64 _writeWindowStartMillis{0};
+    AtomicInt64 _writesInWindow{0};
+    AtomicInt64 _writesInPreviousWindow{0};
 };
 
 class Chunk {
@@ -171,6 +191,16 @@ public:
         return _chunkInfo.shouldSplit(desiredChunkSize, minIsInf, maxIsInf);
     }
 
+    /**
+     * Count writes to this chunk and estimate their rate, see ChunkInfo::addWrite.
+     */
+    double addWrite(Date_t now, bool* startedWindow) {
+        return _chunkInfo.addWrite(now, startedWindow);
+    }
+    void clearWrites() {
+        _chunkInfo.clearWrites();
+    }
+
     /**
      * Marks this chunk as jumbo. Only moves from false to true once and is used by the balancer.
      */
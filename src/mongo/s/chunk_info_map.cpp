@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_info_map.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr size_t ChunkInfoMap::kMaxBlockSize;
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator++() {
+    if (++_index == (*_blocks)[_block]->size()) {
+        ++_block;
+        _index = 0;
+    }
+    return *this;
+}
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator--() {
+    if (_index == 0) {
+        --_block;
+        _index = (*_blocks)[_block]->size();
+    }
+    --_index;
+    return *this;
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const std::string& key) const {
+    const auto blockIt = std::lower_bound(
+        _blocks.begin(), _blocks.end(), key, [](const auto& block, const std::string& k) {
+            return block->back().first < k;
+        });
+    if (blockIt == _blocks.end()) {
+        return end();
+    }
+
+    const Block& block = **blockIt;
+    const auto it =
+        std::lower_bound(block.begin(), block.end(), key, [](const auto& entry, const auto& k) {
+            return entry.first < k;
+        });
+    return const_iterator(&_blocks, blockIt - _blocks.begin(), it - block.begin());
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const std::string& key) const {
+    const auto blockIt = std::upper_bound(
+        _blocks.begin(), _blocks.end(), key, [](const std::string& k, const auto& block) {
+            return k < block->back().first;
+        });
+    if (blockIt == _blocks.end()) {
+        return end();
+    }
+
+    const Block& block = **blockIt;
+    const auto it =
+        std::upper_bound(block.begin(), block.end(), key, [](const auto& k, const auto& entry) {
+            return k < entry.first;
+        });
+    return const_iterator(&_blocks, blockIt - _blocks.begin(), it - block.begin());
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::find(const std::string& key) const {
+    const auto it = lower_bound(key);
+    return (it != end() && it->first == key) ? it : end();
+}
+
+void ChunkInfoMap::insert(value_type entry) {
+    if (_blocks.empty()) {
+        _blocks.push_back(std::make_shared<Block>(1, std::move(entry)));
+        _size = 1;
+        return;
+    }
+
+    // Insert into the first block whose last key is not less than the new key or, if there is no
+    // such block, at the end of the last block.
+    const auto it = lower_bound(entry.first);
+    const size_t blockIndex = (it == end()) ? _blocks.size() - 1 : it._block;
+    const size_t index = (it == end()) ? _blocks.back()->size() : it._index;
+
+    Block& block = _mutableBlock(blockIndex);
+    invariant(index == block.size() || block[index].first != entry.first);
+    block.insert(block.begin() + index, std::move(entry));
+    ++_size;
+
+    if (block.size() > kMaxBlockSize) {
+        const auto middle = block.begin() + block.size() / 2;
+        auto upperHalf = std::make_shared<Block>(std::make_move_iterator(middle),
+                                                 std::make_move_iterator(block.end()));
+        block.erase(middle, block.end());
+        _blocks.insert(_blocks.begin() + blockIndex + 1, std::move(upperHalf));
+    }
+}
+
+void ChunkInfoMap::erase(const_iterator first, const_iterator last) {
+    if (first == last) {
+        return;
+    }
+    invariant(first._blocks == &_blocks && last._blocks == &_blocks);
+
+    // Blocks which lose all their entries are dropped without being cloned.
+    for (size_t blockIndex = first._block; blockIndex <= last._block; ++blockIndex) {
+        if (blockIndex == _blocks.size()) {
+            break;
+        }
+
+        const size_t blockSize = _blocks[blockIndex]->size();
+        const size_t from = (blockIndex == first._block) ? first._index : 0;
+        const size_t to = (blockIndex == last._block) ? last._index : blockSize;
+        if (from == to) {
+            continue;
+        }
+
+        _size -= to - from;
+        if (from == 0 && to == blockSize) {
+            _blocks[blockIndex].reset();
+        } else {
+            Block& block = _mutableBlock(blockIndex);
+            block.erase(block.begin() + from, block.begin() + to);
+        }
+    }
+
+    _blocks.erase(std::remove(_blocks.begin(), _blocks.end(), nullptr), _blocks.end());
+
+    // Only the blocks on either side of the erased range may have shrunk.
+    if (first._block > 0) {
+        _mergeIfSmall(first._block - 1);
+    }
+    _mergeIfSmall(first._block);
+}
+
+ChunkInfoMap::Block& ChunkInfoMap::_mutableBlock(size_t blockIndex) {
+    auto& block = _blocks[blockIndex];
+    if (block.use_count() > 1) {
+        block = std::make_shared<Block>(*block);
+    }
+    return *block;
+}
+
+void ChunkInfoMap::_mergeIfSmall(size_t blockIndex) {
+    if (blockIndex + 1 >= _blocks.size() ||
+        _blocks[blockIndex]->size() + _blocks[blockIndex + 1]->size() > kMaxBlockSize / 2) {
+        return;
+    }
+
+    const auto& next = _blocks[blockIndex + 1];
+    Block& block = _mutableBlock(blockIndex);
+    block.insert(block.end(), next->begin(), next->end());
+    _blocks.erase(_blocks.begin() + blockIndex + 1);
+}
+
+}  // namespace mongo
@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/s/chunk.h"
+
+namespace mongo {
+
+/**
+ * Ordered map from the max key string of each chunk to an entry describing the chunk, which
+ * provides the subset of the std::map interface used by the routing table.
+ *
+ * The entries are kept in sorted blocks of bounded size, which are shared between copies of the
+ * map and only cloned when a copy modifies them. Copying the map and applying a few changes to the
+ * copy, which is what an incremental routing table refresh does, therefore costs time proportional
+ * to the number of blocks and changes instead of the number of chunks.
+ */
+class ChunkInfoMap {
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+
+private:
+    using Block = std::vector<value_type>;
+    using BlockVector = std::vector<std::shared_ptr<Block>>;
+
+public:
+    // Blocks are split in two when they grow beyond this many entries.
+    static constexpr size_t kMaxBlockSize = 256;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return (*(*_blocks)[_block])[_index];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        const_iterator& operator--();
+        const_iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _block == other._block && _index == other._index;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const BlockVector* blocks, size_t block, size_t index)
+            : _blocks(blocks), _block(block), _index(index) {}
+
+        const BlockVector* _blocks = nullptr;
+        size_t _block = 0;
+        size_t _index = 0;
+    };
+
+    const_iterator begin() const {
+        return const_iterator(&_blocks, 0, 0);
+    }
+    const_iterator end() const {
+        return const_iterator(&_blocks, _blocks.size(), 0);
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    size_t size() const {
+        return _size;
+    }
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const_iterator lower_bound(const std::string& key) const;
+    const_iterator upper_bound(const std::string& key) const;
+    const_iterator find(const std::string& key) const;
+
+    /**
+     * Inserts 'entry', whose key must not already be in the map. Invalidates all iterators.
+     */
+    void insert(value_type entry);
+
+    /**
+     * Removes the entries in the range [first, last) of this map. Invalidates all iterators.
+     */
+    void erase(const_iterator first, const_iterator last);
+
+private:
+    /**
+     * Returns the block at 'blockIndex' for modification, cloning it first if another map shares
+     * it.
+     */
+    Block& _mutableBlock(size_t blockIndex);
+
+    /**
+     * Merges the blocks at 'blockIndex' and 'blockIndex + 1', if both exist and are small enough
+     * together that repeated erasures do not leave behind many nearly empty blocks.
+     */
+    void _mergeIfSmall(size_t blockIndex);
+
+    // None of the blocks is empty, and the last key of each block is less than the first key of
+    // the next.
+    BlockVector _blocks;
+
+    size_t _size = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <map>
+
+#include "mongo/platform/random.h"
+#include "mongo/s/chunk_info_map.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+using ReferenceMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+
+std::string makeKey(int i) {
+    // Pad the keys so that they sort in numeric order.
+    return str::stream() << std::string(8 - std::to_string(i).size(), '0') << i;
+}
+
+ChunkInfoMap::value_type makeEntry(int i) {
+    const ChunkType chunk(kNss,
+                          ChunkRange(BSON("x" << i - 1), BSON("x" << i)),
+                          ChunkVersion(i + 1, 0, OID::gen()),
+                          ShardId("shard0"));
+    return {makeKey(i), std::make_shared<ChunkInfo>(chunk)};
+}
+
+void assertMapsEqual(const ReferenceMap& expected, const ChunkInfoMap& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    ASSERT_EQ(expected.empty(), actual.empty());
+    ASSERT_EQ(static_cast<ptrdiff_t>(expected.size()),
+              std::distance(actual.begin(), actual.end()));
+
+    auto expectedIt = expected.begin();
+    for (auto it = actual.begin(); it != actual.end(); ++it, ++expectedIt) {
+        ASSERT_EQ(expectedIt->first, it->first);
+        ASSERT_EQ(expectedIt->second, it->second);
+    }
+
+    // Iterating backwards visits the same entries.
+    auto expectedReverseIt = expected.rbegin();
+    for (auto it = actual.end(); it != actual.begin(); ++expectedReverseIt) {
+        --it;
+        ASSERT_EQ(expectedReverseIt->first, it->first);
+    }
+}
+
+void assertBoundsEqual(const ReferenceMap& expected, const ChunkInfoMap& actual, int i) {
+    const auto key = makeKey(i);
+    const auto expectedLower = expected.lower_bound(key);
+    const auto actualLower = actual.lower_bound(key);
+    ASSERT_EQ(expectedLower == expected.end(), actualLower == actual.end());
+    if (expectedLower != expected.end()) {
+        ASSERT_EQ(expectedLower->first, actualLower->first);
+    }
+
+    const auto expectedUpper = expected.upper_bound(key);
+    const auto actualUpper = actual.upper_bound(key);
+    ASSERT_EQ(expectedUpper == expected.end(), actualUpper == actual.end());
+    if (expectedUpper != expected.end()) {
+        ASSERT_EQ(expectedUpper->first, actualUpper->first);
+    }
+
+    ASSERT_EQ(expected.count(key) == 1, actual.find(key) != actual.end());
+}
+
+TEST(ChunkInfoMapTest, EmptyMap) {
+    ChunkInfoMap map;
+    ASSERT(map.empty());
+    ASSERT(map.begin() == map.end());
+    ASSERT(map.upper_bound(makeKey(1)) == map.end());
+    ASSERT(map.lower_bound(makeKey(1)) == map.end());
+    map.erase(map.begin(), map.end());
+    ASSERT_EQ(0U, map.size());
+}
+
+TEST(ChunkInfoMapTest, InsertsInAnyOrderAndSplitsBlocks) {
+    ReferenceMap expected;
+    ChunkInfoMap map;
+    const int kNumEntries = 10 * ChunkInfoMap::kMaxBlockSize;
+    for (int i = 0; i < kNumEntries; ++i) {
+        // Visit the keys in a scattered order.
+        auto entry = makeEntry((i * 7919) % kNumEntries);
+        expected.insert(entry);
+        map.insert(entry);
+    }
+    assertMapsEqual(expected, map);
+
+    for (int i = -1; i <= kNumEntries; ++i) {
+        assertBoundsEqual(expected, map, i);
+    }
+}
+
+TEST(ChunkInfoMapTest, ErasesRangesWithinAndAcrossBlocks) {
+    ReferenceMap expected;
+    ChunkInfoMap map;
+    const int kNumEntries = 10 * ChunkInfoMap::kMaxBlockSize;
+    for (int i = 0; i < kNumEntries; ++i) {
+        auto entry = makeEntry(i);
+        expected.insert(entry);
+        map.insert(entry);
+    }
+
+    for (auto&& range : std::vector<std::pair<int, int>>{
+             {5, 6}, {10, 20}, {100, 1000}, {0, 3}, {kNumEntries - 10, kNumEntries}}) {
+        expected.erase(expected.lower_bound(makeKey(range.first)),
+                       expected.lower_bound(makeKey(range.second)));
+        map.erase(map.lower_bound(makeKey(range.first)), map.lower_bound(makeKey(range.second)));
+        assertMapsEqual(expected, map);
+    }
+
+    map.erase(map.begin(), map.end());
+    ASSERT(map.empty());
+}
+
+TEST(ChunkInfoMapTest, ModifyingACopyDoesNotAffectTheOriginal) {
+    ReferenceMap expected;
+    ChunkInfoMap original;
+    const int kNumEntries = 4 * ChunkInfoMap::kMaxBlockSize;
+    for (int i = 0; i < kNumEntries; i += 2) {
+        auto entry = makeEntry(i);
+        expected.insert(entry);
+        original.insert(entry);
+    }
+
+    auto copy = original;
+    copy.erase(copy.lower_bound(makeKey(10)), copy.lower_bound(makeKey(500)));
+    for (int i = 1; i < kNumEntries; i += 2) {
+        copy.insert(makeEntry(i));
+    }
+
+    assertMapsEqual(expected, original);
+    ASSERT_NOT_EQUALS(original.size(), copy.size());
+}
+
+TEST(ChunkInfoMapTest, RandomizedOperationsMatchStdMap) {
+    PseudoRandom random(12345);
+    ReferenceMap expected;
+    ChunkInfoMap map;
+    std::vector<ChunkInfoMap> snapshots;
+    std::vector<ReferenceMap> expectedSnapshots;
+
+    const int kKeySpace = 5000;
+    for (int round = 0; round < 2000; ++round) {
+        const int first = random.nextInt32(kKeySpace);
+        const int last = first + random.nextInt32(50);
+
+        // Replace a random range of entries with a single one, like a routing table refresh.
+        expected.erase(expected.upper_bound(makeKey(first)), expected.upper_bound(makeKey(last)));
+        map.erase(map.upper_bound(makeKey(first)), map.upper_bound(makeKey(last)));
+
+        for (int i = 0; i < random.nextInt32(20); ++i) {
+            const int key = random.nextInt32(kKeySpace);
+            if (expected.count(makeKey(key)) == 0) {
+                auto entry = makeEntry(key);
+                expected.insert(entry);
+                map.insert(entry);
+            }
+        }
+
+        if (round % 100 == 0) {
+            snapshots.push_back(map);
+            expectedSnapshots.push_back(expected);
+        }
+        assertBoundsEqual(expected, map, random.nextInt32(kKeySpace));
+    }
+
+    assertMapsEqual(expected, map);
+    for (size_t i = 0; i < snapshots.size(); ++i) {
+        assertMapsEqual(expectedSnapshots[i], snapshots[i]);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
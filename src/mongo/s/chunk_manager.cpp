@@ -74,6 +74,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
                                          ChunkInfoMap chunkMap,
+                                         ShardVersionMap shardVersions,
                                          ChunkVersion collectionVersion)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
@@ -83,8 +84,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
-      _shardVersions(
-          _constructShardVersionMap(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _shardVersions(std::move(shardVersions)),
       _collectionVersion(collectionVersion) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
@@ -107,6 +107,51 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<boost::optional<Chunk>> ChunkManager::findIntersectingChunksWithSimpleCollation(
+    const std::vector<BSONObj>& shardKeys) const {
+    const auto& chunkMap = _rt->getChunkMap();
+
+    std::vector<std::pair<std::string, size_t>> sortedKeys;
+    sortedKeys.reserve(shardKeys.size());
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        if (!shardKeys[i].isEmpty()) {
+            sortedKeys.emplace_back(_rt->_extractKeyString(shardKeys[i]), i);
+        }
+    }
+
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+
+    std::vector<boost::optional<Chunk>> chunks(shardKeys.size());
+    if (sortedKeys.empty()) {
+        return chunks;
+    }
+
+    // The chunk containing a key is the first one whose max sorts after it. Since the keys are
+    // visited in order, the chunk for each key is found by stepping forward from the chunk of the
+    // previous one, and only keys which are further away than a few chunks need a binary search.
+    const size_t kMaxSteps = 8;
+
+    auto it = chunkMap.upper_bound(sortedKeys.front().first);
+    for (const auto& sortedKey : sortedKeys) {
+        const auto& keyString = sortedKey.first;
+        for (size_t steps = 0; it != chunkMap.end() && it->first <= keyString; ++it, ++steps) {
+            if (steps == kMaxSteps) {
+                it = chunkMap.upper_bound(keyString);
+                break;
+            }
+        }
+
+        const auto& shardKey = shardKeys[sortedKey.second];
+        uassert(ErrorCodes::ShardKeyNotFound,
+                str::stream() << "Cannot target single shard using key " << shardKey,
+                it != chunkMap.end() && it->second->containsKey(shardKey));
+
+        chunks[sortedKey.second].emplace(*(it->second), _clusterTime);
+    }
+
+    return chunks;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
@@ -377,7 +422,7 @@ ChunkVersion RoutingTableHistory::getVersion(const ShardId& shardName) const {
         return ChunkVersion(0, 0, _collectionVersion.epoch());
     }
 
-    return it->second;
+    return it->second.shardVersion;
 }
 
 std::string RoutingTableHistory::toString() const {
@@ -391,7 +436,7 @@ std::string RoutingTableHistory::toString() const {
 
     sb << "Shard versions:\n";
     for (const auto& entry : _shardVersions) {
-        sb << "\t" << entry.first << ": " << entry.second.toString() << '\n';
+        sb << "\t" << entry.first << ": " << entry.second.shardVersion.toString() << '\n';
     }
 
     return sb.str();
@@ -414,16 +459,18 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
         if (shardVersionIt == shardVersions.end()) {
             shardVersionIt = shardVersions
                                  .emplace(firstChunkInRange->getShardIdAt(boost::none),
-                                          ChunkVersion(0, 0, epoch))
+                                          ShardVersionTargetingInfo(epoch))
                                  .first;
         }
 
-        auto& maxShardVersion = shardVersionIt->second;
+        auto& maxShardVersion = shardVersionIt->second.shardVersion;
+        auto& numChunks = shardVersionIt->second.numChunks;
 
         current = std::find_if(
             current,
             chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
+            [&firstChunkInRange, &maxShardVersion, &numChunks](
+                const ChunkInfoMap::value_type& chunkMapEntry) {
                 const auto& currentChunk = chunkMapEntry.second;
 
                 if (currentChunk->getShardIdAt(boost::none) !=
@@ -433,6 +480,7 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
                 if (currentChunk->getLastmod() > maxShardVersion)
                     maxShardVersion = currentChunk->getLastmod();
 
+                ++numChunks;
                 return false;
             });
 
@@ -499,15 +547,59 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
                                std::move(defaultCollator),
                                std::move(unique),
                                {},
+                               {},
                                {0, 0, epoch})
         .makeUpdated(chunks);
 }
 
+void RoutingTableHistory::_checkNoGapsAroundChunk(const ChunkInfoMap& chunkMap,
+                                                  ChunkInfoMap::const_iterator it) {
+    const auto& chunk = it->second;
+
+    if (it == chunkMap.begin()) {
+        checkAllElementsAreOfType(MinKey, chunk->getMin());
+    } else {
+        const auto& prevChunk = std::prev(it)->second;
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Gap or an overlap between ranges "
+                              << ChunkRange(chunk->getMin(), chunk->getMax()).toString()
+                              << " and "
+                              << prevChunk->getMax(),
+                SimpleBSONObjComparator::kInstance.evaluate(prevChunk->getMax() ==
+                                                            chunk->getMin()));
+    }
+
+    if (std::next(it) == chunkMap.end()) {
+        checkAllElementsAreOfType(MaxKey, chunk->getMax());
+    } else {
+        const auto& nextChunk = std::next(it)->second;
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Gap or an overlap between ranges "
+                              << ChunkRange(chunk->getMin(), chunk->getMax()).toString()
+                              << " and "
+                              << nextChunk->getMin(),
+                SimpleBSONObjComparator::kInstance.evaluate(chunk->getMax() ==
+                                                            nextChunk->getMin()));
+    }
+}
+
 std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
+
+    // Copying the chunk map shares its storage with this routing table, so only the parts of it
+    // which the changes touch are actually copied.
     auto chunkMap = _chunkMap;
+    auto shardVersions = _shardVersions;
+
+    // The shards which lost their highest versioned chunk but not all of their chunks, and whose
+    // shard version therefore needs to be recomputed, unless they received a newer chunk.
+    std::set<ShardId> shardsWithStaleVersion;
+
+    // The keys of the chunks inserted, whose neighbors must be checked for gaps afterwards.
+    std::vector<std::string> insertedKeys;
+    insertedKeys.reserve(changedChunks.size());
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -534,11 +626,36 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         // not overlap max
         const auto high = chunkMap.upper_bound(chunkMaxKeyString);
 
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
+        // Account for the chunks which overlap the chunk we got from the persistent store on the
+        // shards which own them, and then erase them from the map
+        for (auto it = low; it != high; ++it) {
+            const auto& shardId = it->second->getShardIdAt(boost::none);
+            auto shardVersionIt = shardVersions.find(shardId);
+            invariant(shardVersionIt != shardVersions.end());
+
+            auto& info = shardVersionIt->second;
+            if (--info.numChunks == 0) {
+                shardVersions.erase(shardVersionIt);
+                shardsWithStaleVersion.erase(shardId);
+            } else if (it->second->getLastmod() == info.shardVersion) {
+                shardsWithStaleVersion.insert(shardId);
+            }
+        }
         chunkMap.erase(low, high);
 
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, std::make_shared<ChunkInfo>(chunk)));
+        // Insert only the chunk itself. Since chunks come in sorted order, it has the highest
+        // version of any chunk on its shard.
+        auto chunkInfo = std::make_shared<ChunkInfo>(chunk);
+        const auto& shardId = chunkInfo->getShardIdAt(boost::none);
+        auto& info =
+            shardVersions.emplace(shardId, ShardVersionTargetingInfo(chunkVersion.epoch()))
+                .first->second;
+        info.shardVersion = chunkVersion;
+        ++info.numChunks;
+        shardsWithStaleVersion.erase(shardId);
+
+        chunkMap.insert(std::make_pair(chunkMaxKeyString, std::move(chunkInfo)));
+        insertedKeys.push_back(chunkMaxKeyString);
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -552,6 +669,22 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    if (shardsWithStaleVersion.empty()) {
+        // The chunks which were not changed were contiguous before, so any gap or overlap must be
+        // next to one of the changed chunks which are still in the map.
+        for (const auto& key : insertedKeys) {
+            const auto it = chunkMap.find(key);
+            if (it != chunkMap.end()) {
+                _checkNoGapsAroundChunk(chunkMap, it);
+            }
+        }
+    } else {
+        // Chunk histories which are valid never take away the highest versioned chunk of a shard
+        // without giving it a newer one, but fall back to a full pass if that happens.
+        shardVersions = _constructShardVersionMap(
+            collectionVersion.epoch(), chunkMap, _shardKeyOrdering);
+    }
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -559,6 +692,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
                                 CollatorInterface::cloneCollator(getDefaultCollator()),
                                 isUnique(),
                                 std::move(chunkMap),
+                                std::move(shardVersions),
                                 collectionVersion));
 }
 
@@ -37,6 +37,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_info_map.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -49,11 +50,18 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+struct ShardVersionTargetingInfo {
+    explicit ShardVersionTargetingInfo(const OID& epoch) : shardVersion(0, 0, epoch) {}
 
-// Map from a shard is to the max chunk version on that shard
-using ShardVersionMap = std::map<ShardId, ChunkVersion>;
+    // Max chunk version on the shard
+    ChunkVersion shardVersion;
+
+    // Number of chunks on the shard
+    size_t numChunks = 0;
+};
+
+// Map from a shard id to the max chunk version and number of chunks on that shard
+using ShardVersionMap = std::map<ShardId, ShardVersionTargetingInfo>;
 
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
@@ -153,12 +161,20 @@ private:
                                                      const ChunkInfoMap& chunkMap,
                                                      Ordering shardKeyOrdering);
 
+    /**
+     * Checks that the chunk at 'it' starts where the previous chunk in 'chunkMap' ends and ends
+     * where the next one starts, or at MinKey and MaxKey respectively if there are none.
+     */
+    static void _checkNoGapsAroundChunk(const ChunkInfoMap& chunkMap,
+                                        ChunkInfoMap::const_iterator it);
+
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
                         ChunkInfoMap chunkMap,
+                        ShardVersionMap shardVersions,
                         ChunkVersion collectionVersion);
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
@@ -188,8 +204,8 @@ private:
     // ranges must cover the complete space from [MinKey, MaxKey).
     const ChunkInfoMap _chunkMap;
 
-    // Map from shard id to the maximum chunk version for that shard. If a shard contains no
-    // chunks, it won't be present in this map.
+    // Map from shard id to the maximum chunk version and number of chunks for that shard. If a
+    // shard contains no chunks, it won't be present in this map.
     const ShardVersionMap _shardVersions;
 
     // Max version across all chunks
@@ -349,6 +365,18 @@ public:
         return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
     }
 
+    /**
+     * Batch version of findIntersectingChunkWithSimpleCollation. Returns the chunk containing each
+     * of 'shardKeys', in the same order, or boost::none for the keys which are empty. The keys are
+     * sorted once and their chunks located in a single ordered pass over the chunk map, which is
+     * considerably cheaper than a separate lookup per key for large batches.
+     *
+     * Throws a DBException with the ShardKeyNotFound code if any non-empty key does not match the
+     * shard key pattern.
+     */
+    std::vector<boost::optional<Chunk>> findIntersectingChunksWithSimpleCollation(
+        const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
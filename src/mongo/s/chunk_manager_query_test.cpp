@@ -487,5 +487,36 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksMatchesSingleKeyLookups) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+
+    std::vector<BSONObj> splitPoints;
+    for (int i = 0; i < 1000; i += 10) {
+        splitPoints.push_back(BSON("a" << i));
+    }
+    auto chunkManager = makeChunkManager(kNss, shardKeyPattern, nullptr, false, splitPoints);
+
+    // Unsorted keys with duplicates, keys on chunk boundaries, keys close together and keys far
+    // apart, plus an empty key which must not be targeted
+    std::vector<BSONObj> shardKeys;
+    for (int value : {500, -5, 10, 11, 999, 1500, 10, 0, 20, 990, 455, 9, 456}) {
+        shardKeys.push_back(BSON("a" << value));
+    }
+    shardKeys.push_back(BSONObj());
+
+    const auto chunks = chunkManager->findIntersectingChunksWithSimpleCollation(shardKeys);
+    ASSERT_EQ(shardKeys.size(), chunks.size());
+    ASSERT(!chunks.back());
+
+    for (size_t i = 0; i + 1 < shardKeys.size(); ++i) {
+        ASSERT(chunks[i]);
+
+        const auto expected = chunkManager->findIntersectingChunkWithSimpleCollation(shardKeys[i]);
+        ASSERT_BSONOBJ_EQ(expected.getMin(), chunks[i]->getMin());
+        ASSERT_BSONOBJ_EQ(expected.getMax(), chunks[i]->getMax());
+        ASSERT_EQ(expected.getShardId(), chunks[i]->getShardId());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
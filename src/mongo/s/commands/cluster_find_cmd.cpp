@@ -209,7 +209,8 @@ public:
             auto cursorId = ClusterFind::runQuery(
                 opCtx, *cq.getValue(), ReadPreferenceSetting::get(opCtx), &batch);
             // Build the response document.
-            CursorResponseBuilder firstBatch(/*firstBatch*/ true, &result);
+            CursorResponseBuilder firstBatch(
+                /*firstBatch*/ true, &result, CommandHelpers::replyOpMsgBuilder(opCtx));
             for (const auto& obj : batch) {
                 firstBatch.append(obj);
             }
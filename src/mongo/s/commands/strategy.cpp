@@ -531,6 +531,7 @@ DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
     auto reply = rpc::makeReplyBuilder(rpc::protocolForMessage(m));
 
     bool propagateException = false;
+    bool shouldRunAgainForExhaust = false;
 
     try {
         // Parse.
@@ -551,8 +552,12 @@ DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
         std::string db = request.getDatabase().toString();
         try {
             LOG(3) << "Command begin db: " << db << " msg id: " << m.header().getId();
+            CommandHelpers::ReplyOpMsgBuilderScope replyOpMsgBuilderScope(
+                opCtx, reply->getOpMsgBuilder());
             runCommand(opCtx, request, m.operation(), reply->getInPlaceReplyBuilder(0));
             LOG(3) << "Command end db: " << db << " msg id: " << m.header().getId();
+            shouldRunAgainForExhaust =
+                CommandHelpers::shouldRunAgainForExhaust(m, request, reply.get());
         } catch (const DBException& ex) {
             LOG(1) << "Exception thrown while processing command on " << db
                    << " msg id: " << m.header().getId() << causedBy(redact(ex));
@@ -576,7 +581,9 @@ DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
     }
 
     reply->setMetadata(BSONObj());  // mongos doesn't use metadata but the API requires this call.
-    return DbResponse{reply->done()};
+    DbResponse dbResponse{reply->done()};
+    dbResponse.shouldRunAgainForExhaust = shouldRunAgainForExhaust;
+    return dbResponse;
 }
 
 void Strategy::commandOp(OperationContext* opCtx,
@@ -38,6 +38,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -78,6 +79,18 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns the 'nextBatch' array out of the getMore reply 'cmdResponse', sharing ownership with the
+ * reply, or an empty object if the reply does not own its buffer.
+ */
+BSONObj extractRawBatch(const BSONObj& cmdResponse) {
+    auto batchElt = cmdResponse["cursor"]["nextBatch"];
+    if (batchElt.type() != BSONType::Array || !cmdResponse.isOwned()) {
+        return BSONObj();
+    }
+    return batchElt.Obj().shareOwnershipWith(cmdResponse);
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -277,7 +290,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -291,8 +304,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = _popFromRemote(lk, smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -300,18 +312,18 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
         _mergeQueue.push(smallestRemote);
     }
 
+    _readAheadIfNeeded(lk, smallestRemote);
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = _popFromRemote(lk, _gettingFromRemote);
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -321,6 +333,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _readAheadIfNeeded(lk, _gettingFromRemote);
             return front;
         }
 
@@ -334,6 +347,45 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+ClusterQueryResult AsyncResultsMerger::_popFromRemote(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    ClusterQueryResult front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    remote.rawBatch = BSONObj();
+
+    const long long size = front.getResult()->objsize();
+    remote.bufferedBytes -= size;
+    _bufferedBytes -= size;
+    return front;
+}
+
+bool AsyncResultsMerger::_shouldReadAhead(WithLock, size_t remoteIndex) {
+    const int lowWaterMark = internalQueryARMReadAheadLowWaterMark.load();
+    if (lowWaterMark <= 0 || _tailableMode != TailableModeEnum::kNormal) {
+        return false;
+    }
+
+    // It is illegal to schedule a remote command on a user's behalf without a non-null
+    // OperationContext.
+    if (_lifecycleState != kAlive || !_opCtx) {
+        return false;
+    }
+
+    const auto& remote = _remotes[remoteIndex];
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid()) {
+        return false;
+    }
+
+    return remote.docBuffer.size() < static_cast<size_t>(lowWaterMark) &&
+        _bufferedBytes < internalQueryARMReadAheadMaxBufferedBytes.load();
+}
+
+void AsyncResultsMerger::_readAheadIfNeeded(WithLock lk, size_t remoteIndex) {
+    if (_shouldReadAhead(lk, remoteIndex)) {
+        _remotes[remoteIndex].status = _askForNextBatch(lk, remoteIndex);
+    }
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
@@ -402,9 +454,12 @@ Status AsyncResultsMerger::_scheduleGetMores(WithLock lk) {
             return remote.status;
         }
 
-        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+        const bool needsBatch =
+            !remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid();
+        if (needsBatch || _shouldReadAhead(lk, i)) {
             // If this remote is not exhausted and there is no outstanding request for it, schedule
-            // work to retrieve the next batch.
+            // work to retrieve the next batch. With read-ahead enabled, we also do so for remotes
+            // whose buffer has dropped below the low-water mark.
             auto nextBatchStatus = _askForNextBatch(lk, i);
             if (!nextBatchStatus.isOK()) {
                 return nextBatchStatus;
@@ -569,6 +624,9 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        _bufferedBytes -= remote.bufferedBytes;
+        remote.bufferedBytes = 0;
+        remote.rawBatch = BSONObj();
         remote.cursorId = 0;
     }
 }
@@ -593,10 +651,15 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
     remote.cursorId = cursorResponse.getCursorId();
 
     // Save the batch in the remote's buffer.
+    const bool bufferWasEmpty = remote.docBuffer.empty();
     if (!_addBatchToBuffer(lk, remoteIndex, cursorResponse)) {
         return;
     }
 
+    // If this batch is all that is buffered for the remote, keep its raw array so that it can be
+    // relayed to the client without being re-serialized one document at a time.
+    remote.rawBatch = bufferWasEmpty ? extractRawBatch(response.data) : BSONObj();
+
     // If the cursor is tailable and we just received an empty batch, the next return value should
     // be boost::none in order to indicate the end of the batch. We do not ask for the next batch if
     // the cursor is tailable, as batches received from remote tailable cursors should be passed
@@ -612,6 +675,10 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
         // Be careful only to do this when '_opCtx' is non-null, since it is illegal to schedule a
         // remote command on a user's behalf without a non-null OperationContext.
         remote.status = _askForNextBatch(lk, remoteIndex);
+    } else {
+        // Otherwise, if this batch left the remote below the read-ahead low-water mark, ask for
+        // the next one before the client drains the buffer.
+        _readAheadIfNeeded(lk, remoteIndex);
     }
 }
 
@@ -643,6 +710,8 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
+        remote.bufferedBytes += obj.objsize();
+        _bufferedBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
@@ -779,6 +848,15 @@ void AsyncResultsMerger::blockingKill(OperationContext* opCtx) {
 }
 
 StatusWith<ClusterQueryResult> AsyncResultsMerger::blockingNext() {
+    auto status = blockingWaitUntilReady();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    return nextReady();
+}
+
+Status AsyncResultsMerger::blockingWaitUntilReady() {
     while (!ready()) {
         auto nextEventStatus = nextEvent();
         if (!nextEventStatus.isOK()) {
@@ -798,7 +876,34 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::blockingNext() {
         invariant(status.getValue() == stdx::cv_status::no_timeout);
     }
 
-    return nextReady();
+    return Status::OK();
+}
+
+boost::optional<BSONObj> AsyncResultsMerger::nextReadyRawBatch(long long maxDocs) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    dassert(_ready(lk));
+    if (_lifecycleState != kAlive || !_status.isOK() || _eofNext || _remotes.size() != 1 ||
+        _params.getSort() || _tailableMode != TailableModeEnum::kNormal) {
+        return boost::none;
+    }
+
+    auto& remote = _remotes[0];
+    if (!remote.status.isOK() || remote.rawBatch.isEmpty() ||
+        (maxDocs > 0 && remote.docBuffer.size() > static_cast<size_t>(maxDocs))) {
+        return boost::none;
+    }
+
+    // The buffered results are views into 'rawBatch', so they can be dropped wholesale.
+    std::queue<ClusterQueryResult> emptyBuffer;
+    std::swap(remote.docBuffer, emptyBuffer);
+    _bufferedBytes -= remote.bufferedBytes;
+    remote.bufferedBytes = 0;
+
+    BSONObj rawBatch = std::move(remote.rawBatch);
+    remote.rawBatch = BSONObj();
+
+    _readAheadIfNeeded(lk, 0);
+    return rawBatch;
 }
 
 }  // namespace mongo
@@ -172,6 +172,25 @@ public:
      */
     StatusWith<ClusterQueryResult> blockingNext();
 
+    /**
+     * Blocks until ready() returns true, or returns the error which interrupted the wait.
+     */
+    Status blockingWaitUntilReady();
+
+    /**
+     * If this merger reads from a single remote in non-tailable mode without a sort, and the
+     * results buffered for that remote are exactly one batch as it was received, consumes that
+     * batch and returns its array of documents. The array shares ownership with the remote's reply,
+     * so the caller can relay it to the client as is rather than one result at a time.
+     *
+     * Returns boost::none without consuming anything if the batch holds more than 'maxDocs'
+     * documents (zero means no limit) or if the buffered results cannot be relayed as a single
+     * batch, in which case the caller should fall back to nextReady().
+     *
+     * Invalid to call unless ready() has returned true.
+     */
+    boost::optional<BSONObj> nextReadyRawBatch(long long maxDocs);
+
     /**
      * Schedules remote work as required in order to make further results available. If there is an
      * error in scheduling this work, returns a non-ok status. On success, returns an event handle.
@@ -301,6 +320,13 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // The total BSON size of the results in 'docBuffer'. Used to bound read-ahead.
+        long long bufferedBytes = 0;
+
+        // The array of documents from the reply which filled 'docBuffer', if 'docBuffer' holds
+        // exactly that batch and nothing else. Empty otherwise.
+        BSONObj rawBatch;
     };
 
     class MergingComparator {
@@ -343,6 +369,25 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Returns true if the remote at 'remoteIndex' still has results buffered but has dropped below
+     * the read-ahead low-water mark, and a getMore can be issued to it now without exceeding the
+     * buffered bytes budget. Read-ahead is never done for tailable cursors, since their batches are
+     * passed through to the client as-is.
+     */
+    bool _shouldReadAhead(WithLock, size_t remoteIndex);
+
+    /**
+     * Schedules a read-ahead getMore for the remote at 'remoteIndex' if _shouldReadAhead() allows
+     * it. A failure to schedule the request is recorded as the remote's status.
+     */
+    void _readAheadIfNeeded(WithLock, size_t remoteIndex);
+
+    /**
+     * Removes and returns the first buffered result of the remote at 'remoteIndex'.
+     */
+    ClusterQueryResult _popFromRemote(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -446,6 +491,9 @@ private:
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
 
+    // The total BSON size of the results buffered across all of '_remotes'.
+    long long _bufferedBytes = 0;
+
     Status _status = Status::OK();
 
     executor::TaskExecutor::EventHandle _currentEvent;
@@ -71,6 +71,15 @@ public:
      */
     virtual StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext) = 0;
 
+    /**
+     * If this cursor reads from a single remote and its next results can be returned to the client
+     * unchanged, blocks until they are available and returns them as the raw array of documents
+     * received from the remote. Never returns more than 'maxDocs' documents, unless 'maxDocs' is
+     * zero. Returns boost::none if the results cannot be relayed this way, in which case the caller
+     * should fall back to next().
+     */
+    virtual StatusWith<boost::optional<BSONObj>> nextRawBatch(long long maxDocs) = 0;
+
     /**
      * Must be called before destruction to abandon a not-yet-exhausted cursor. If next() has
      * already returned boost::none, then the cursor is exhausted and is safe to destroy.
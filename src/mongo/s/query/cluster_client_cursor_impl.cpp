@@ -76,6 +76,7 @@ ClusterClientCursorImpl::ClusterClientCursorImpl(OperationContext* opCtx,
                                                  boost::optional<LogicalSessionId> lsid)
     : _params(std::move(params)),
       _root(buildMergerPlan(opCtx, executor, &_params)),
+      _rawBatchSource(dynamic_cast<RouterStageMerge*>(_root.get())),
       _lsid(lsid),
       _opCtx(opCtx) {
     dassert(!_params.compareWholeSortKey ||
@@ -117,6 +118,25 @@ StatusWith<ClusterQueryResult> ClusterClientCursorImpl::next(
     return next;
 }
 
+StatusWith<boost::optional<BSONObj>> ClusterClientCursorImpl::nextRawBatch(long long maxDocs) {
+    invariant(_opCtx);
+    const auto interruptStatus = _opCtx->checkForInterruptNoAssert();
+    if (!interruptStatus.isOK()) {
+        return interruptStatus;
+    }
+
+    // Stashed results must be returned first, one at a time.
+    if (!_rawBatchSource || !_stash.empty()) {
+        return {boost::none};
+    }
+
+    auto rawBatch = _rawBatchSource->nextRawBatch(maxDocs);
+    if (rawBatch.isOK() && rawBatch.getValue()) {
+        _numReturnedSoFar += rawBatch.getValue()->nFields();
+    }
+    return rawBatch;
+}
+
 void ClusterClientCursorImpl::kill(OperationContext* opCtx) {
     _root->kill(opCtx);
 }
@@ -40,6 +40,8 @@
 
 namespace mongo {
 
+class RouterStageMerge;
+
 class RouterStageMock;
 
 /**
@@ -91,6 +93,8 @@ public:
 
     StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext) final;
 
+    StatusWith<boost::optional<BSONObj>> nextRawBatch(long long maxDocs) final;
+
     void kill(OperationContext* opCtx) final;
 
     void reattachToOperationContext(OperationContext* opCtx) final;
@@ -155,6 +159,10 @@ private:
     // The root stage of the pipeline used to return the result set, merged from the remote nodes.
     std::unique_ptr<RouterExecStage> _root;
 
+    // Set if '_root' merges remote results without transforming them, in which case batches can be
+    // relayed to the client as they were received. Owned by '_root'.
+    RouterStageMerge* _rawBatchSource = nullptr;
+
     // Stores documents queued by queueResult(). BSONObjs within the stashed results must be owned.
     std::queue<ClusterQueryResult> _stash;
 
@@ -65,6 +65,11 @@ StatusWith<ClusterQueryResult> ClusterClientCursorMock::next(
     return out.getValue();
 }
 
+StatusWith<boost::optional<BSONObj>> ClusterClientCursorMock::nextRawBatch(long long maxDocs) {
+    invariant(!_killed);
+    return {boost::none};
+}
+
 BSONObj ClusterClientCursorMock::getOriginatingCommand() const {
     return _originatingCommand;
 }
@@ -50,6 +50,8 @@ public:
 
     StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext) final;
 
+    StatusWith<boost::optional<BSONObj>> nextRawBatch(long long maxDocs) final;
+
     void kill(OperationContext* opCtx) final;
 
     void reattachToOperationContext(OperationContext* opCtx) final {
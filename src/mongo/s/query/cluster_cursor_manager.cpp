@@ -118,6 +118,12 @@ StatusWith<ClusterQueryResult> ClusterCursorManager::PinnedCursor::next(
     return _cursor->next(execContext);
 }
 
+StatusWith<boost::optional<BSONObj>> ClusterCursorManager::PinnedCursor::nextRawBatch(
+    long long maxDocs) {
+    invariant(_cursor);
+    return _cursor->nextRawBatch(maxDocs);
+}
+
 bool ClusterCursorManager::PinnedCursor::isTailable() const {
     invariant(_cursor);
     return _cursor->isTailable();
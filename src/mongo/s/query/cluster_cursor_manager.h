@@ -167,6 +167,14 @@ public:
          */
         StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext);
 
+        /**
+         * Calls nextRawBatch() on the underlying cursor. Cannot be called after returnCursor() is
+         * called. A cursor must be owned.
+         *
+         * Can block.
+         */
+        StatusWith<boost::optional<BSONObj>> nextRawBatch(long long maxDocs);
+
         /**
          * Returns whether or not the underlying cursor is tailing a capped collection.  Cannot be
          * called after returnCursor() is called.  A cursor must be owned.
@@ -602,7 +602,19 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
     long long startingFrom = pinnedCursor.getValue().getNumReturnedSoFar();
     auto cursorState = ClusterCursorManager::CursorState::NotExhausted;
 
-    while (!FindCommon::enoughForGetMore(batchSize, batch.size())) {
+    // A cursor which merely relays the results of a single remote can hand back the next batch as
+    // it was received from the shard, which spares us from returning it one document at a time and
+    // re-serializing each document into the reply.
+    auto rawBatch = pinnedCursor.getValue().nextRawBatch(batchSize);
+    if (!rawBatch.isOK()) {
+        return rawBatch.getStatus();
+    }
+    const bool haveRawBatch = static_cast<bool>(rawBatch.getValue());
+    if (haveRawBatch && pinnedCursor.getValue().remotesExhausted()) {
+        cursorState = ClusterCursorManager::CursorState::Exhausted;
+    }
+
+    while (!haveRawBatch && !FindCommon::enoughForGetMore(batchSize, batch.size())) {
         auto context = batch.empty()
             ? RouterExecStage::ExecContext::kGetMoreNoResultsYet
             : RouterExecStage::ExecContext::kGetMoreWithAtLeastOneResultInBatch;
@@ -659,7 +671,8 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
 
     // Set nReturned and whether the cursor has been exhausted.
     CurOp::get(opCtx)->debug().cursorExhausted = (idToReturn == 0);
-    CurOp::get(opCtx)->debug().nreturned = batch.size();
+    CurOp::get(opCtx)->debug().nreturned =
+        haveRawBatch ? rawBatch.getValue()->nFields() : batch.size();
 
     if (MONGO_FAIL_POINT(waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch)) {
         CurOpFailpointHelpers::waitWhileFailPointEnabled(
@@ -668,7 +681,11 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
             "waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch");
     }
 
-    return CursorResponse(request.nss, idToReturn, std::move(batch), startingFrom);
+    CursorResponse response(request.nss, idToReturn, std::move(batch), startingFrom);
+    if (haveRawBatch) {
+        response.setRawBatch(std::move(*rawBatch.getValue()));
+    }
+    return std::move(response);
 }
 
 }  // namespace mongo
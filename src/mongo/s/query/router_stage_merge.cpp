@@ -53,6 +53,19 @@ StatusWith<ClusterQueryResult> RouterStageMerge::next(ExecContext execCtx) {
                 : _arm.blockingNext());
 }
 
+StatusWith<boost::optional<BSONObj>> RouterStageMerge::nextRawBatch(long long maxDocs) {
+    if (_params->tailableMode != TailableModeEnum::kNormal) {
+        return {boost::none};
+    }
+
+    auto status = _arm.blockingWaitUntilReady();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    return {_arm.nextReadyRawBatch(maxDocs)};
+}
+
 StatusWith<ClusterQueryResult> RouterStageMerge::awaitNextWithTimeout(ExecContext execCtx) {
     invariant(_params->tailableMode == TailableModeEnum::kTailableAndAwaitData);
     // If we are in kInitialFind or kGetMoreWithAtLeastOneResultInBatch context and the ARM is not
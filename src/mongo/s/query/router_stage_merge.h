@@ -59,6 +59,13 @@ public:
 
     std::size_t getNumRemotes() const final;
 
+    /**
+     * For non-tailable cursors, blocks until the ARM is ready and then tries to consume the next
+     * batch as the raw array of documents received from the remote. Returns boost::none if the
+     * buffered results cannot be relayed that way; see AsyncResultsMerger::nextReadyRawBatch().
+     */
+    StatusWith<boost::optional<BSONObj>> nextRawBatch(long long maxDocs);
+
     /**
      * Adds the cursors in 'newShards' to those being merged by the ARM.
      */
@@ -140,6 +140,12 @@ StatusWith<BSONObj> storePossibleCursor(OperationContext* opCtx,
 
     CursorResponse outgoingCursorResponse(
         requestedNss, clusterCursorId.getValue(), incomingCursorResponse.getValue().getBatch());
+
+    // Relay the shard's first batch as it was received rather than re-serializing each document.
+    auto firstBatchElt = cmdResult["cursor"]["firstBatch"];
+    if (firstBatchElt.type() == BSONType::Array) {
+        outgoingCursorResponse.setRawBatch(firstBatchElt.Obj());
+    }
     return outgoingCursorResponse.toBSON(CursorResponse::ResponseType::InitialResponse);
 }
 
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_manager.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const KeyPattern kShardKeyPattern(BSON("x" << 1));
+const ShardId kShard0("shard0");
+const ShardId kShard1("shard1");
+
+class RoutingTableHistoryTest : public unittest::Test {
+protected:
+    ChunkType makeChunk(const BSONObj& min, const BSONObj& max, const ShardId& shard) {
+        _version.incMajor();
+        return ChunkType(kNss, ChunkRange(min, max), _version, shard);
+    }
+
+    std::shared_ptr<RoutingTableHistory> makeRoutingTable(const std::vector<ChunkType>& chunks) {
+        return RoutingTableHistory::makeNew(
+            kNss, UUID::gen(), kShardKeyPattern, nullptr, false, _epoch, chunks);
+    }
+
+    /**
+     * Makes a routing table with chunks [MinKey, 0), [0, 10), [10, 20) and [20, MaxKey), of which
+     * the first two are on shard0 and the others on shard1.
+     */
+    std::shared_ptr<RoutingTableHistory> makeFourChunkRoutingTable() {
+        return makeRoutingTable({makeChunk(BSON("x" << MINKEY), BSON("x" << 0), kShard0),
+                                 makeChunk(BSON("x" << 0), BSON("x" << 10), kShard0),
+                                 makeChunk(BSON("x" << 10), BSON("x" << 20), kShard1),
+                                 makeChunk(BSON("x" << 20), BSON("x" << MAXKEY), kShard1)});
+    }
+
+    static std::set<ShardId> getAllShardIds(const RoutingTableHistory& rt) {
+        std::set<ShardId> shardIds;
+        rt.getAllShardIds(&shardIds);
+        return shardIds;
+    }
+
+    const OID _epoch = OID::gen();
+    ChunkVersion _version{0, 0, _epoch};
+};
+
+TEST_F(RoutingTableHistoryTest, FullBuildComputesShardVersions) {
+    auto rt = makeFourChunkRoutingTable();
+    ASSERT_EQ(4U, rt->getChunkMap().size());
+    ASSERT_EQ(ChunkVersion(2, 0, _epoch), rt->getVersion(kShard0));
+    ASSERT_EQ(ChunkVersion(4, 0, _epoch), rt->getVersion(kShard1));
+    ASSERT_EQ(ChunkVersion(4, 0, _epoch), rt->getVersion());
+}
+
+TEST_F(RoutingTableHistoryTest, MigrationUpdatesVersionsOfDonorAndRecipient) {
+    auto rt = makeFourChunkRoutingTable();
+
+    // Move [0, 10) to shard1, and bump the version of the donor's remaining chunk.
+    auto migrated = makeChunk(BSON("x" << 0), BSON("x" << 10), kShard1);
+    auto control = makeChunk(BSON("x" << MINKEY), BSON("x" << 0), kShard0);
+    auto updated = rt->makeUpdated({migrated, control});
+
+    ASSERT_NOT_EQUALS(rt->getSequenceNumber(), updated->getSequenceNumber());
+    ASSERT_EQ(4U, updated->getChunkMap().size());
+    ASSERT_EQ(control.getVersion(), updated->getVersion(kShard0));
+    ASSERT_EQ(migrated.getVersion(), updated->getVersion(kShard1));
+
+    // The original routing table is unchanged.
+    ASSERT_EQ(ChunkVersion(2, 0, _epoch), rt->getVersion(kShard0));
+    ASSERT_EQ(kShard0, std::next(rt->getChunkMap().begin())->second->getShardIdAt(boost::none));
+}
+
+TEST_F(RoutingTableHistoryTest, MigratingLastChunkRemovesShard) {
+    auto rt = makeRoutingTable({makeChunk(BSON("x" << MINKEY), BSON("x" << 0), kShard0),
+                                makeChunk(BSON("x" << 0), BSON("x" << MAXKEY), kShard1)});
+
+    auto updated = rt->makeUpdated({makeChunk(BSON("x" << 0), BSON("x" << MAXKEY), kShard0)});
+    ASSERT(std::set<ShardId>{kShard0} == getAllShardIds(*updated));
+    ASSERT_EQ(ChunkVersion(0, 0, _epoch), updated->getVersion(kShard1));
+    ASSERT_EQ(updated->getVersion(), updated->getVersion(kShard0));
+}
+
+TEST_F(RoutingTableHistoryTest, SplitAndMergeKeepShardVersionsCurrent) {
+    auto rt = makeFourChunkRoutingTable();
+
+    auto split = rt->makeUpdated({makeChunk(BSON("x" << 10), BSON("x" << 15), kShard1),
+                                  makeChunk(BSON("x" << 15), BSON("x" << 20), kShard1)});
+    ASSERT_EQ(5U, split->getChunkMap().size());
+    ASSERT_EQ(split->getVersion(), split->getVersion(kShard1));
+
+    auto merged = split->makeUpdated({makeChunk(BSON("x" << 0), BSON("x" << 20), kShard1)});
+    ASSERT_EQ(3U, merged->getChunkMap().size());
+    ASSERT_EQ(merged->getVersion(), merged->getVersion(kShard1));
+    ASSERT(std::set<ShardId>({kShard0, kShard1}) == getAllShardIds(*merged));
+}
+
+TEST_F(RoutingTableHistoryTest, RecomputesVersionOfShardWhichLostItsNewestChunk) {
+    auto rt = makeFourChunkRoutingTable();
+
+    // shard0's newest chunk [0, 10) moves away without its remaining chunk being bumped, so its
+    // version goes back to that of [MinKey, 0).
+    auto updated = rt->makeUpdated({makeChunk(BSON("x" << 0), BSON("x" << 10), kShard1)});
+    ASSERT_EQ(ChunkVersion(1, 0, _epoch), updated->getVersion(kShard0));
+}
+
+TEST_F(RoutingTableHistoryTest, UpdateLeavingAGapIsRejected) {
+    auto rt = makeFourChunkRoutingTable();
+    ASSERT_THROWS_CODE(rt->makeUpdated({makeChunk(BSON("x" << 12), BSON("x" << 20), kShard1)}),
+                       AssertionException,
+                       ErrorCodes::ConflictingOperationInProgress);
+}
+
+TEST_F(RoutingTableHistoryTest, UpdateWithoutNewVersionsReturnsSameRoutingTable) {
+    auto rt = makeFourChunkRoutingTable();
+    ASSERT_EQ(rt, rt->makeUpdated({}));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -98,6 +98,37 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshTimeoutMS,
                                       int,
                                       ConnectionPool::kDefaultRefreshTimeout.count());
 
+// If true, each pool opens connections ahead of demand based on the request rate and latency it
+// has observed, so that it does not have to open them one at a time as requests queue up (for
+// example after a failover dropped all of its connections).
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolAdaptiveSizing, bool, false);
+
+// If non-zero, each pool shares this many connections per host between concurrent requests, each
+// carrying up to ShardingTaskExecutorPoolMaxInFlightPerMultiplexedConnection requests at once,
+// instead of checking out a connection for every request. Shards run the requests of a connection
+// one at a time, so a slow request delays the ones sent after it on the same connection. Requests
+// without a timeout, getMores, migrations and writes waiting for replication are never shared.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolMultiplexedConnectionsPerHost, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "ShardingTaskExecutorPoolMultiplexedConnectionsPerHost must not be "
+                          "negative");
+        }
+        return Status::OK();
+    });
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolMaxInFlightPerMultiplexedConnection,
+                                      int,
+                                      16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "ShardingTaskExecutorPoolMaxInFlightPerMultiplexedConnection must be at "
+                          "least 1");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 using executor::NetworkInterface;
@@ -193,6 +224,11 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.minConnections = ShardingTaskExecutorPoolMinSize;
     connPoolOptions.refreshRequirement = Milliseconds(ShardingTaskExecutorPoolRefreshRequirementMS);
     connPoolOptions.refreshTimeout = Milliseconds(ShardingTaskExecutorPoolRefreshTimeoutMS);
+    connPoolOptions.adaptiveSizing = ShardingTaskExecutorPoolAdaptiveSizing;
+    connPoolOptions.multiplexedConnectionsPerHost =
+        ShardingTaskExecutorPoolMultiplexedConnectionsPerHost;
+    connPoolOptions.maxInFlightPerMultiplexedConnection =
+        ShardingTaskExecutorPoolMaxInFlightPerMultiplexedConnection;
 
     if (connPoolOptions.refreshRequirement <= connPoolOptions.refreshTimeout) {
         auto newRefreshTimeout = connPoolOptions.refreshRequirement - Milliseconds(1);
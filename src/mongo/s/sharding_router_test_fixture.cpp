@@ -275,6 +275,10 @@ void ShardingTestFixture::onCommandForPoolExecutor(NetworkTestEnv::OnCommandFunc
     _networkTestEnvForPool->onCommand(func);
 }
 
+void ShardingTestFixture::waitForPoolExecutorRequests(size_t numRequests) {
+    _networkTestEnvForPool->waitForReadyRequests(numRequests, kFutureTimeout);
+}
+
 void ShardingTestFixture::addRemoteShards(
     const std::vector<std::tuple<ShardId, HostAndPort>>& shardInfos) {
     std::vector<ShardType> shards;
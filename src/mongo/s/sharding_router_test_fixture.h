@@ -84,6 +84,12 @@ public:
      */
     void onCommandForPoolExecutor(executor::NetworkTestEnv::OnCommandFunction func);
 
+    /**
+     * Blocks until at least 'numRequests' requests are waiting to be answered on the network of
+     * the Grid's executorPool.
+     */
+    void waitForPoolExecutorRequests(size_t numRequests);
+
     /**
      * Setup the shard registry to contain the given shards until the next reload.
      */
@@ -114,10 +114,22 @@ StatusWith<TaskExecutor::CallbackHandle> ShardingTaskExecutor::scheduleRemoteCom
     const RemoteCommandRequest& request,
     const RemoteCommandCallbackFn& cb,
     const transport::BatonHandle& baton) {
+    return scheduleRemoteCommandInBatch(request, cb, nullptr, baton);
+}
+
+TaskExecutor::RemoteCommandBatchHandle ShardingTaskExecutor::makeRemoteCommandBatch() {
+    return _executor->makeRemoteCommandBatch();
+}
+
+StatusWith<TaskExecutor::CallbackHandle> ShardingTaskExecutor::scheduleRemoteCommandInBatch(
+    const RemoteCommandRequest& request,
+    const RemoteCommandCallbackFn& cb,
+    const RemoteCommandBatchHandle& batch,
+    const transport::BatonHandle& baton) {
 
     // schedule the user's callback if there is not opCtx
     if (!request.opCtx) {
-        return _executor->scheduleRemoteCommand(request, cb, baton);
+        return _executor->scheduleRemoteCommandInBatch(request, cb, batch, baton);
     }
 
     boost::optional<RemoteCommandRequest> newRequest;
@@ -203,7 +215,8 @@ StatusWith<TaskExecutor::CallbackHandle> ShardingTaskExecutor::scheduleRemoteCom
         }
     };
 
-    return _executor->scheduleRemoteCommand(newRequest ? *newRequest : request, shardingCb, baton);
+    return _executor->scheduleRemoteCommandInBatch(
+        newRequest ? *newRequest : request, shardingCb, batch, baton);
 }
 
 void ShardingTaskExecutor::cancel(const CallbackHandle& cbHandle) {
@@ -71,6 +71,12 @@ public:
         const RemoteCommandRequest& request,
         const RemoteCommandCallbackFn& cb,
         const transport::BatonHandle& baton = nullptr) override;
+    RemoteCommandBatchHandle makeRemoteCommandBatch() override;
+    StatusWith<CallbackHandle> scheduleRemoteCommandInBatch(
+        const RemoteCommandRequest& request,
+        const RemoteCommandCallbackFn& cb,
+        const RemoteCommandBatchHandle& batch,
+        const transport::BatonHandle& baton = nullptr) override;
     void cancel(const CallbackHandle& cbHandle) override;
     void wait(const CallbackHandle& cbHandle) override;
 
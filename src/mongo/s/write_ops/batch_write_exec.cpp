@@ -38,12 +38,14 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/async_requests_sender.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -77,8 +79,336 @@ void noteStaleResponses(const std::vector<ShardError>& staleErrors, NSTargeter*
 // applies when no writes are occurring and metadata is not changing on reload.
 const int kMaxRoundsWithoutProgress(5);
 
+/**
+ * Builds the command to send to the shard of the child batch 'batch' of 'batchOp'.
+ */
+BSONObj buildShardBatchCommand(OperationContext* opCtx,
+                               const BatchWriteOp& batchOp,
+                               const TargetedWriteBatch& batch) {
+    const auto shardBatchRequest(batchOp.buildBatchRequest(batch));
+
+    BSONObjBuilder requestBuilder;
+    shardBatchRequest.serialize(&requestBuilder);
+
+    {
+        OperationSessionInfo sessionInfo;
+
+        if (opCtx->getLogicalSessionId()) {
+            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+        }
+
+        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+        sessionInfo.serialize(&requestBuilder);
+    }
+
+    return requestBuilder.obj();
+}
+
+/**
+ * Notes in 'batchOp' the response or error received for its child batch 'batch', and in
+ * 'targeter' the stale shard versions which the response reports. Returns true if the targeter
+ * needs to be refreshed before the writes which failed because of it can be retried.
+ */
+bool noteShardResponse(BatchWriteOp& batchOp,
+                       NSTargeter& targeter,
+                       const TargetedWriteBatch& batch,
+                       const AsyncRequestsSender::Response& response,
+                       BatchWriteExecStats* stats) {
+    // First check if we were able to target a shard host.
+    if (!response.shardHostAndPort) {
+        invariant(!response.swResponse.isOK());
+
+        // Record a resolve failure
+        batchOp.noteBatchError(batch, errorFromStatus(response.swResponse.getStatus()));
+
+        // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel and
+        // retarget the batch
+        LOG(4) << "Unable to send write batch to " << batch.getEndpoint().shardName
+               << causedBy(response.swResponse.getStatus());
+        return false;
+    }
+
+    const auto& shardHost = *response.shardHostAndPort;
+
+    // Then check if we successfully got a response.
+    Status responseStatus = response.swResponse.getStatus();
+    BatchedCommandResponse batchedCommandResponse;
+    if (responseStatus.isOK()) {
+        std::string errMsg;
+        if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data, &errMsg) ||
+            !batchedCommandResponse.isValid(&errMsg)) {
+            responseStatus = {ErrorCodes::FailedToParse, errMsg};
+        }
+    }
+
+    if (!responseStatus.isOK()) {
+        // Error occurred dispatching, note it
+        const Status status = responseStatus.withContext(
+            str::stream() << "Write results unavailable from " << shardHost);
+
+        batchOp.noteBatchError(batch, errorFromStatus(status));
+
+        LOG(4) << "Unable to receive write results from " << shardHost << causedBy(redact(status));
+        return false;
+    }
+
+    TrackedErrors trackedErrors;
+    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
+
+    LOG(4) << "Write results received from " << shardHost.toString() << ": "
+           << redact(batchedCommandResponse.toString());
+
+    // Dispatch was ok, note response
+    batchOp.noteBatchResponse(batch, batchedCommandResponse, &trackedErrors);
+
+    bool needsRefresh = false;
+
+    // Note if anything was stale
+    const auto& staleErrors = trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+    if (!staleErrors.empty()) {
+        noteStaleResponses(staleErrors, &targeter);
+        ++stats->numStaleBatches;
+        needsRefresh = true;
+    }
+
+    const auto& cannotImplicitlyCreateErrors =
+        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
+    if (!cannotImplicitlyCreateErrors.empty()) {
+        // This forces the chunk manager to reload so we can attach the correct version on retry
+        // and make sure we route to the correct shard.
+        targeter.noteCouldNotTarget();
+        needsRefresh = true;
+    }
+
+    // Remember that we successfully wrote to this shard
+    // NOTE: This will record lastOps for shards where we actually didn't update or delete any
+    // documents, which preserves old behavior but is conservative
+    stats->noteWriteAt(
+        shardHost,
+        batchedCommandResponse.isLastOpSet() ? batchedCommandResponse.getLastOp() : repl::OpTime(),
+        batchedCommandResponse.isElectionIdSet() ? batchedCommandResponse.getElectionId() : OID());
+
+    return needsRefresh;
+}
+
+/**
+ * Targets the ready writes of 'batchOp' and sends the resulting child batches, at most one per
+ * shard at a time, until the responses for all of them have been received.
+ */
+void executeRound(OperationContext* opCtx,
+                  NSTargeter& targeter,
+                  const BatchedCommandRequest& clientRequest,
+                  BatchWriteOp& batchOp,
+                  bool* refreshedTargeter,
+                  BatchWriteExecStats* stats) {
+    OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
+    std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+
+    // If we've already had a targeting error, we've refreshed the metadata once and can record
+    // target errors definitively.
+    bool recordTargetErrors = *refreshedTargeter;
+    Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
+    if (!targetStatus.isOK()) {
+        // Don't do anything until a targeter refresh
+        targeter.noteCouldNotTarget();
+        *refreshedTargeter = true;
+        ++stats->numTargetErrors;
+        dassert(childBatches.size() == 0u);
+    }
+
+    //
+    // Send all child batches
+    //
+
+    const size_t numToSend = childBatches.size();
+    size_t numSent = 0;
+
+    while (numSent != numToSend) {
+        // Collect batches out on the network, mapped by endpoint
+        OwnedShardBatchMap ownedPendingBatches;
+        OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+
+        //
+        // Construct the requests.
+        //
+
+        std::vector<AsyncRequestsSender::Request> requests;
+
+        // Get as many batches as we can at once
+        for (auto& childBatch : childBatches) {
+            TargetedWriteBatch* const nextBatch = childBatch.second;
+
+            // If the batch is nullptr, we sent it previously, so skip
+            if (!nextBatch)
+                continue;
+
+            // If we already have a batch for this shard, wait until the next time
+            const auto& targetShardId = nextBatch->getEndpoint().shardName;
+
+            if (pendingBatches.count(targetShardId))
+                continue;
+
+            stats->noteTargetedShard(targetShardId);
+
+            const auto request = buildShardBatchCommand(opCtx, batchOp, *nextBatch);
+
+            LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+
+            requests.emplace_back(targetShardId, request);
+
+            // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
+            // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
+            // so this should be pretty efficient without moving stuff around.
+            childBatch.second = nullptr;
+
+            // Recv-side is responsible for cleaning up the nextBatch when used
+            pendingBatches.emplace(targetShardId, nextBatch);
+        }
+
+        AsyncRequestsSender ars(opCtx,
+                                Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                                clientRequest.getTargetingNS().db().toString(),
+                                requests,
+                                kPrimaryOnlyReadPreference,
+                                opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
+                                                      : Shard::RetryPolicy::kNoRetry);
+        numSent += pendingBatches.size();
+
+        //
+        // Receive the responses.
+        //
+
+        while (!ars.done()) {
+            // Block until a response is available.
+            auto response = ars.next();
+
+            // Get the TargetedWriteBatch to find where to put the response
+            dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
+            TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
+
+            noteShardResponse(batchOp, targeter, *batch, response, stats);
+        }
+    }
+}
+
+/**
+ * Streaming version of executeRound for unordered batches, which keeps up to
+ * 'maxBatchesInFlightPerShard' child batches outstanding on each shard. Every time a response is
+ * received, the ready writes are targeted again, so a shard which answers quickly gets its next
+ * batch without waiting for the slower shards.
+ *
+ * Stops dispatching when the targeter needs to be refreshed, and returns once nothing is left in
+ * flight and either no more writes could be targeted or a refresh is needed.
+ */
+void executeStreamingRound(OperationContext* opCtx,
+                           NSTargeter& targeter,
+                           const BatchedCommandRequest& clientRequest,
+                           BatchWriteOp& batchOp,
+                           int maxBatchesInFlightPerShard,
+                           bool* refreshedTargeter,
+                           BatchWriteExecStats* stats) {
+    std::unique_ptr<AsyncRequestsSender> ars;
+
+    // Batches out on the network, by the index of their request in the ARS
+    OwnedPointerMap<size_t, TargetedWriteBatch> ownedPendingBatches;
+    std::map<size_t, TargetedWriteBatch*>& pendingBatches = ownedPendingBatches.mutableMap();
+    size_t numRequests = 0;
+
+    std::map<ShardId, int> numInFlight;
+    std::set<ShardId> fullShards;
+    bool needsRefresh = false;
+
+    // The targeter may have been refreshed since the previous round
+    batchOp.resetDeferredWrites();
+
+    while (true) {
+        if (!needsRefresh) {
+            OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
+            std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+
+            Status targetStatus =
+                batchOp.targetBatch(targeter, *refreshedTargeter, &childBatches, &fullShards);
+            if (!targetStatus.isOK()) {
+                // Don't target anything else until a targeter refresh
+                targeter.noteCouldNotTarget();
+                *refreshedTargeter = true;
+                ++stats->numTargetErrors;
+                needsRefresh = true;
+            }
+
+            std::vector<AsyncRequestsSender::Request> requests;
+            for (auto& childBatch : childBatches) {
+                const ShardId& targetShardId = childBatch.first;
+
+                stats->noteTargetedShard(targetShardId);
+
+                const auto request = buildShardBatchCommand(opCtx, batchOp, *childBatch.second);
+
+                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+
+                requests.emplace_back(targetShardId, request);
+                pendingBatches.emplace(numRequests++, childBatch.second);
+                childBatch.second = nullptr;
+
+                if (++numInFlight[targetShardId] >= maxBatchesInFlightPerShard) {
+                    fullShards.insert(targetShardId);
+                }
+            }
+
+            if (!ars && !requests.empty()) {
+                ars = stdx::make_unique<AsyncRequestsSender>(
+                    opCtx,
+                    Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                    clientRequest.getTargetingNS().db().toString(),
+                    requests,
+                    kPrimaryOnlyReadPreference,
+                    opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
+                                          : Shard::RetryPolicy::kNoRetry);
+            } else {
+                for (const auto& request : requests) {
+                    ars->addRequest(request);
+                }
+            }
+
+            // Shards which still have room may get more batches before waiting for a response
+            if (!requests.empty())
+                continue;
+        }
+
+        if (pendingBatches.empty())
+            break;
+
+        // Block until a response is available.
+        auto response = ars->next();
+
+        auto it = pendingBatches.find(response.requestIndex);
+        invariant(it != pendingBatches.end());
+        std::unique_ptr<TargetedWriteBatch> batch(it->second);
+        pendingBatches.erase(it);
+
+        if (noteShardResponse(batchOp, targeter, *batch, response, stats)) {
+            needsRefresh = true;
+        }
+
+        const ShardId& shardId = batch->getEndpoint().shardName;
+        if (--numInFlight[shardId] < maxBatchesInFlightPerShard) {
+            fullShards.erase(shardId);
+        }
+    }
+}
+
 }  // namespace
 
+MONGO_EXPORT_SERVER_PARAMETER(unorderedWriteMaxBatchesInFlightPerShard, int, 0)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "unorderedWriteMaxBatchesInFlightPerShard must be nonnegative");
+        }
+        return Status::OK();
+    });
+
 void BatchWriteExec::executeBatch(OperationContext* opCtx,
                                   NSTargeter& targeter,
                                   const BatchedCommandRequest& clientRequest,
@@ -91,6 +421,10 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
     BatchWriteOp batchOp(opCtx, clientRequest);
 
+    const int maxBatchesInFlightPerShard = unorderedWriteMaxBatchesInFlightPerShard.load();
+    const bool streamChildBatches =
+        !clientRequest.getWriteCommandBase().getOrdered() && maxBatchesInFlightPerShard > 0;
+
     // Current batch status
     bool refreshedTargeter = false;
     int rounds = 0;
@@ -122,192 +456,16 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //    exactly when the metadata changed.
         //
 
-        OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
-        std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
-
-        // If we've already had a targeting error, we've refreshed the metadata once and can
-        // record target errors definitively.
-        bool recordTargetErrors = refreshedTargeter;
-        Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
-        if (!targetStatus.isOK()) {
-            // Don't do anything until a targeter refresh
-            targeter.noteCouldNotTarget();
-            refreshedTargeter = true;
-            ++stats->numTargetErrors;
-            dassert(childBatches.size() == 0u);
-        }
-
-        //
-        // Send all child batches
-        //
-
-        const size_t numToSend = childBatches.size();
-        size_t numSent = 0;
-
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
-
-            //
-            // Construct the requests.
-            //
-
-            std::vector<AsyncRequestsSender::Request> requests;
-
-            // Get as many batches as we can at once
-            for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
-
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
-                    continue;
-
-                // If we already have a batch for this shard, wait until the next time
-                const auto& targetShardId = nextBatch->getEndpoint().shardName;
-
-                if (pendingBatches.count(targetShardId))
-                    continue;
-
-                stats->noteTargetedShard(targetShardId);
-
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
-
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
-
-                    {
-                        OperationSessionInfo sessionInfo;
-
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
-                        }
-
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
-                    }
-
-                    return requestBuilder.obj();
-                }();
-
-                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
-
-                requests.emplace_back(targetShardId, request);
-
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
-
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.emplace(targetShardId, nextBatch);
-            }
-
-            AsyncRequestsSender ars(opCtx,
-                                    Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                                    clientRequest.getTargetingNS().db().toString(),
-                                    requests,
-                                    kPrimaryOnlyReadPreference,
-                                    opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
-                                                          : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
-
-            //
-            // Receive the responses.
-            //
-
-            while (!ars.done()) {
-                // Block until a response is available.
-                auto response = ars.next();
-
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
-
-                // First check if we were able to target a shard host.
-                if (!response.shardHostAndPort) {
-                    invariant(!response.swResponse.isOK());
-
-                    // Record a resolve failure
-                    batchOp.noteBatchError(*batch,
-                                           errorFromStatus(response.swResponse.getStatus()));
-
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
-                    // and retarget the batch
-                    LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
-                           << causedBy(response.swResponse.getStatus());
-
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
-                    continue;
-                }
-
-                const auto shardHost(std::move(*response.shardHostAndPort));
-
-                // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
-
-                if (responseStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-                    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
-
-                    LOG(4) << "Write results received from " << shardHost.toString() << ": "
-                           << redact(batchedCommandResponse.toString());
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
-
-                    // Note if anything was stale
-                    const auto& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-                    if (!staleErrors.empty()) {
-                        noteStaleResponses(staleErrors, &targeter);
-                        ++stats->numStaleBatches;
-                    }
-
-                    const auto& cannotImplicitlyCreateErrors =
-                        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
-                    if (!cannotImplicitlyCreateErrors.empty()) {
-                        // This forces the chunk manager to reload so we can attach the correct
-                        // version on retry and make sure we route to the correct shard.
-                        targeter.noteCouldNotTarget();
-                    }
-
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(shardHost,
-                                       batchedCommandResponse.isLastOpSet()
-                                           ? batchedCommandResponse.getLastOp()
-                                           : repl::OpTime(),
-                                       batchedCommandResponse.isElectionIdSet()
-                                           ? batchedCommandResponse.getElectionId()
-                                           : OID());
-                } else {
-                    // Error occurred dispatching, note it
-                    const Status status = responseStatus.withContext(
-                        str::stream() << "Write results unavailable from " << shardHost);
-
-                    batchOp.noteBatchError(*batch, errorFromStatus(status));
-
-                    LOG(4) << "Unable to receive write results from " << shardHost
-                           << causedBy(redact(status));
-                }
-            }
+        if (streamChildBatches) {
+            executeStreamingRound(opCtx,
+                                  targeter,
+                                  clientRequest,
+                                  batchOp,
+                                  maxBatchesInFlightPerShard,
+                                  &refreshedTargeter,
+                                  stats);
+        } else {
+            executeRound(opCtx, targeter, clientRequest, batchOp, &refreshedTargeter, stats);
         }
 
         ++rounds;
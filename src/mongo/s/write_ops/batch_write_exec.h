@@ -34,6 +34,7 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/ns_targeter.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
@@ -43,6 +44,11 @@ namespace mongo {
 class BatchWriteExecStats;
 class OperationContext;
 
+// The maximum number of child batches of an unordered write which may be outstanding on a shard
+// at the same time. Zero sends the child batches in rounds instead, where each round waits for
+// the responses from all the shards it targeted before targeting the next writes.
+extern AtomicInt32 unorderedWriteMaxBatchesInFlightPerShard;
+
 /**
  * The BatchWriteExec is able to execute client batch write requests, resulting in a batch
  * response to send back to the client.
@@ -30,6 +30,7 @@
 
 #include "mongo/s/write_ops/batch_write_op.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include "mongo/base/error_codes.h"
@@ -66,6 +67,10 @@ struct WriteErrorDetailComp {
 const int kEstUpdateOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 const int kEstDeleteOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 
+// Unordered inserts are targeted up to this many ready documents at a time, which lets the
+// targeter locate the chunks for all of their shard keys together.
+const size_t kInsertTargetingWindowSize = 4096;
+
 /**
  * Returns a new write concern that has the copy of every field from the original
  * document but with a w set to 1. This is intended for upgrading { w: 0 } write
@@ -216,7 +221,8 @@ BatchWriteOp::~BatchWriteOp() {
 
 Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
                                  bool recordTargetErrors,
-                                 std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
+                                 std::map<ShardId, TargetedWriteBatch*>* targetedBatches,
+                                 const std::set<ShardId>* shardsToSkip) {
     //
     // Targeting of unordered batches is fairly simple - each remaining write op is targeted,
     // and each of those targeted writes are grouped into a batch for a particular shard
@@ -259,6 +265,37 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // Ordered batches usually stop at the first write which goes to another shard, so only the
+    // unordered inserts are worth targeting ahead of the loop below
+    const bool targetInsertsTogether = !ordered &&
+        _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest.isInsertIndexRequest();
+
+    // Account the array overhead once for the actual updates array and once for the statement ids
+    // array, if retryable writes are used
+    const auto getBatchedWriteSizeBytes = [&](const WriteOp& writeOp) {
+        return getWriteSizeBytes(writeOp) + kBSONArrayPerElementOverheadBytes +
+            (_batchTxnNum ? kBSONArrayPerElementOverheadBytes + 4 : 0);
+    };
+
+    // Endpoints of the ready inserts in the current targeting window, in order
+    std::vector<StatusWith<ShardEndpoint>> insertEndpoints;
+    size_t nextInsertEndpoint = 0;
+    size_t insertWindowEnd = 0;
+
+    // Size of all the inserts targeted in this round so far. The targeter adds every targeted
+    // insert to its auto-split statistics, so once they would no longer fit in a single batch the
+    // windows shrink to one insert. Otherwise the inserts which do not make it into this round's
+    // batches would be counted again when they are targeted in the next round.
+    int roundSizeBytes = 0;
+    size_t roundNumOps = 0;
+
+    // Writes which were already targeted in this round reuse their endpoints, so that they are not
+    // targeted, and counted in the targeter's statistics, again on every call
+    const auto isDeferred = [&](size_t index) {
+        return shardsToSkip && _deferredWriteEndpoints.count(index);
+    };
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -266,6 +303,43 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         if (writeOp.getWriteState() != WriteOpState_Ready)
             continue;
 
+        const bool deferred = isDeferred(i);
+        if (deferred) {
+            const auto& endpoints = _deferredWriteEndpoints[i];
+            if (std::any_of(endpoints.begin(), endpoints.end(), [&](const ShardEndpoint& endpoint) {
+                    return shardsToSkip->count(endpoint.shardName) > 0;
+                })) {
+                if (ordered)
+                    break;
+
+                continue;
+            }
+        }
+
+        if (targetInsertsTogether && !deferred && i >= insertWindowEnd) {
+            std::vector<BSONObj> docs;
+            for (insertWindowEnd = i;
+                 insertWindowEnd < numWriteOps && docs.size() < kInsertTargetingWindowSize;
+                 ++insertWindowEnd) {
+                const WriteOp& windowOp = _writeOps[insertWindowEnd];
+                if (windowOp.getWriteState() != WriteOpState_Ready || isDeferred(insertWindowEnd))
+                    continue;
+
+                const int writeSizeBytes = getBatchedWriteSizeBytes(windowOp);
+                if (!docs.empty() && (roundNumOps >= write_ops::kMaxWriteBatchSize ||
+                                      roundSizeBytes + writeSizeBytes > BSONObjMaxUserSize))
+                    break;
+
+                roundSizeBytes += writeSizeBytes;
+                roundNumOps++;
+                docs.push_back(windowOp.getWriteItem().getDocument());
+            }
+
+            insertEndpoints = targeter.targetInserts(_opCtx, docs);
+            invariant(insertEndpoints.size() == docs.size());
+            nextInsertEndpoint = 0;
+        }
+
         //
         // Get TargetedWrites from the targeter for the write operation
         //
@@ -274,7 +348,31 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = Status::OK();
+        if (deferred) {
+            writeOp.targetEndpoints(_deferredWriteEndpoints[i], &writes);
+            if (targetInsertsTogether) {
+                roundSizeBytes += getBatchedWriteSizeBytes(writeOp);
+                roundNumOps++;
+            }
+        } else if (targetInsertsTogether) {
+            targetStatus =
+                writeOp.targetInsert(std::move(insertEndpoints[nextInsertEndpoint++]), &writes);
+        } else {
+            targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        }
+
+        // Returns the write to the ready state, to be sent by a later call. Its endpoints are kept
+        // for the rest of the round.
+        const auto deferWrites = [&] {
+            if (shardsToSkip && !deferred) {
+                auto& endpoints = _deferredWriteEndpoints[i];
+                for (const auto write : writes) {
+                    endpoints.push_back(write->endpoint);
+                }
+            }
+            writeOp.cancelWrites(nullptr);
+        };
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -304,6 +402,18 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
             }
         }
 
+        if (shardsToSkip && std::any_of(writes.begin(), writes.end(), [&](TargetedWrite* write) {
+                return shardsToSkip->count(write->endpoint.shardName) > 0;
+            })) {
+            deferWrites();
+
+            // Later writes cannot go first if the batch is ordered
+            if (ordered)
+                break;
+
+            continue;
+        }
+
         //
         // If ordered and we have a previous endpoint, make sure we don't need to send these
         // targeted writes to any other endpoints.
@@ -317,20 +427,17 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
             }
         }
 
-        // Account the array overhead once for the actual updates array and once for the statement
-        // ids array, if retryable writes are used
-        const int writeSizeBytes = getWriteSizeBytes(writeOp) + kBSONArrayPerElementOverheadBytes +
-            (_batchTxnNum ? kBSONArrayPerElementOverheadBytes + 4 : 0);
+        const int writeSizeBytes = getBatchedWriteSizeBytes(writeOp);
 
         if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap)) {
             invariant(!batchMap.empty());
-            writeOp.cancelWrites(nullptr);
+            deferWrites();
             break;
         }
 
         if (!ordered && !batchMap.empty() &&
             isNewBatchRequiredUnordered(writes, batchMap, targetedShards)) {
-            writeOp.cancelWrites(nullptr);
+            deferWrites();
             break;
         }
 
@@ -383,6 +490,10 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
     return Status::OK();
 }
 
+void BatchWriteOp::resetDeferredWrites() {
+    _deferredWriteEndpoints.clear();
+}
+
 BatchedCommandRequest BatchWriteOp::buildBatchRequest(
     const TargetedWriteBatch& targetedBatch) const {
     const auto batchType = _clientRequest.getBatchType();
@@ -401,8 +512,12 @@ BatchedCommandRequest BatchWriteOp::buildBatchRequest(
 
         switch (batchType) {
             case BatchedCommandRequest::BatchType_Insert:
-                if (!insertDocs)
+                if (!insertDocs) {
+                    // The documents share the buffers of the client request rather than being
+                    // copied, so building a split batch only costs the vector itself
                     insertDocs.emplace();
+                    insertDocs->reserve(targetedBatch.getWrites().size());
+                }
                 insertDocs->emplace_back(
                     _clientRequest.getInsertRequest().getDocuments().at(writeOpRef.first));
                 break;
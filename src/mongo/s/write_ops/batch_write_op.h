@@ -135,11 +135,25 @@ public:
      * (The idea here is that if we are sure our NSTargeter is up-to-date we should record
      * targeting errors, but if not we should refresh once first.)
      *
+     * If 'shardsToSkip' is set, the writes which would go to any of these shards are not sent and
+     * stay ready for a later call, for example because the caller already has as many batches
+     * outstanding on these shards as it allows. Each of these writes is targeted once, and the
+     * later calls with 'shardsToSkip' set reuse its endpoints instead of targeting it again, until
+     * resetDeferredWrites() is called. The same goes for the writes which did not fit in the
+     * returned batches.
+     *
      * Returned TargetedWriteBatches are owned by the caller.
      */
     Status targetBatch(const NSTargeter& targeter,
                        bool recordTargetErrors,
-                       std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
+                       std::map<ShardId, TargetedWriteBatch*>* targetedBatches,
+                       const std::set<ShardId>* shardsToSkip = nullptr);
+
+    /**
+     * Forgets the endpoints kept for the writes deferred by targetBatch, which must be called
+     * before targeting with 'shardsToSkip' against routing information which may have changed.
+     */
+    void resetDeferredWrites();
 
     /**
      * Fills a BatchCommandRequest from a TargetedWriteBatch for this BatchWriteOp.
@@ -210,6 +224,10 @@ private:
     // Array of ops being processed from the client request
     std::vector<WriteOp> _writeOps;
 
+    // Endpoints of the writes which were targeted but not sent by targetBatch with 'shardsToSkip',
+    // by the index of the write
+    std::map<size_t, std::vector<ShardEndpoint>> _deferredWriteEndpoints;
+
     // Current outstanding batch op write requests
     // Not owned here but tracked for reporting
     std::set<const TargetedWriteBatch*> _targeted;
@@ -1543,5 +1543,130 @@ TEST_F(BatchWriteOpLimitTests, OneBigOneSmall) {
     ASSERT(batchOp.isFinished());
 }
 
+/**
+ * Counts the inserts which BatchWriteOp targets together.
+ */
+class CountingInsertsTargeter : public MockNSTargeter {
+public:
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override {
+        numTargetedInserts += docs.size();
+        return MockNSTargeter::targetInserts(opCtx, docs);
+    }
+
+    mutable size_t numTargetedInserts{0};
+};
+
+// Big unordered inserts which do not fit in one batch are not targeted until the round which sends
+// them, so that the targeter's auto-split statistics count each of them once
+TEST_F(BatchWriteOpLimitTests, UnorderedInsertsTargetedOnlyWhenBatched) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpoint(ShardId("shard"), ChunkVersion::IGNORED());
+    CountingInsertsTargeter targeter;
+    initTargeterFullRange(nss, endpoint, &targeter);
+
+    // Three of these fit in a batch
+    const std::string bigString(BSONObjMaxUserSize / 4, 'x');
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        std::vector<BSONObj> docs;
+        for (int i = 0; i < 5; i++) {
+            docs.push_back(BSON("x" << i << "data" << bigString));
+        }
+        insertOp.setDocuments(std::move(docs));
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 3u);
+
+    // The insert which ended the batch has been targeted on its own
+    ASSERT_EQUALS(targeter.numTargetedInserts, 4u);
+
+    BatchedCommandResponse response;
+    buildResponse(3, &response);
+
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 2u);
+    ASSERT_EQUALS(targeter.numTargetedInserts, 6u);
+
+    buildResponse(2, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+}
+
+// Writes held back while their shard has too many batches in flight are targeted once per round,
+// so that the targeter's auto-split statistics do not count them again on every call
+TEST_F(BatchWriteOpTest, WritesToSkippedShardsTargetedOnce) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    CountingInsertsTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        insertOp.setDocuments(
+            {BSON("x" << -1), BSON("x" << 1), BSON("x" << -2), BSON("x" << 2), BSON("x" << 3)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+    const std::set<ShardId> skipShardB{endpointB.shardName};
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted, &skipShardB));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    assertEndpointsEqual(targeted.begin()->second->getEndpoint(), endpointA);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 2u);
+    ASSERT_EQUALS(targeter.numTargetedInserts, 5u);
+
+    BatchedCommandResponse response;
+    buildResponse(2, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    // Still skipping shardB, nothing is targeted again
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted, &skipShardB));
+    ASSERT_EQUALS(targeted.size(), 0u);
+    ASSERT_EQUALS(targeter.numTargetedInserts, 5u);
+
+    // Once shardB has room, its writes go to the endpoint they were targeted to
+    const std::set<ShardId> skipNone;
+    targetedOwned.clear();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted, &skipNone));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    assertEndpointsEqual(targeted.begin()->second->getEndpoint(), endpointB);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 3u);
+    ASSERT_EQUALS(targeter.numTargetedInserts, 5u);
+
+    buildResponse(3, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+}
+
 }  // namespace
 }  // namespace mongo
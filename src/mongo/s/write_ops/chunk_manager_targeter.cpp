@@ -283,20 +283,11 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
         // Inserts must contain the exact shard key.
         //
 
-        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return {ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "document " << doc
-                                  << " does not contain shard key for pattern "
-                                  << _routingInfo->cm()->getShardKeyPattern().toString()};
-        }
+        auto swShardKey = _extractInsertShardKey(doc);
+        if (!swShardKey.isOK())
+            return swShardKey.getStatus();
 
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = std::move(swShardKey.getValue());
     }
 
     // Target the shard key or database primary
@@ -315,6 +306,49 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
     return Status::OK();
 }
 
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    const auto& cm = _routingInfo->cm();
+    if (!cm) {
+        // All the documents go to the database primary
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    // Extract (and hash, for hashed shard keys) all the shard keys up front, so that the chunks
+    // for the whole batch can be located together
+    std::vector<BSONObj> shardKeys(docs.size());
+    std::vector<Status> keyStatuses(docs.size(), Status::OK());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        auto swShardKey = _extractInsertShardKey(docs[i]);
+        if (swShardKey.isOK()) {
+            shardKeys[i] = std::move(swShardKey.getValue());
+        } else {
+            keyStatuses[i] = swShardKey.getStatus();
+        }
+    }
+
+    const auto chunks = cm->findIntersectingChunksWithSimpleCollation(shardKeys);
+
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        if (!keyStatuses[i].isOK()) {
+            endpoints.emplace_back(std::move(keyStatuses[i]));
+            continue;
+        }
+
+        const auto& chunk = *chunks[i];
+
+        // Track autosplit stats, same as _targetShardKey
+        _stats->chunkSizeDelta[chunk.getMin()] += docs[i].objsize();
+
+        const auto& shardId = chunk.getShardId();
+        endpoints.emplace_back(ShardEndpoint(shardId, cm->getVersion(shardId)));
+    }
+
+    return endpoints;
+}
+
 StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::targetUpdate(
     OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const {
     //
@@ -554,6 +588,26 @@ StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::_targetQuery(
     return endpoints;
 }
 
+StatusWith<BSONObj> ChunkManagerTargeter::_extractInsertShardKey(const BSONObj& doc) const {
+    const auto& shardKeyPattern = _routingInfo->cm()->getShardKeyPattern();
+
+    BSONObj shardKey = shardKeyPattern.extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return {ErrorCodes::ShardKeyNotFound,
+                str::stream() << "document " << doc << " does not contain shard key for pattern "
+                              << shardKeyPattern.toString()};
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 ShardEndpoint ChunkManagerTargeter::_targetShardKey(const BSONObj& shardKey,
                                                     const BSONObj& collation,
                                                     long long estDataSize) const {
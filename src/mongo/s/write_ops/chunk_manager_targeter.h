@@ -70,6 +70,11 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    // Sorts the shard keys of the documents and locates their chunks in a single pass over the
+    // routing table. Reports ShardKeyNotFound for the documents without a full shard key.
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -105,6 +110,14 @@ private:
      */
     Status _refreshNow(OperationContext* opCtx);
 
+    /**
+     * Extracts the shard key of a document being inserted into a sharded collection.
+     *
+     * Returns ShardKeyNotFound if the document does not contain the full shard key, or an error if
+     * the shard key is too large.
+     */
+    StatusWith<BSONObj> _extractInsertShardKey(const BSONObj& doc) const;
+
     /**
      * Returns a vector of ShardEndpoints where a document might need to be placed.
      *
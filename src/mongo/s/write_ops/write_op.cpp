@@ -90,8 +90,30 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     if (!swEndpoints.isOK())
         return swEndpoints.getStatus();
 
-    auto& endpoints = swEndpoints.getValue();
+    _addTargetedWrites(std::move(swEndpoints.getValue()), targetedWrites);
+    return Status::OK();
+}
+
+Status WriteOp::targetInsert(StatusWith<ShardEndpoint> swEndpoint,
+                             std::vector<TargetedWrite*>* targetedWrites) {
+    invariant(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+    invariant(!_itemRef.getRequest()->isInsertIndexRequest());
+
+    if (!swEndpoint.isOK())
+        return swEndpoint.getStatus();
 
+    _addTargetedWrites({std::move(swEndpoint.getValue())}, targetedWrites);
+    return Status::OK();
+}
+
+void WriteOp::targetEndpoints(std::vector<ShardEndpoint> endpoints,
+                              std::vector<TargetedWrite*>* targetedWrites) {
+    invariant(!endpoints.empty());
+    _addTargetedWrites(std::move(endpoints), targetedWrites);
+}
+
+void WriteOp::_addTargetedWrites(std::vector<ShardEndpoint> endpoints,
+                                 std::vector<TargetedWrite*>* targetedWrites) {
     for (auto&& endpoint : endpoints) {
         _childOps.emplace_back(this);
 
@@ -109,7 +131,6 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     }
 
     _state = WriteOpState_Pending;
-    return Status::OK();
 }
 
 size_t WriteOp::getNumTargeted() {
@@ -121,6 +121,20 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as targetWrites, but for an insert whose endpoint was already determined by the caller,
+     * for example by targeting it together with the other inserts of the batch.
+     */
+    Status targetInsert(StatusWith<ShardEndpoint> swEndpoint,
+                        std::vector<TargetedWrite*>* targetedWrites);
+
+    /**
+     * Same as targetWrites, but to endpoints which the caller kept from an earlier targeting of
+     * this write against the same routing information.
+     */
+    void targetEndpoints(std::vector<ShardEndpoint> endpoints,
+                         std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -164,6 +178,12 @@ private:
      */
     void _updateOpState();
 
+    /**
+     * Creates a TargetedWrite and a pending child op for each of 'endpoints'.
+     */
+    void _addTargetedWrites(std::vector<ShardEndpoint> endpoints,
+                            std::vector<TargetedWrite*>* targetedWrites);
+
     // Owned elsewhere, reference to a batch with a write item
     const BatchItemRef _itemRef;
 
@@ -32,7 +32,9 @@
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
 
+#include <memory>
 #include <type_traits>
 
 namespace mongo {
@@ -40,12 +42,37 @@ enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
     kZlib = 2,
+    // Later server versions and drivers assign 3 to zstd, so the lz4 compressors use ids which no
+    // other implementation assigns, and which a mixed-version peer cannot mistake for its own.
+    kLZ4 = 128,
+    kLZ4Stream = 129,
     kExtended = 255,
 };
 
 StringData getMessageCompressorName(MessageCompressor id);
 using MessageCompressorId = std::underlying_type<MessageCompressor>::type;
 
+/**
+ * Compression state kept for one direction of a single connection, for compressors whose output
+ * depends on the messages which preceded it on that connection. Messages must be decompressed in
+ * the order in which they were compressed, by the context of the opposite end of the connection.
+ */
+class MessageCompressorContext {
+public:
+    virtual ~MessageCompressorContext() = default;
+
+    /*
+     * Same as MessageCompressorBase::compressData, except that it may refer to the contents of
+     * the messages previously compressed by this context.
+     */
+    virtual StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) = 0;
+
+    /*
+     * Same as MessageCompressorBase::decompressData, for the output of the peer's context.
+     */
+    virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
+};
+
 class MessageCompressorBase {
     MONGO_DISALLOW_COPYING(MessageCompressorBase);
 
@@ -53,7 +80,7 @@ public:
     virtual ~MessageCompressorBase() = default;
 
     /*
-     * Returns the name for subclass compressors (e.g. "snappy", "zlib", or "noop")
+     * Returns the name for subclass compressors (e.g. "snappy", "zlib", "lz4", or "noop")
      */
     const std::string& getName() const {
         return _name;
@@ -86,6 +113,15 @@ public:
      */
     virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
 
+    /*
+     * Returns a new per-connection context for compressors which carry state from one message to
+     * the next. The MessageCompressorManager uses one context for each direction of a connection
+     * instead of compressData/decompressData. Stateless compressors return nullptr.
+     */
+    virtual std::unique_ptr<MessageCompressorContext> makeContext() {
+        return nullptr;
+    }
+
     /*
      * This returns the number of bytes passed in the input for compressData
      */
@@ -114,6 +150,31 @@ public:
         return _decompressBytesOut.loadRelaxed();
     }
 
+    /*
+     * This returns the total time spent in compressData
+     */
+    Microseconds getCompressorTime() const {
+        return Microseconds(_compressMicros.loadRelaxed());
+    }
+
+    /*
+     * This returns the total time spent in decompressData
+     */
+    Microseconds getDecompressorTime() const {
+        return Microseconds(_decompressMicros.loadRelaxed());
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for the time spent compressing and
+     * decompressing messages
+     */
+    void counterHitCompressTime(Microseconds elapsed) {
+        _compressMicros.addAndFetch(durationCount<Microseconds>(elapsed));
+    }
+
+    void counterHitDecompressTime(Microseconds elapsed) {
+        _decompressMicros.addAndFetch(durationCount<Microseconds>(elapsed));
+    }
 
 protected:
     /*
@@ -148,5 +209,8 @@ private:
 
     AtomicInt64 _decompressBytesIn;
     AtomicInt64 _decompressBytesOut;
+
+    AtomicInt64 _compressMicros;
+    AtomicInt64 _decompressMicros;
 };
 }  // namespace mongo
@@ -0,0 +1,369 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_lz4.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/mongoutils/str.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <lz4.h>
+#include <lz4hc.h>
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(lz4NetworkCompressionLevel, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "lz4NetworkCompressionLevel must be between 0 and 16");
+        }
+        return Status::OK();
+    });
+
+namespace {
+
+// Block types of the lz4stream format
+const char kIndependentBlock = 0;
+const char kStreamedBlock = 1;
+
+const std::size_t kIndependentBlockHeaderSize = 1;
+const std::size_t kStreamedBlockHeaderSize = 1 + sizeof(uint32_t);
+
+// Size of the ring buffer holding the recent history of the streamed blocks of a connection. Both
+// ends place every block at the same offset of their ring buffers, which is what allows LZ4 to
+// refer back into them.
+const std::size_t kHistoryBufferSize = 64 * 1024;
+
+int clampToInt(std::size_t length) {
+    return static_cast<int>(
+        std::min(length, static_cast<std::size_t>(std::numeric_limits<int>::max())));
+}
+
+/**
+ * Compresses 'input' into 'output' as a single LZ4 block, using the LZ4HC encoder if a non-zero
+ * lz4NetworkCompressionLevel is configured.
+ */
+StatusWith<std::size_t> compressBlock(ConstDataRange input, DataRange output) {
+    if (input.length() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        return Status{ErrorCodes::BadValue, "Input too large to compress"};
+    }
+
+    const int level = lz4NetworkCompressionLevel.load();
+    const int outLength = (level == 0)
+        ? LZ4_compress_default(input.data(),
+                               const_cast<char*>(output.data()),
+                               static_cast<int>(input.length()),
+                               clampToInt(output.length()))
+        : LZ4_compress_HC(input.data(),
+                          const_cast<char*>(output.data()),
+                          static_cast<int>(input.length()),
+                          clampToInt(output.length()),
+                          level);
+
+    if (outLength <= 0) {
+        return Status{ErrorCodes::BadValue, "Could not compress input"};
+    }
+    return {static_cast<std::size_t>(outLength)};
+}
+
+/**
+ * Decompresses the single LZ4 block 'input', which must expand to exactly the size of 'output'.
+ */
+StatusWith<std::size_t> decompressBlock(ConstDataRange input, DataRange output) {
+    if (input.length() > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        output.length() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    const int length = LZ4_decompress_safe(input.data(),
+                                           const_cast<char*>(output.data()),
+                                           static_cast<int>(input.length()),
+                                           static_cast<int>(output.length()));
+
+    if (length < 0 || static_cast<size_t>(length) != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+    return {output.length()};
+}
+
+StatusWith<std::size_t> compressIndependentBlock(ConstDataRange input, DataRange output) {
+    if (output.length() < kIndependentBlockHeaderSize) {
+        return Status{ErrorCodes::BadValue, "Output too small for max size of compressed input"};
+    }
+
+    char* const outputData = const_cast<char*>(output.data());
+    auto sws = compressBlock(
+        input,
+        DataRange(outputData + kIndependentBlockHeaderSize, outputData + output.length()));
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    *outputData = kIndependentBlock;
+    return {kIndependentBlockHeaderSize + sws.getValue()};
+}
+
+StatusWith<std::size_t> decompressIndependentBlock(ConstDataRange input, DataRange output) {
+    if (input.length() < kIndependentBlockHeaderSize || input.data()[0] != kIndependentBlock) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    return decompressBlock(ConstDataRange(input.data() + kIndependentBlockHeaderSize,
+                                          input.data() + input.length()),
+                           output);
+}
+
+}  // namespace
+
+LZ4MessageCompressor::LZ4MessageCompressor() : MessageCompressorBase(MessageCompressor::kLZ4) {}
+
+std::size_t LZ4MessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return LZ4_COMPRESSBOUND(inputSize);
+}
+
+StatusWith<std::size_t> LZ4MessageCompressor::compressData(ConstDataRange input,
+                                                           DataRange output) {
+    auto sws = compressBlock(input, output);
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    counterHitCompress(input.length(), sws.getValue());
+    return sws;
+}
+
+StatusWith<std::size_t> LZ4MessageCompressor::decompressData(ConstDataRange input,
+                                                             DataRange output) {
+    auto sws = decompressBlock(input, output);
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return sws;
+}
+
+/**
+ * Streaming state of one direction of a connection. The sending end compresses each streamed block
+ * from its ring buffer and the receiving end decompresses it into the same offset of its own ring
+ * buffer, so that the history both ends refer to stays identical.
+ */
+class LZ4StreamMessageCompressor::Context final : public MessageCompressorContext {
+public:
+    explicit Context(LZ4StreamMessageCompressor* compressor) : _compressor(compressor) {}
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override {
+        if (input.length() > kMaxStreamedMessageSize) {
+            return _compressor->compressData(input, output);
+        }
+
+        if (_failed) {
+            return Status{ErrorCodes::BadValue, "Compression stream is in an invalid state"};
+        }
+
+        if (output.length() < kStreamedBlockHeaderSize) {
+            return Status{ErrorCodes::BadValue,
+                          "Output too small for max size of compressed input"};
+        }
+
+        if (!_encoder) {
+            _encoder = stdx::make_unique<LZ4_stream_t>();
+            LZ4_resetStream(_encoder.get());
+        }
+
+        char* const block = _nextBlockInHistory(input.length());
+        std::memcpy(block, input.data(), input.length());
+
+        const int outLength =
+            LZ4_compress_fast_continue(_encoder.get(),
+                                       block,
+                                       const_cast<char*>(output.data()) + kStreamedBlockHeaderSize,
+                                       static_cast<int>(input.length()),
+                                       clampToInt(output.length() - kStreamedBlockHeaderSize),
+                                       1);
+        if (outLength <= 0) {
+            // The encoder has already taken the block into its history, which the peer will never
+            // see, so the stream cannot be continued
+            _failed = true;
+            return Status{ErrorCodes::BadValue, "Could not compress input"};
+        }
+
+        DataView header(const_cast<char*>(output.data()));
+        header.write<uint8_t>(kStreamedBlock);
+        header.write<LittleEndian<uint32_t>>(_sequenceNumber++, 1);
+        _historyOffset += input.length();
+
+        const std::size_t compressedLength = kStreamedBlockHeaderSize + outLength;
+        _compressor->counterHitCompress(input.length(), compressedLength);
+        return {compressedLength};
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        if (input.length() < 1) {
+            return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+        }
+
+        if (input.data()[0] != kStreamedBlock) {
+            return _compressor->decompressData(input, output);
+        }
+
+        if (_failed) {
+            return Status{ErrorCodes::BadValue, "Decompression stream is in an invalid state"};
+        }
+
+        if (input.length() < kStreamedBlockHeaderSize ||
+            output.length() > kMaxStreamedMessageSize) {
+            _failed = true;
+            return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+        }
+
+        const uint32_t sequenceNumber =
+            ConstDataView(input.data()).read<LittleEndian<uint32_t>>(1);
+        if (sequenceNumber != _sequenceNumber) {
+            _failed = true;
+            return Status{ErrorCodes::BadValue,
+                          str::stream() << "Compressed message out of sequence, expected "
+                                        << _sequenceNumber
+                                        << " but received "
+                                        << sequenceNumber};
+        }
+
+        if (!_decoder) {
+            _decoder = stdx::make_unique<LZ4_streamDecode_t>();
+            LZ4_setStreamDecode(_decoder.get(), nullptr, 0);
+        }
+
+        char* const block = _nextBlockInHistory(output.length());
+
+        const int length = LZ4_decompress_safe_continue(
+            _decoder.get(),
+            input.data() + kStreamedBlockHeaderSize,
+            block,
+            static_cast<int>(input.length() - kStreamedBlockHeaderSize),
+            static_cast<int>(output.length()));
+        if (length < 0 || static_cast<std::size_t>(length) != output.length()) {
+            _failed = true;
+            return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+        }
+
+        std::memcpy(const_cast<char*>(output.data()), block, output.length());
+        _historyOffset += output.length();
+        _sequenceNumber++;
+
+        _compressor->counterHitDecompress(input.length(), output.length());
+        return {output.length()};
+    }
+
+private:
+    /**
+     * Returns where the next block of 'length' bytes goes in the history ring buffer. Both ends of
+     * the stream wrap around at the same blocks, since they see the same sequence of lengths.
+     */
+    char* _nextBlockInHistory(std::size_t length) {
+        if (!_history) {
+            _history.reset(new char[kHistoryBufferSize]);
+        }
+
+        if (_historyOffset + length > kHistoryBufferSize) {
+            _historyOffset = 0;
+        }
+        return _history.get() + _historyOffset;
+    }
+
+    LZ4StreamMessageCompressor* const _compressor;
+
+    std::unique_ptr<LZ4_stream_t> _encoder;
+    std::unique_ptr<LZ4_streamDecode_t> _decoder;
+
+    std::unique_ptr<char[]> _history;
+    std::size_t _historyOffset{0};
+
+    // Sequence number of the next streamed block, used to detect that the two ends went out of sync
+    uint32_t _sequenceNumber{0};
+
+    // Set once the stream can no longer be continued, after which all streamed blocks fail
+    bool _failed{false};
+};
+
+constexpr std::size_t LZ4StreamMessageCompressor::kMaxStreamedMessageSize;
+
+LZ4StreamMessageCompressor::LZ4StreamMessageCompressor()
+    : MessageCompressorBase(MessageCompressor::kLZ4Stream) {}
+
+std::size_t LZ4StreamMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return kStreamedBlockHeaderSize + LZ4_COMPRESSBOUND(inputSize);
+}
+
+StatusWith<std::size_t> LZ4StreamMessageCompressor::compressData(ConstDataRange input,
+                                                                 DataRange output) {
+    auto sws = compressIndependentBlock(input, output);
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    counterHitCompress(input.length(), sws.getValue());
+    return sws;
+}
+
+StatusWith<std::size_t> LZ4StreamMessageCompressor::decompressData(ConstDataRange input,
+                                                                   DataRange output) {
+    auto sws = decompressIndependentBlock(input, output);
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return sws;
+}
+
+std::unique_ptr<MessageCompressorContext> LZ4StreamMessageCompressor::makeContext() {
+    return stdx::make_unique<Context>(this);
+}
+
+
+MONGO_INITIALIZER_GENERAL(LZ4MessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(stdx::make_unique<LZ4MessageCompressor>());
+    compressorRegistry.registerImplementation(stdx::make_unique<LZ4StreamMessageCompressor>());
+    return Status::OK();
+}
+}  // namespace mongo
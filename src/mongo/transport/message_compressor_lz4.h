@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/transport/message_compressor_base.h"
+
+namespace mongo {
+
+/**
+ * Compression level of the LZ4 network message compressor. Zero selects the fast LZ4 encoder,
+ * suited to low-latency links; 1 to 16 select increasingly thorough LZ4HC encoding, which trades
+ * compression CPU for a better ratio while decompression stays equally fast.
+ */
+extern AtomicInt32 lz4NetworkCompressionLevel;
+
+class LZ4MessageCompressor final : public MessageCompressorBase {
+public:
+    LZ4MessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+};
+
+/**
+ * LZ4 compressor which keeps its compression history across the messages of a connection, so that
+ * the field names, namespaces and metadata repeated from one message to the next compress even in
+ * small messages.
+ *
+ * Each compressed message starts with a one byte block type. Messages up to
+ * kMaxStreamedMessageSize are compressed as streamed blocks, which carry a four byte sequence
+ * number and refer to the recent history of the connection. Larger messages are compressed on
+ * their own and leave the history untouched. Outside of a per-connection context, only messages
+ * compressed on their own can be produced or read.
+ */
+class LZ4StreamMessageCompressor final : public MessageCompressorBase {
+public:
+    static constexpr std::size_t kMaxStreamedMessageSize = 16 * 1024;
+
+    LZ4StreamMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    std::unique_ptr<MessageCompressorContext> makeContext() override;
+
+private:
+    class Context;
+};
+
+
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -117,7 +118,7 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
         return {msg};
     }
 
-    auto outputMessageBuffer = SharedBuffer::allocate(bufferSize);
+    auto outputMessageBuffer = SharedBuffer::allocatePooled(bufferSize);
 
     MsgData::View outMessage(outputMessageBuffer.get());
     outMessage.setId(inputHeader.getId());
@@ -129,7 +130,12 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto context = _getContext(&_compressContexts, compressor);
+
+    Timer compressTimer;
+    auto sws = context ? context->compressData(input, output)
+                       : compressor->compressData(input, output);
+    compressor->counterHitCompressTime(compressTimer.elapsed());
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -167,7 +173,7 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
                 "Decompressed message would be larger than maximum message size"};
     }
 
-    auto outputMessageBuffer = SharedBuffer::allocate(bufferSize);
+    auto outputMessageBuffer = SharedBuffer::allocatePooled(bufferSize);
     MsgData::View outMessage(outputMessageBuffer.get());
     outMessage.setId(inputHeader.getId());
     outMessage.setResponseToMsgId(inputHeader.getResponseToMsgId());
@@ -176,7 +182,12 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
 
     DataRangeCursor output(outMessage.data(), outMessage.data() + outMessage.dataLen());
 
-    auto sws = compressor->decompressData(input, output);
+    auto context = _getContext(&_decompressContexts, compressor);
+
+    Timer decompressTimer;
+    auto sws = context ? context->decompressData(input, output)
+                       : compressor->decompressData(input, output);
+    compressor->counterHitDecompressTime(decompressTimer.elapsed());
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -190,6 +201,15 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
     return {Message(outputMessageBuffer)};
 }
 
+MessageCompressorContext* MessageCompressorManager::_getContext(ContextMap* contexts,
+                                                               MessageCompressorBase* compressor) {
+    auto it = contexts->find(compressor->getId());
+    if (it == contexts->end()) {
+        it = contexts->emplace(compressor->getId(), compressor->makeContext()).first;
+    }
+    return it->second.get();
+}
+
 void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
     LOG(3) << "Starting client-side compression negotiation";
 
@@ -33,6 +33,8 @@
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace mongo {
@@ -126,8 +128,22 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    using ContextMap = std::map<MessageCompressorId, std::unique_ptr<MessageCompressorContext>>;
+
+    /*
+     * Returns the context of 'compressor' from 'contexts', creating it on first use, or nullptr if
+     * the compressor does not keep state across messages.
+     */
+    static MessageCompressorContext* _getContext(ContextMap* contexts,
+                                                 MessageCompressorBase* compressor);
+
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
+
+    // Per-connection state of the stateful compressors, separately for the messages sent and the
+    // messages received on this connection
+    ContextMap _compressContexts;
+    ContextMap _decompressContexts;
 };
 
 }  // namespace mongo
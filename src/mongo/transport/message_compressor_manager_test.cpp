@@ -33,6 +33,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/rpc/message.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_lz4.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
@@ -40,6 +41,7 @@
 #include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 #include <string>
 #include <vector>
@@ -233,6 +235,20 @@ TEST(ZlibMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
 }
 
+TEST(LZ4MessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<LZ4MessageCompressor>());
+}
+
+TEST(LZ4MessageCompressor, FidelityHighCompression) {
+    const int oldLevel = lz4NetworkCompressionLevel.load();
+    ON_BLOCK_EXIT([oldLevel] { lz4NetworkCompressionLevel.store(oldLevel); });
+    lz4NetworkCompressionLevel.store(9);
+
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<LZ4MessageCompressor>());
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<SnappyMessageCompressor>());
 }
@@ -241,6 +257,93 @@ TEST(ZlibMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<ZlibMessageCompressor>());
 }
 
+TEST(LZ4MessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<LZ4MessageCompressor>());
+}
+
+TEST(LZ4StreamMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<LZ4StreamMessageCompressor>());
+}
+
+TEST(LZ4StreamMessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<LZ4StreamMessageCompressor>());
+}
+
+Message buildMessageOfSize(size_t dataSize, char fill) {
+    const auto bufferSize = MsgData::MsgDataHeaderSize + dataSize;
+    auto buf = SharedBuffer::allocate(bufferSize);
+    MsgData::View testView(buf.get());
+    testView.setId(123456);
+    testView.setResponseToMsgId(654321);
+    testView.setOperation(dbQuery);
+    testView.setLen(bufferSize);
+    for (size_t i = 0; i < dataSize; i++) {
+        testView.data()[i] = fill + static_cast<char>(i % 7);
+    }
+    return Message{buf};
+}
+
+class LZ4StreamMessageCompressorTest : public unittest::Test {
+protected:
+    void setUp() override {
+        auto compressor = stdx::make_unique<LZ4StreamMessageCompressor>();
+        _registry.setSupportedCompressors({compressor->getName()});
+        _registry.registerImplementation(std::move(compressor));
+        ASSERT_OK(_registry.finalizeSupportedCompressors());
+
+        BSONObjBuilder clientOutput;
+        _clientManager.clientBegin(&clientOutput);
+        BSONObjBuilder serverOutput;
+        _serverManager.serverNegotiate(clientOutput.done(), &serverOutput);
+        _clientManager.clientFinish(serverOutput.done());
+    }
+
+    void assertRoundTrip(const Message& msg) {
+        auto compressed = assertOk(_clientManager.compressMessage(msg));
+        ASSERT_EQ(compressed.operation(), dbCompressed);
+
+        auto decompressed = assertOk(_serverManager.decompressMessage(compressed));
+        ASSERT_EQ(decompressed.size(), msg.size());
+        ASSERT_EQ(0, memcmp(decompressed.buf(), msg.buf(), msg.size()));
+    }
+
+    MessageCompressorRegistry _registry;
+    MessageCompressorManager _clientManager{&_registry};
+    MessageCompressorManager _serverManager{&_registry};
+};
+
+TEST_F(LZ4StreamMessageCompressorTest, RepeatedMessagesCompressAgainstHistory) {
+    const auto msg = buildMessageOfSize(200, 'a');
+
+    auto first = assertOk(_clientManager.compressMessage(msg));
+    auto second = assertOk(_clientManager.compressMessage(msg));
+    ASSERT_LT(second.size(), first.size());
+
+    assertOk(_serverManager.decompressMessage(first));
+    auto decompressed = assertOk(_serverManager.decompressMessage(second));
+    ASSERT_EQ(0, memcmp(decompressed.buf(), msg.buf(), msg.size()));
+}
+
+TEST_F(LZ4StreamMessageCompressorTest, RoundTripAcrossHistoryWraparound) {
+    // Mixes streamed and independently compressed messages and wraps around the history buffer
+    // several times
+    for (size_t i = 0; i < 100; i++) {
+        const size_t dataSize = (i % 10 == 9) ? 40 * 1024 : 100 + (i * 997) % (14 * 1024);
+        assertRoundTrip(buildMessageOfSize(dataSize, 'a' + static_cast<char>(i % 5)));
+    }
+}
+
+TEST_F(LZ4StreamMessageCompressorTest, OutOfSequenceMessageRejected) {
+    auto first = assertOk(_clientManager.compressMessage(buildMessageOfSize(200, 'a')));
+    auto second = assertOk(_clientManager.compressMessage(buildMessageOfSize(200, 'b')));
+
+    ASSERT_NOT_OK(_serverManager.decompressMessage(second).getStatus());
+
+    // The stream cannot be resumed once it went out of sync
+    ASSERT_NOT_OK(_serverManager.decompressMessage(first).getStatus());
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
@@ -54,6 +54,10 @@ StringData getMessageCompressorName(MessageCompressor id) {
             return "snappy"_sd;
         case MessageCompressor::kZlib:
             return "zlib"_sd;
+        case MessageCompressor::kLZ4:
+            return "lz4"_sd;
+        case MessageCompressor::kLZ4Stream:
+            return "lz4stream"_sd;
         default:
             fassert(40269, "Invalid message compressor ID");
     }
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+using namespace transport;
+
+// Connected sessions that aren't sending anything. To an asynchronous executor these are just
+// reads parked on the reactor, which are stood in for here by timers that never fire.
+const int kIdleSessions = 10000;
+
+// Sessions with a request in flight during each iteration.
+const int kActiveSessions = 1000;
+
+// The number of scheduled tasks each request goes through, standing in for the source, process
+// and sink states of a ServiceStateMachine.
+const int kTasksPerRequest = 3;
+
+enum class ExecutorKind { kAdaptive, kThreadPerCore };
+
+class ServiceExecutorBM : public benchmark::Fixture {
+public:
+    void SetUp(benchmark::State& state) override {
+        _reactor = _tl.getReactor(TransportLayer::kNewReactor);
+        for (int i = 0; i < kIdleSessions; i++) {
+            _idleSessions.emplace_back(_reactor->makeTimer());
+            _idleSessions.back()->waitFor(Hours{1}).getAsync([](Status) {});
+        }
+    }
+
+    void TearDown(benchmark::State& state) override {
+        _idleSessions.clear();
+        _reactor.reset();
+    }
+
+    /**
+     * Runs kActiveSessions concurrent requests per iteration through a freshly started executor
+     * and reports the median and 99th percentile request latency.
+     */
+    void runRequests(benchmark::State& state, ExecutorKind kind) {
+        auto ctx = getGlobalServiceContext();
+        std::unique_ptr<ServiceExecutor> executor;
+        if (kind == ExecutorKind::kAdaptive) {
+            executor = stdx::make_unique<ServiceExecutorAdaptive>(ctx, _reactor);
+        } else {
+            executor = stdx::make_unique<ServiceExecutorThreadPerCore>(ctx, _reactor);
+        }
+        invariant(executor->start());
+
+        std::vector<int64_t> latencies;
+        std::vector<int64_t> iterationLatencies(kActiveSessions);
+        stdx::mutex mutex;
+        stdx::condition_variable cond;
+        int outstanding;
+
+        for (auto keepRunning : state) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                outstanding = kActiveSessions;
+            }
+
+            for (int session = 0; session < kActiveSessions; session++) {
+                auto timer = std::make_shared<Timer>();
+                auto remaining = std::make_shared<int>(kTasksPerRequest);
+                auto step = std::make_shared<ServiceExecutor::Task>();
+                *step = [&, session, timer, remaining, step] {
+                    if (--*remaining > 0) {
+                        invariant(executor->schedule(*step,
+                                                     ServiceExecutor::kMayRecurse,
+                                                     ServiceExecutorTaskName::kSSMProcessMessage));
+                        return;
+                    }
+
+                    iterationLatencies[session] = timer->micros();
+                    *step = nullptr;
+
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    if (--outstanding == 0)
+                        cond.notify_all();
+                };
+                invariant(executor->schedule(*step,
+                                             ServiceExecutor::kEmptyFlags,
+                                             ServiceExecutorTaskName::kSSMSourceMessage));
+            }
+
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cond.wait(lk, [&] { return outstanding == 0; });
+            latencies.insert(latencies.end(), iterationLatencies.begin(), iterationLatencies.end());
+        }
+
+        invariant(executor->shutdown(Seconds{10}));
+
+        std::sort(latencies.begin(), latencies.end());
+        if (!latencies.empty()) {
+            state.counters["p50Micros"] = latencies[latencies.size() / 2];
+            state.counters["p99Micros"] = latencies[latencies.size() * 99 / 100];
+        }
+        state.SetItemsProcessed(state.iterations() * kActiveSessions);
+    }
+
+private:
+    TransportLayerASIO _tl{TransportLayerASIO::Options{}, nullptr};
+    ReactorHandle _reactor;
+    std::vector<std::unique_ptr<ReactorTimer>> _idleSessions;
+};
+
+BENCHMARK_DEFINE_F(ServiceExecutorBM, BM_Adaptive)(benchmark::State& state) {
+    runRequests(state, ExecutorKind::kAdaptive);
+}
+
+BENCHMARK_DEFINE_F(ServiceExecutorBM, BM_ThreadPerCore)(benchmark::State& state) {
+    runRequests(state, ExecutorKind::kThreadPerCore);
+}
+
+BENCHMARK_REGISTER_F(ServiceExecutorBM, BM_Adaptive)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(ServiceExecutorBM, BM_ThreadPerCore)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/transport/service_executor_adaptive.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -76,6 +77,20 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     }
 };
 
+struct ThreadPerCoreTestOptions : public ServiceExecutorThreadPerCore::Options {
+    int workerThreads() const final {
+        return 2;
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{100};
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+};
+
 /* This implements the portions of the transport::Reactor based on ASIO, but leaves out
  * the methods not needed by ServiceExecutors.
  *
@@ -100,6 +115,17 @@ public:
         }
     }
 
+    void runOneFor(Milliseconds time) noexcept final {
+        asio::io_context::work work(_ioContext);
+
+        try {
+            _ioContext.run_one_for(time.toSystemDuration());
+        } catch (...) {
+            severe() << "Uncaught exception in reactor: " << exceptionToStatus();
+            fassertFailed(50865);
+        }
+    }
+
     void stop() final {
         _ioContext.stop();
     }
@@ -161,6 +187,21 @@ protected:
     std::unique_ptr<ServiceExecutorSynchronous> executor;
 };
 
+class ServiceExecutorThreadPerCoreFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = stdx::make_unique<ServiceContextNoop>();
+        setGlobalServiceContext(std::move(scOwned));
+
+        executor = stdx::make_unique<ServiceExecutorThreadPerCore>(
+            getGlobalServiceContext(),
+            std::make_shared<ASIOReactor>(),
+            stdx::make_unique<ThreadPerCoreTestOptions>());
+    }
+
+    std::unique_ptr<ServiceExecutorThreadPerCore> executor;
+};
+
 void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
     stdx::condition_variable cond;
     stdx::mutex mutex;
@@ -202,6 +243,89 @@ TEST_F(ServiceExecutorSynchronousFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorThreadPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, IdleWorkerStealsFromBlockedWorker) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool secondRan = false;
+
+    // The first task queues the second onto its own worker and then blocks until the second has
+    // run, so the second can only run if the other worker steals it.
+    auto secondTask = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        secondRan = true;
+        cond.notify_all();
+    };
+    auto firstTask = [&] {
+        ASSERT_OK(executor->schedule(
+            secondTask, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return secondRan; });
+    };
+
+    ASSERT_OK(executor->schedule(
+        firstTask, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession));
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_TRUE(cond.wait_for(lk, stdx::chrono::seconds(5), [&] { return secondRan; }));
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj()["serviceExecutorTaskStats"].Obj();
+    ASSERT_EQ(stats["executor"].str(), "threadPerCore");
+    ASSERT_GTE(stats["totalStolen"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, StartsSpareThreadWhenAllWorkersBlocked) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int blocked = 0;
+    bool released = false;
+
+    auto blockingTask = [&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        ++blocked;
+        cond.notify_all();
+        cond.wait(lk, [&] { return released; });
+    };
+
+    for (int i = 0; i < 2; i++) {
+        ASSERT_OK(executor->schedule(blockingTask,
+                                     ServiceExecutor::kEmptyFlags,
+                                     ServiceExecutorTaskName::kSSMProcessMessage));
+    }
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        ASSERT_TRUE(cond.wait_for(lk, stdx::chrono::seconds(5), [&] { return blocked == 2; }));
+    }
+
+    // Both workers are blocked, so this only runs once the executor starts a spare thread.
+    scheduleBasicTask(executor.get(), true);
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GTE(bob.obj()["serviceExecutorTaskStats"]["stuckThreadsDetected"].numberLong(), 1);
+
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    released = true;
+    cond.notify_all();
+}
 
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,401 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_thread_per_core.h"
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/thread_idle_callback.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+// The number of worker threads, each with its own run queue. If the value is -1 (the default)
+// then it will be set to the number of cores.
+MONGO_EXPORT_SERVER_PARAMETER(threadPerCoreServiceExecutorThreads, int, -1);
+
+// The amount of time every worker may be busy without a new task starting before a spare worker
+// is started to keep servicing the network. Spare workers exit after being idle this long.
+MONGO_EXPORT_SERVER_PARAMETER(threadPerCoreServiceExecutorStuckThreadTimeoutMillis, int, 250);
+
+// Tasks scheduled with MayRecurse may be called recursively if the recursion depth is below this
+// value.
+MONGO_EXPORT_SERVER_PARAMETER(threadPerCoreServiceExecutorRecursionLimit, int, 8);
+
+// The longest an idle worker waits on the reactor before looking for work to steal again. Posting
+// work to another worker's queue wakes a waiting worker, so this only bounds missed wakeups.
+constexpr Milliseconds kIdlePollInterval{10};
+
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
+constexpr auto kTotalTimeQueuedUs = "totalTimeQueuedMicros"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kThreadsInUse = "threadsInUse"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kSpareThreadsRunning = "spareThreadsRunning"_sd;
+constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "threadPerCore"_sd;
+
+int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
+    invariant(tickSource->getTicksPerSecond() >= 1000000);
+    static const auto ticksPerMicro = tickSource->getTicksPerSecond() / 1000000;
+    return ticks / ticksPerMicro;
+}
+
+struct ServerParameterOptions : public ServiceExecutorThreadPerCore::Options {
+    int workerThreads() const final {
+        int value = threadPerCoreServiceExecutorThreads.load();
+        if (value == -1) {
+            value = ProcessInfo::getNumAvailableCores();
+            threadPerCoreServiceExecutorThreads.store(value);
+            log() << "No thread count configured for executor. Using number of cores: " << value;
+        }
+        return value;
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{threadPerCoreServiceExecutorStuckThreadTimeoutMillis.load()};
+    }
+
+    int recursionLimit() const final {
+        return threadPerCoreServiceExecutorRecursionLimit.load();
+    }
+};
+
+}  // namespace
+
+thread_local ServiceExecutorThreadPerCore::ThreadState*
+    ServiceExecutorThreadPerCore::_localThreadState = nullptr;
+
+ServiceExecutorThreadPerCore::ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                                           ReactorHandle reactor)
+    : ServiceExecutorThreadPerCore(
+          ctx, std::move(reactor), stdx::make_unique<ServerParameterOptions>()) {}
+
+ServiceExecutorThreadPerCore::ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                                           ReactorHandle reactor,
+                                                           std::unique_ptr<Options> config)
+    : _reactorHandle(std::move(reactor)),
+      _config(std::move(config)),
+      _tickSource(ctx->getTickSource()) {}
+
+ServiceExecutorThreadPerCore::~ServiceExecutorThreadPerCore() {
+    invariant(!_isRunning.load());
+}
+
+Status ServiceExecutorThreadPerCore::start() {
+    invariant(!_isRunning.load());
+    if (_workers.empty()) {
+        const auto numWorkers = std::max(_config->workerThreads(), 1);
+        for (auto i = 0; i < numWorkers; i++) {
+            _workers.emplace_back(stdx::make_unique<Worker>(i));
+        }
+    }
+
+    _isRunning.store(true);
+    _controllerThread =
+        stdx::thread(&ServiceExecutorThreadPerCore::_controllerThreadRoutine, this);
+    for (auto& worker : _workers) {
+        _startWorkerThread(worker.get());
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorThreadPerCore::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        _isRunning.store(false);
+    }
+    _controllerCondition.notify_one();
+    _controllerThread.join();
+
+    stdx::unique_lock<stdx::mutex> lk(_threadsMutex);
+    _reactorHandle->stop();
+    bool result = _deathCondition.wait_for(
+        lk, timeout.toSystemDuration(), [&] { return _threadsRunning.load() == 0; });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "thread-per-core executor couldn't shutdown all worker threads within time "
+                 "limit.");
+}
+
+Status ServiceExecutorThreadPerCore::schedule(Task task,
+                                              ScheduleFlags flags,
+                                              ServiceExecutorTaskName taskName) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    // This is only set on the executor's own threads.
+    auto state = _localThreadState;
+    if (state && (flags & kMayYieldBeforeSchedule) && (state->markIdleCounter++ & 0xf) == 0) {
+        markThreadIdle();
+    }
+
+    _totalQueued.addAndFetch(1);
+
+    // If the task is allowed to recurse and we are not over the depth limit, run it right away
+    // on this thread. This skips the queue entirely, so the task stays on this core.
+    if (state && (flags & kMayRecurse) && (state->recursionDepth + 1 < _config->recursionLimit())) {
+        _runTask(task);
+        return Status::OK();
+    }
+
+    auto scheduleTime = _tickSource->getTicks();
+    Task wrappedTask = [ this, task = std::move(task), scheduleTime ] {
+        _totalSpentQueued.addAndFetch(_tickSource->getTicks() - scheduleTime);
+        task();
+    };
+
+    // Work scheduled from one of the workers is a continuation of a session that worker is
+    // running, so keep it on that worker's queue. Everything else is spread round-robin.
+    auto localWorker = state ? state->worker : nullptr;
+    auto worker = localWorker;
+    if (!worker) {
+        worker = _workers[_nextWorker.fetchAndAdd(1) % _workers.size()].get();
+    }
+
+    // If the task went onto another worker's queue, or onto our own queue behind other work,
+    // wake up a worker waiting on the reactor so it can steal it if the owner is busy.
+    if (_enqueue(worker, std::move(wrappedTask)) || worker != localWorker) {
+        _wakeIdleWorker();
+    }
+
+    return Status::OK();
+}
+
+bool ServiceExecutorThreadPerCore::_enqueue(Worker* worker, Task task) {
+    stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+    worker->queue.emplace_back(std::move(task));
+    _tasksQueued.addAndFetch(1);
+    return worker->queue.size() > 1;
+}
+
+bool ServiceExecutorThreadPerCore::_takeTask(Task* task) {
+    if (_tasksQueued.load() == 0)
+        return false;
+
+    const auto localWorker = _localThreadState->worker;
+    if (localWorker) {
+        stdx::lock_guard<stdx::mutex> lk(localWorker->mutex);
+        if (!localWorker->queue.empty()) {
+            *task = std::move(localWorker->queue.front());
+            localWorker->queue.pop_front();
+            _tasksQueued.subtractAndFetch(1);
+            return true;
+        }
+    }
+
+    // The owner of a queue runs it from the front, so steal from the back: that is the task that
+    // would otherwise wait the longest.
+    const size_t numWorkers = _workers.size();
+    const size_t first = localWorker ? localWorker->id + 1 : _nextWorker.load();
+    for (size_t i = 0; i < numWorkers; i++) {
+        auto victim = _workers[(first + i) % numWorkers].get();
+        if (victim == localWorker)
+            continue;
+
+        stdx::lock_guard<stdx::mutex> lk(victim->mutex);
+        if (victim->queue.empty())
+            continue;
+
+        *task = std::move(victim->queue.back());
+        victim->queue.pop_back();
+        _tasksQueued.subtractAndFetch(1);
+        _totalStolen.addAndFetch(1);
+        return true;
+    }
+
+    return false;
+}
+
+void ServiceExecutorThreadPerCore::_runTask(Task& task) {
+    auto state = _localThreadState;
+    auto start = _tickSource->getTicks();
+    if (state->recursionDepth++ == 0) {
+        _threadsInUse.addAndFetch(1);
+    }
+    _totalStarted.addAndFetch(1);
+
+    const auto guard = MakeGuard([this, state, start] {
+        if (--state->recursionDepth == 0) {
+            _threadsInUse.subtractAndFetch(1);
+            _totalSpentExecuting.addAndFetch(_tickSource->getTicks() - start);
+        }
+        _totalExecuted.addAndFetch(1);
+    });
+
+    task();
+}
+
+void ServiceExecutorThreadPerCore::_wakeIdleWorker() {
+    // Running any handler makes a worker waiting in runOneFor() return and look for work again.
+    _reactorHandle->schedule(Reactor::kPost, [] {});
+}
+
+void ServiceExecutorThreadPerCore::_startWorkerThread(Worker* worker) {
+    const auto threadId = _threadsStarted.fetchAndAdd(1);
+    _threadsRunning.addAndFetch(1);
+    if (!worker) {
+        _sparesRunning.addAndFetch(1);
+    }
+
+    const auto launchResult = launchServiceWorkerThread(
+        [this, worker, threadId] { _workerThreadRoutine(worker, threadId); });
+
+    if (!launchResult.isOK()) {
+        // Anything already on this worker's queue is still reachable by stealing.
+        warning() << "Failed to launch new worker thread: " << launchResult;
+        if (!worker) {
+            _sparesRunning.subtractAndFetch(1);
+        }
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        _threadsRunning.subtractAndFetch(1);
+        _deathCondition.notify_all();
+    }
+}
+
+void ServiceExecutorThreadPerCore::_workerThreadRoutine(Worker* worker, int threadId) {
+    ThreadState state;
+    state.worker = worker;
+    _localThreadState = &state;
+    {
+        std::string threadName = str::stream() << "worker-" << threadId;
+        setThreadName(threadName);
+    }
+
+    log() << "Started new database worker thread " << threadId
+          << (worker ? "" : " to unblock the service executor");
+
+    const auto guard = MakeGuard([this, worker] {
+        _localThreadState = nullptr;
+        if (!worker) {
+            _sparesRunning.subtractAndFetch(1);
+        }
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        _threadsRunning.subtractAndFetch(1);
+        _deathCondition.notify_all();
+    });
+
+    auto lastTaskTicks = _tickSource->getTicks();
+    Task task;
+    while (_isRunning.load()) {
+        if (_takeTask(&task)) {
+            _runTask(task);
+            task = nullptr;
+            lastTaskTicks = _tickSource->getTicks();
+            continue;
+        }
+
+        // Spare workers only exist to get past blocked workers, so once there's nothing left for
+        // them to do they exit.
+        if (!worker) {
+            Microseconds idle{ticksToMicros(_tickSource->getTicks() - lastTaskTicks, _tickSource)};
+            if (idle >= _config->stuckThreadTimeout()) {
+                log() << "Spare worker thread was idle for " << duration_cast<Milliseconds>(idle)
+                      << ". Exiting thread.";
+                break;
+            }
+        }
+
+        // Wait for a network event, or for schedule() to wake us up to steal work. Completion
+        // handlers that run here schedule their continuations onto this worker's queue.
+        _reactorHandle->runOneFor(kIdlePollInterval);
+    }
+}
+
+/*
+ * Every worker may be running a task that blocks for a long time, leaving nobody to service the
+ * reactor or drain the run queues. While the executor is running, the controller wakes up every
+ * stuckThreadTimeout() and, if every thread has been busy and no new task has started since it
+ * last looked, starts a spare worker to keep the executor making progress.
+ */
+void ServiceExecutorThreadPerCore::_controllerThreadRoutine() {
+    setThreadName("worker-controller"_sd);
+
+    auto lastStarted = _totalStarted.load();
+    stdx::unique_lock<stdx::mutex> lk(_threadsMutex);
+    while (_isRunning.load()) {
+        _controllerCondition.wait_for(lk,
+                                      _config->stuckThreadTimeout().toSystemDuration(),
+                                      [this] { return !_isRunning.load(); });
+        if (!_isRunning.load())
+            break;
+
+        auto started = _totalStarted.load();
+        bool stuck = (started == lastStarted) && (_threadsInUse.load() >= _threadsRunning.load());
+        lastStarted = started;
+        if (!stuck)
+            continue;
+
+        _stuckThreadsDetected.addAndFetch(1);
+        log() << "Detected blocked worker threads, "
+              << "starting new thread to unblock service executor.";
+
+        lk.unlock();
+        _startWorkerThread(nullptr);
+        lk.lock();
+    }
+}
+
+void ServiceExecutorThreadPerCore::appendStats(BSONObjBuilder* bob) const {
+    BSONObjBuilder section(bob->subobjStart("serviceExecutorTaskStats"));
+    section << kExecutorLabel << kExecutorName                                                  //
+            << kTotalQueued << _totalQueued.load()                                              //
+            << kTotalExecuted << _totalExecuted.load()                                          //
+            << kTotalStolen << _totalStolen.load()                                              //
+            << kTasksQueued << _tasksQueued.load()                                              //
+            << kThreadsInUse << _threadsInUse.load()                                            //
+            << kThreadsRunning << _threadsRunning.load()                                        //
+            << kSpareThreadsRunning << _sparesRunning.load()                                    //
+            << kStuckDetection << _stuckThreadsDetected.load()                                  //
+            << kTotalTimeExecutingUs << ticksToMicros(_totalSpentExecuting.load(), _tickSource)  //
+            << kTotalTimeQueuedUs << ticksToMicros(_totalSpentQueued.load(), _tickSource);
+    section.doneFast();
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * This is an ASIO-based ServiceExecutor that runs a fixed number of worker threads, one per
+ * available core by default. Each worker owns a local run queue. Tasks scheduled from a worker
+ * thread - the continuations of the ServiceStateMachines it is running - go onto that worker's
+ * queue, so a session tends to stay on the core that last ran it. Tasks scheduled from any other
+ * thread are spread round-robin across the workers.
+ *
+ * A worker with nothing in its own queue steals from the other workers' queues before waiting on
+ * the reactor for network events. Because a task may block (on a lock, on disk, on a remote
+ * host), a controller thread watches for every worker being busy without any task having started
+ * for the stuck thread timeout, and starts a spare worker when that happens. Spare workers have
+ * no queue of their own and exit once they have been idle for the stuck thread timeout.
+ */
+class ServiceExecutorThreadPerCore final : public ServiceExecutor {
+public:
+    struct Options {
+        virtual ~Options() = default;
+        // The number of long-lived worker threads, each with its own run queue.
+        virtual int workerThreads() const = 0;
+
+        // The amount of time every worker may be busy without a new task starting before the
+        // controller starts a spare worker. Spare workers also exit after being idle this long.
+        virtual Milliseconds stuckThreadTimeout() const = 0;
+
+        // Tasks scheduled with MayRecurse may be called recursively if the recursion depth is
+        // below this value.
+        virtual int recursionLimit() const = 0;
+    };
+
+    explicit ServiceExecutorThreadPerCore(ServiceContext* ctx, ReactorHandle reactor);
+    explicit ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                          ReactorHandle reactor,
+                                          std::unique_ptr<Options> config);
+
+    ~ServiceExecutorThreadPerCore();
+
+    Status start() final;
+    Status shutdown(Milliseconds timeout) final;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) final;
+
+    Mode transportMode() const final {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const final;
+
+private:
+    struct Worker {
+        explicit Worker(int id) : id(id) {}
+
+        const int id;
+        stdx::mutex mutex;
+        std::deque<Task> queue;
+    };
+
+    struct ThreadState {
+        // The worker whose queue this thread drains, or nullptr for spare workers.
+        Worker* worker = nullptr;
+        int recursionDepth = 0;
+        int64_t markIdleCounter = 0;
+    };
+
+    void _controllerThreadRoutine();
+    void _startWorkerThread(Worker* worker);
+    void _workerThreadRoutine(Worker* worker, int threadId);
+
+    /*
+     * Pushes a task onto a worker's queue. Returns true if the queue already had work waiting,
+     * that is, if the owning worker won't get to this task right away.
+     */
+    bool _enqueue(Worker* worker, Task task);
+
+    /*
+     * Pops the next task from this thread's own queue, or failing that steals one from the back
+     * of another worker's queue. Returns false if there was nothing to run.
+     */
+    bool _takeTask(Task* task);
+
+    void _runTask(Task& task);
+    void _wakeIdleWorker();
+
+    static thread_local ThreadState* _localThreadState;
+
+    ReactorHandle _reactorHandle;
+    std::unique_ptr<Options> _config;
+    TickSource* _tickSource;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    AtomicWord<unsigned> _nextWorker{0};
+
+    AtomicWord<bool> _isRunning{false};
+
+    mutable stdx::mutex _threadsMutex;
+    stdx::condition_variable _deathCondition;
+    stdx::condition_variable _controllerCondition;
+    stdx::thread _controllerThread;
+
+    AtomicWord<int> _threadsStarted{0};
+    AtomicWord<int> _threadsRunning{0};
+    AtomicWord<int> _threadsInUse{0};
+    AtomicWord<int> _sparesRunning{0};
+
+    AtomicWord<int64_t> _tasksQueued{0};
+    AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int64_t> _totalStarted{0};
+    AtomicWord<int64_t> _totalExecuted{0};
+    AtomicWord<int64_t> _totalStolen{0};
+    AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    AtomicWord<TickSource::Tick> _totalSpentExecuting{0};
+    AtomicWord<int64_t> _stuckThreadsDetected{0};
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/rpc/message.h"
 #include "mongo/stdx/memory.h"
@@ -53,6 +54,16 @@
 #include "mongo/util/quick_exit.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(maxPipelinedRequestsPerConnection, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 128) {
+            return Status(ErrorCodes::BadValue,
+                          "maxPipelinedRequestsPerConnection must be between 1 and 128");
+        }
+        return Status::OK();
+    });
+
 namespace {
 // Set up proper headers for formatting an exhaust request, if we need to
 bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
@@ -87,6 +98,13 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Set up an OP_MSG request to be run again for exhaust. The request itself is reused; it takes the
+// reply's id so that each reply in the stream responds to the one before it.
+void setOpMsgExhaustMessage(Message* m, Message* response) {
+    OpMsg::setFlag(response, OpMsg::kMoreToCome);
+    m->header().setId(response->header().getId());
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -238,6 +256,18 @@ const transport::SessionHandle& ServiceStateMachine::_session() const {
 void ServiceStateMachine::_sourceMessage(ThreadGuard guard) {
     invariant(_inMessage.empty());
     invariant(_state.load() == State::Source);
+
+    if (!_pipelined && _transportMode == transport::Mode::kAsynchronous) {
+        const int depth = maxPipelinedRequestsPerConnection.load();
+        if (depth > 1 && _session()->supportsConcurrentSourceAndSink()) {
+            _pipelined = true;
+            _pipelineDepth = depth;
+        }
+    }
+    if (_pipelined) {
+        return _sourcePipelinedMessage(std::move(guard));
+    }
+
     _state.store(State::SourceWait);
     guard.release();
 
@@ -288,7 +318,6 @@ void ServiceStateMachine::_sourceCallback(Status status) {
 
     // Make sure we just called sourceMessage();
     dassert(state() == State::SourceWait);
-    auto remote = _session()->remote();
 
     if (status.isOK()) {
         _state.store(State::Process);
@@ -303,23 +332,181 @@ void ServiceStateMachine::_sourceCallback(Status status) {
         return _scheduleNextWithGuard(std::move(guard),
                                       ServiceExecutor::kMayRecurse,
                                       transport::ServiceExecutorTaskName::kSSMProcessMessage);
-    } else if (ErrorCodes::isInterruption(status.code()) ||
-               ErrorCodes::isNetworkError(status.code())) {
+    }
+
+    _logSourceError(status);
+    _state.store(State::EndSession);
+
+    // There was an error receiving a message from the client and we've already printed the error
+    // so call runNextInGuard() to clean up the session without waiting.
+    _runNextInGuard(std::move(guard));
+}
+
+void ServiceStateMachine::_logSourceError(const Status& status) {
+    auto remote = _session()->remote();
+
+    if (ErrorCodes::isInterruption(status.code()) || ErrorCodes::isNetworkError(status.code())) {
         LOG(2) << "Session from " << remote << " encountered a network error during SourceMessage";
-        _state.store(State::EndSession);
     } else if (status == TransportLayer::TicketSessionClosedStatus) {
         // Our session may have been closed internally.
         LOG(2) << "Session from " << remote << " was closed internally during SourceMessage";
-        _state.store(State::EndSession);
     } else {
         log() << "Error receiving request from client: " << status << ". Ending connection from "
               << remote << " (connection id: " << _session()->id() << ")";
+    }
+}
+
+void ServiceStateMachine::_sourcePipelinedMessage(ThreadGuard guard) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+
+    if (!_readAheadMessages.empty()) {
+        _inMessage = std::move(_readAheadMessages.front());
+        _readAheadMessages.pop_front();
+        _state.store(State::Process);
+        _pumpPipelinedIO(std::move(lk));
+        return _scheduleNextWithGuard(std::move(guard),
+                                      ServiceExecutor::kMayRecurse,
+                                      transport::ServiceExecutorTaskName::kSSMProcessMessage);
+    }
+
+    if (!_pipelineStatus.isOK()) {
+        lk.unlock();
         _state.store(State::EndSession);
+        return _runNextInGuard(std::move(guard));
     }
 
-    // There was an error receiving a message from the client and we've already printed the error
-    // so call runNextInGuard() to clean up the session without waiting.
-    _runNextInGuard(std::move(guard));
+    // Release the state machine before anyone can see that it is waiting, so that the callback
+    // for the read ahead can take it over.
+    _state.store(State::SourceWait);
+    guard.release();
+    _pumpPipelinedIO(std::move(lk));
+}
+
+void ServiceStateMachine::_sinkPipelinedMessage(ThreadGuard guard, Message toSink) {
+    invariant(_state.load() == State::Process);
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+
+    if (!_pipelineStatus.isOK()) {
+        lk.unlock();
+        _state.store(State::EndSession);
+        return _runNextInGuard(std::move(guard));
+    }
+
+    _pendingReplies.push_back(std::move(toSink));
+    if (_pendingReplyCount() >= _pipelineDepth) {
+        // The client isn't reading replies as fast as they are produced, so wait for some to be
+        // sent before doing any more work.
+        _state.store(State::SinkWait);
+        guard.release();
+        return _pumpPipelinedIO(std::move(lk));
+    }
+
+    const bool inExhaust = _inExhaust;
+    _state.store(inExhaust ? State::Process : State::Source);
+    _pumpPipelinedIO(std::move(lk));
+    _scheduleNextWithGuard(std::move(guard),
+                           ServiceExecutor::kDeferredTask |
+                               ServiceExecutor::kMayYieldBeforeSchedule,
+                           inExhaust ? transport::ServiceExecutorTaskName::kSSMExhaustMessage
+                                     : transport::ServiceExecutorTaskName::kSSMSourceMessage);
+}
+
+void ServiceStateMachine::_pumpPipelinedIO(stdx::unique_lock<stdx::mutex> lk) {
+    invariant(lk.owns_lock());
+
+    boost::optional<Message> toSink;
+    bool startSource = false;
+    if (_pipelineStatus.isOK() && _state.load() != State::Ended) {
+        if (!_sinkInProgress && !_pendingReplies.empty()) {
+            toSink = std::move(_pendingReplies.front());
+            _pendingReplies.pop_front();
+            _sinkInProgress = true;
+        }
+        if (!_sourceInProgress && _readAheadMessages.size() < _pipelineDepth) {
+            _sourceInProgress = true;
+            startSource = true;
+        }
+    }
+    lk.unlock();
+
+    // Either operation may complete inline, so neither is started while holding the lock. The
+    // callbacks keep the state machine alive until the session has finished with it.
+    if (toSink) {
+        _session()->asyncSinkMessage(std::move(*toSink)).getAsync([ssm = shared_from_this()](
+            Status status) { ssm->_pipelinedSinkCallback(std::move(status)); });
+    }
+    if (startSource) {
+        _session()->asyncSourceMessage().getAsync([ssm = shared_from_this()](
+            StatusWith<Message> msg) { ssm->_pipelinedSourceCallback(std::move(msg)); });
+    }
+}
+
+void ServiceStateMachine::_pipelinedSourceCallback(StatusWith<Message> msg) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    _sourceInProgress = false;
+
+    if (msg.isOK()) {
+        invariant(!msg.getValue().empty());
+        _readAheadMessages.push_back(std::move(msg.getValue()));
+    } else if (_pipelineStatus.isOK() && _state.load() != State::Ended) {
+        _logSourceError(msg.getStatus());
+        _pipelineStatus = msg.getStatus();
+    }
+
+    _resumePipelinedSession(std::move(lk));
+}
+
+void ServiceStateMachine::_pipelinedSinkCallback(Status status) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    _sinkInProgress = false;
+
+    if (!status.isOK() && _pipelineStatus.isOK() && _state.load() != State::Ended) {
+        log() << "Error sending response to client: " << status << ". Ending connection from "
+              << _session()->remote() << " (connection id: " << _session()->id() << ")";
+        _pipelineStatus = status;
+    }
+
+    _resumePipelinedSession(std::move(lk));
+}
+
+void ServiceStateMachine::_resumePipelinedSession(stdx::unique_lock<stdx::mutex> lk) {
+    const auto state = _state.load();
+    auto next = state;
+    auto taskName = transport::ServiceExecutorTaskName::kSSMProcessMessage;
+
+    if (state == State::SourceWait) {
+        if (!_readAheadMessages.empty()) {
+            _inMessage = std::move(_readAheadMessages.front());
+            _readAheadMessages.pop_front();
+            next = State::Process;
+        } else if (!_pipelineStatus.isOK()) {
+            next = State::EndSession;
+        }
+    } else if (state == State::SinkWait) {
+        if (!_pipelineStatus.isOK()) {
+            next = State::EndSession;
+        } else if (_pendingReplyCount() < _pipelineDepth) {
+            next = _inExhaust ? State::Process : State::Source;
+            taskName = _inExhaust ? transport::ServiceExecutorTaskName::kSSMExhaustMessage
+                                  : transport::ServiceExecutorTaskName::kSSMSourceMessage;
+        }
+    }
+
+    if (next == state) {
+        // Processing isn't waiting on this I/O, and will pick up its result later.
+        return _pumpPipelinedIO(std::move(lk));
+    }
+
+    // The state machine was released when it started waiting, and moving it out of the waiting
+    // state under the lock makes this the only callback that can take it over.
+    _state.store(next);
+    _pumpPipelinedIO(std::move(lk));
+
+    ThreadGuard guard(this);
+    if (next == State::EndSession) {
+        return _runNextInGuard(std::move(guard));
+    }
+    _scheduleNextWithGuard(std::move(guard), ServiceExecutor::kMayRecurse, taskName);
 }
 
 void ServiceStateMachine::_sinkCallback(Status status) {
@@ -359,7 +546,11 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
     auto& compressorMgr = MessageCompressorManager::forSession(_session());
 
-    _compressorId = boost::none;
+    // A request run again for exhaust has already been decompressed, and its replies go out with
+    // the compressor the client used for it.
+    if (!_inExhaust) {
+        _compressorId = boost::none;
+    }
     if (_inMessage.operation() == dbCompressed) {
         MessageCompressorId compressorId;
         auto swm = compressorMgr.decompressMessage(_inMessage, &compressorId);
@@ -391,6 +582,11 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         // If this is an exhaust cursor, don't source more Messages
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
             _inExhaust = true;
+        } else if (dbresponse.shouldRunAgainForExhaust) {
+            // The next batch is only produced once this one has been sunk, so a client that reads
+            // slowly holds the stream back rather than having batches queue up on the server.
+            setOpMsgExhaustMessage(&_inMessage, &toSink);
+            _inExhaust = true;
         } else {
             _inExhaust = false;
             _inMessage.reset();
@@ -403,7 +599,11 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
             uassertStatusOK(swm.getStatus());
             toSink = swm.getValue();
         }
-        _sinkMessage(std::move(guard), std::move(toSink));
+        if (_pipelined) {
+            _sinkPipelinedMessage(std::move(guard), std::move(toSink));
+        } else {
+            _sinkMessage(std::move(guard), std::move(toSink));
+        }
 
     } else {
         _state.store(State::Source);
@@ -538,6 +738,15 @@ void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
 
     _inMessage.reset();
 
+    if (_pipelined) {
+        // Fail any I/O still outstanding so that its callbacks, which keep this object alive,
+        // complete promptly.
+        _session()->end();
+        stdx::lock_guard<stdx::mutex> lk(_pipelineMutex);
+        _readAheadMessages.clear();
+        _pendingReplies.clear();
+    }
+
     // By ignoring the return value of Client::releaseCurrent() we destroy the session.
     // _dbClient is now nullptr and _dbClientPtr is invalid and should never be accessed.
     Client::releaseCurrent();
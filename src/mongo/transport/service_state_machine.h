@@ -29,6 +29,7 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 
 #include "mongo/base/status.h"
 #include "mongo/config.h"
@@ -47,6 +48,12 @@
 
 namespace mongo {
 
+/*
+ * The maximum number of requests a connection may have read ahead, and of replies it may have
+ * waiting to be sent, while it processes a request. 1 turns pipelining off.
+ */
+extern AtomicInt32 maxPipelinedRequestsPerConnection;
+
 /*
  * The ServiceStateMachine holds the state of a single client connection and represents the
  * lifecycle of each user request as a state machine. It is the glue between the stateless
@@ -80,6 +87,12 @@ public:
      * Source -> SourceWait -> Process -> SinkWait -> Source (standard RPC)
      * Source -> SourceWait -> Process -> SinkWait -> Process -> SinkWait ... (exhaust)
      * Source -> SourceWait -> Process -> Source (fire-and-forget)
+     *
+     * With pipelining, the network I/O for a connection runs alongside its processing. Requests
+     * are read ahead into a queue and replies are queued to be sent in order, so Source only
+     * waits in SourceWait if no request has been read ahead, and Process only moves on to
+     * SinkWait if too many replies are still waiting to be sent:
+     * Source -> Process -> Source -> Process ... (pipelined)
      */
     enum class State {
         Created,     // The session has been created, but no operations have been performed yet
@@ -208,6 +221,36 @@ private:
     void _sourceMessage(ThreadGuard guard);
     void _sinkMessage(ThreadGuard guard, Message toSink);
 
+    /*
+     * Logs why sourcing a message failed.
+     */
+    void _logSourceError(const Status& status);
+
+    /*
+     * The pipelined equivalents of _sourceMessage() and _sinkMessage(), which take a request from
+     * the read ahead queue and add a reply to the queue of replies to send.
+     */
+    void _sourcePipelinedMessage(ThreadGuard guard);
+    void _sinkPipelinedMessage(ThreadGuard guard, Message toSink);
+
+    /*
+     * Starts reading ahead and sending queued replies, as far as the pipeline allows. Unlocks 'lk'
+     * before calling into the session.
+     */
+    void _pumpPipelinedIO(stdx::unique_lock<stdx::mutex> lk);
+
+    /*
+     * Called by the session when pipelined I/O completes. If processing was waiting on it, these
+     * take ownership of the state machine and resume it.
+     */
+    void _pipelinedSourceCallback(StatusWith<Message> msg);
+    void _pipelinedSinkCallback(Status status);
+    void _resumePipelinedSession(stdx::unique_lock<stdx::mutex> lk);
+
+    size_t _pendingReplyCount() const {
+        return _pendingReplies.size() + (_sinkInProgress ? 1 : 0);
+    }
+
     /*
      * Releases all the resources associated with the session and call the cleanupHook.
      */
@@ -230,6 +273,20 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // Pipelining is turned on once the session supports a source and a sink at the same time, which
+    // for a TLS-capable listener is only known after the first request. Processing still happens
+    // one request at a time, in order, so requests, replies and their compression stay in order.
+    bool _pipelined = false;
+    size_t _pipelineDepth = 1;
+
+    // Pipelined I/O state, guarded by _pipelineMutex.
+    stdx::mutex _pipelineMutex;
+    std::deque<Message> _readAheadMessages;
+    std::deque<Message> _pendingReplies;
+    bool _sourceInProgress = false;
+    bool _sinkInProgress = false;
+    Status _pipelineStatus = Status::OK();
+
     AtomicWord<Ownership> _owned{Ownership::kUnowned};
 #if MONGO_CONFIG_DEBUG_BUILD
     AtomicWord<stdx::thread::id> _owningThread;
@@ -48,6 +48,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/tick_source_mock.h"
 
 namespace mongo {
@@ -79,7 +80,12 @@ public:
         if (_uassertInHandler)
             uassert(40469, "Synthetic uassert failure", false);
 
-        return DbResponse{builder.finish()};
+        DbResponse response{builder.finish()};
+        if (_exhaustReplies > 0 && OpMsg::isFlagSet(request, OpMsg::kExhaustAllowed)) {
+            _exhaustReplies--;
+            response.shouldRunAgainForExhaust = true;
+        }
+        return response;
     }
 
     void endAllSessions(transport::Session::TagMask tags) override {}
@@ -100,6 +106,10 @@ public:
         _uassertInHandler = true;
     }
 
+    void setExhaustReplies(int count) {
+        _exhaustReplies = count;
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -109,6 +119,7 @@ public:
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    int _exhaustReplies = 0;
 };
 
 using namespace transport;
@@ -138,6 +149,8 @@ public:
                 OpMsgBuilder builder;
                 builder.setBody(BSON("ping" << 1));
                 out.getValue() = builder.finish();
+                if (tl->_sourceFlags)
+                    OpMsg::replaceFlags(&out.getValue(), tl->_sourceFlags);
             }
             return out;
         }
@@ -195,6 +208,10 @@ public:
         _waitHook = std::move(hook);
     }
 
+    void setSourceFlags(uint32_t flags) {
+        _sourceFlags = flags;
+    }
+
 private:
     bool _lastTicketSource = true;
     bool _ranSink = false;
@@ -203,6 +220,58 @@ private:
     Message _lastSunk;
     ServiceStateMachine* _ssm;
     stdx::function<void()> _waitHook;
+    uint32_t _sourceFlags = 0;
+};
+
+// A session which can source and sink at the same time, and whose I/O only completes when the test
+// completes it.
+class PipelinedSession : public transport::MockSession {
+public:
+    using MockSession::MockSession;
+
+    bool supportsConcurrentSourceAndSink() const override {
+        return true;
+    }
+
+    Future<Message> asyncSourceMessage(const transport::BatonHandle& handle = nullptr) override {
+        ASSERT_FALSE(_sourcePromise);
+        _sourcePromise.emplace();
+        return _sourcePromise->getFuture();
+    }
+
+    Future<void> asyncSinkMessage(Message message,
+                                  const transport::BatonHandle& handle = nullptr) override {
+        ASSERT_FALSE(_sinkPromise);
+        sunk.push_back(std::move(message));
+        _sinkPromise.emplace();
+        return _sinkPromise->getFuture();
+    }
+
+    bool sourcing() const {
+        return static_cast<bool>(_sourcePromise);
+    }
+
+    bool sinking() const {
+        return static_cast<bool>(_sinkPromise);
+    }
+
+    void completeSource(StatusWith<Message> msg) {
+        auto promise = std::move(*_sourcePromise);
+        _sourcePromise = boost::none;
+        promise.setFromStatusWith(std::move(msg));
+    }
+
+    void completeSink() {
+        auto promise = std::move(*_sinkPromise);
+        _sinkPromise = boost::none;
+        promise.emplaceValue();
+    }
+
+    std::vector<Message> sunk;
+
+private:
+    boost::optional<Promise<Message>> _sourcePromise;
+    boost::optional<Promise<void>> _sinkPromise;
 };
 
 Message buildRequest(BSONObj input) {
@@ -366,6 +435,86 @@ TEST_F(ServiceStateMachineFixture, TestSinkError) {
     ASSERT_TRUE(_tl->ranSink());
 }
 
+TEST_F(ServiceStateMachineFixture, TestOpMsgExhaust) {
+    _tl->setSourceFlags(OpMsg::kExhaustAllowed);
+    _sep->setExhaustReplies(2);
+
+    // Each reply which asks to be run again is sent with moreToCome, and the SSM goes straight back
+    // to processing the request rather than sourcing a new one.
+    runPingTest(State::Process, State::Process);
+    auto first = _tl->getLastSunk();
+    ASSERT_TRUE(OpMsg::isFlagSet(first, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(first).body, BSON("ok" << 1));
+
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+    auto second = _tl->getLastSunk();
+    ASSERT_TRUE(OpMsg::isFlagSet(second, OpMsg::kMoreToCome));
+    ASSERT_EQ(second.header().getResponseToMsgId(), first.header().getId());
+
+    // The last reply ends the stream.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Source);
+    auto last = _tl->getLastSunk();
+    ASSERT_FALSE(OpMsg::isFlagSet(last, OpMsg::kMoreToCome));
+    ASSERT_EQ(last.header().getResponseToMsgId(), second.header().getId());
+}
+
+TEST_F(ServiceStateMachineFixture, TestPipelining) {
+    const int oldDepth = maxPipelinedRequestsPerConnection.load();
+    ON_BLOCK_EXIT([oldDepth] { maxPipelinedRequestsPerConnection.store(oldDepth); });
+    maxPipelinedRequestsPerConnection.store(2);
+
+    auto session = std::make_shared<PipelinedSession>(_tl);
+    _ssm = ServiceStateMachine::create(
+        getGlobalServiceContext(), session, transport::Mode::kAsynchronous);
+
+    auto request = [](int32_t id) {
+        auto msg = buildRequest(BSON("ping" << 1));
+        msg.header().setId(id);
+        return msg;
+    };
+
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::SourceWait);
+
+    // The second request is read while the first is waiting to be processed.
+    session->completeSource(request(1));
+    ASSERT_EQ(_ssm->state(), State::Process);
+    ASSERT_TRUE(session->sourcing());
+    session->completeSource(request(2));
+    ASSERT_TRUE(session->sourcing());
+
+    // The first reply is sent while the second request is processed.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Source);
+    ASSERT_TRUE(session->sinking());
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    // With the first reply still being sent, the second one fills the pipeline.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::SinkWait);
+
+    session->completeSink();
+    ASSERT_EQ(_ssm->state(), State::Source);
+    ASSERT_TRUE(session->sinking());
+    session->completeSink();
+
+    ASSERT_EQ(session->sunk.size(), 2U);
+    ASSERT_EQ(session->sunk[0].header().getResponseToMsgId(), 1);
+    ASSERT_EQ(session->sunk[1].header().getResponseToMsgId(), 2);
+    for (const auto& reply : session->sunk) {
+        ASSERT_BSONOBJ_EQ(OpMsg::parse(reply).body, BSON("ok" << 1));
+    }
+
+    // Failing the outstanding read ahead ends the session once it waits for another request.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::SourceWait);
+    session->completeSource(TransportLayer::TicketSessionClosedStatus);
+    ASSERT_EQ(_ssm->state(), State::Ended);
+}
+
 // This test checks that after the SSM has been cleaned up, the SessionHandle that it passed
 // into the Client doesn't have any dangling shared_ptr copies.
 TEST_F(ServiceStateMachineFixture, TestSessionCleanupOnDestroy) {
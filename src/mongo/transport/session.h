@@ -116,6 +116,14 @@ public:
     virtual Future<void> asyncSinkMessage(Message message,
                                           const transport::BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Returns true if an asyncSourceMessage() and an asyncSinkMessage() may be outstanding on this
+     * session at the same time.
+     */
+    virtual bool supportsConcurrentSourceAndSink() const {
+        return false;
+    }
+
     /**
      * Cancel any outstanding async operations. There is no way to cancel synchronous calls.
      * Futures will finish with an ErrorCodes::CallbackCancelled error if they haven't already
@@ -139,7 +139,7 @@ public:
     Status sinkMessage(Message message) override {
         ensureSync();
 
-        return write(asio::buffer(message.buf(), message.size()))
+        return writeMessage(message)
             .then([this, &message] {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -151,7 +151,7 @@ public:
     Future<void> asyncSinkMessage(Message message,
                                   const transport::BatonHandle& baton = nullptr) override {
         ensureAsync();
-        return write(asio::buffer(message.buf(), message.size()), baton)
+        return writeMessage(message, baton)
             .then([this, message /*keep the buffer alive*/]() {
                 if (_isIngressSession) {
                     networkCounter.hitPhysicalOut(message.size());
@@ -159,6 +159,16 @@ public:
             });
     }
 
+    bool supportsConcurrentSourceAndSink() const override {
+#ifdef MONGO_CONFIG_SSL
+        // A plain socket can read and write at once, but a TLS stream can't. Whether an ingress
+        // session uses TLS is only known once its first bytes have been read.
+        return _ranHandshake && !_sslSocket;
+#else
+        return true;
+#endif
+    }
+
     void cancelAsyncOperations(const transport::BatonHandle& baton = nullptr) override {
         LOG(3) << "Cancelling outstanding I/O operations on connection to " << _remote;
         if (baton) {
@@ -330,8 +340,40 @@ private:
     }
 
     Future<Message> sourceMessageImpl(const transport::BatonHandle& baton = nullptr) {
-        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+#ifdef MONGO_CONFIG_SSL
+        // The first bytes of an ingress connection decide whether it is going to use TLS, so they
+        // must be read exactly, without reading ahead into the TLS handshake.
+        if (!_ranHandshake) {
+            return sourceMessageExactly(baton);
+        }
+#endif
+        return sourceMessageReadingAhead(baton);
+    }
+
+    static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+    // Size of the buffer into which messages are received ahead of time. Every message which fits
+    // into it, together with the header of the next one, is received with a single read.
+    static constexpr size_t kReadAheadBufferSize = 4 * 1024;
+
+    /**
+     * Checks the header of a message of 'msgLen' bytes, returning an error if the message cannot
+     * be received.
+     */
+    Status validateMessageLength(size_t msgLen) {
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            StringBuilder sb;
+            sb << "recv(): message msgLen " << msgLen << " is invalid. "
+               << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+            const auto str = sb.str();
+            LOG(0) << str;
+
+            return Status(ErrorCodes::ProtocolError, str);
+        }
+        return Status::OK();
+    }
 
+    Future<Message> sourceMessageExactly(const transport::BatonHandle& baton) {
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
@@ -341,14 +383,9 @@ private:
                 }
 
                 const auto msgLen = size_t(MSGHEADER::View(headerBuffer.get()).getMessageLength());
-                if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
-                    StringBuilder sb;
-                    sb << "recv(): message msgLen " << msgLen << " is invalid. "
-                       << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
-                    const auto str = sb.str();
-                    LOG(0) << str;
-
-                    return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+                auto status = validateMessageLength(msgLen);
+                if (!status.isOK()) {
+                    return Future<Message>::makeReady(std::move(status));
                 }
 
                 if (msgLen == kHeaderSize) {
@@ -359,7 +396,7 @@ private:
                     return Future<Message>::makeReady(Message(std::move(headerBuffer)));
                 }
 
-                auto buffer = SharedBuffer::allocate(msgLen);
+                auto buffer = SharedBuffer::allocatePooled(msgLen);
                 memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
 
                 MsgData::View msgView(buffer.get());
@@ -373,6 +410,109 @@ private:
             });
     }
 
+    /**
+     * Receives the next message through the read-ahead buffer. Each read asks for as many bytes as
+     * the buffer can take, so a small message usually arrives with the read for its header, and
+     * pipelined messages arrive together.
+     */
+    Future<Message> sourceMessageReadingAhead(const transport::BatonHandle& baton) {
+        return fillReadAhead(kHeaderSize, baton).then([this, baton] {
+            const char* header = _readAhead.get() + _readAheadBegin;
+            if (checkForHTTPRequest(asio::buffer(header, kHeaderSize))) {
+                return sendHTTPResponse(baton);
+            }
+
+            const auto msgLen = size_t(MSGHEADER::ConstView(header).getMessageLength());
+            auto status = validateMessageLength(msgLen);
+            if (!status.isOK()) {
+                return Future<Message>::makeReady(std::move(status));
+            }
+
+            if (msgLen <= kReadAheadBufferSize) {
+                return fillReadAhead(msgLen, baton).then([this, msgLen] {
+                    return takeReadAheadMessage(msgLen);
+                });
+            }
+
+            // Larger messages are received directly into their own buffer, after the part of them
+            // which was already read ahead
+            auto buffer = SharedBuffer::allocatePooled(msgLen);
+            const size_t buffered = _readAheadEnd - _readAheadBegin;
+            memcpy(buffer.get(), _readAhead.get() + _readAheadBegin, buffered);
+            _readAheadBegin = _readAheadEnd = 0;
+
+            auto ptr = buffer.get();
+            return read(asio::buffer(ptr + buffered, msgLen - buffered), baton)
+                .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Message(std::move(buffer));
+                });
+        });
+    }
+
+    /**
+     * Reads until at least 'minBytes' bytes are available in the read-ahead buffer.
+     */
+    Future<void> fillReadAhead(size_t minBytes, const transport::BatonHandle& baton) {
+        invariant(minBytes <= kReadAheadBufferSize);
+
+        const size_t buffered = _readAheadEnd - _readAheadBegin;
+        if (buffered >= minBytes) {
+            return Future<void>::makeReady();
+        }
+
+        if (!_readAhead || _readAheadBegin + minBytes > kReadAheadBufferSize) {
+            auto readAhead = SharedBuffer::allocatePooled(kReadAheadBufferSize);
+            if (buffered) {
+                memcpy(readAhead.get(), _readAhead.get() + _readAheadBegin, buffered);
+            }
+            _readAhead = std::move(readAhead);
+            _readAheadBegin = 0;
+            _readAheadEnd = buffered;
+        }
+
+        auto freeSpace =
+            asio::buffer(_readAhead.get() + _readAheadEnd, kReadAheadBufferSize - _readAheadEnd);
+        return readAtLeast(freeSpace, minBytes - buffered, baton)
+            .then([ this, readAhead = _readAhead ](size_t size) { _readAheadEnd += size; });
+    }
+
+    /**
+     * Removes the message of 'msgLen' bytes at the front of the read-ahead buffer. If it is all
+     * that the buffer holds, the buffer itself becomes the message.
+     */
+    Message takeReadAheadMessage(size_t msgLen) {
+        if (_isIngressSession) {
+            networkCounter.hitPhysicalIn(msgLen);
+        }
+
+        if (_readAheadBegin == 0 && _readAheadEnd == msgLen) {
+            _readAheadEnd = 0;
+            return Message(std::move(_readAhead));
+        }
+
+        auto buffer = SharedBuffer::allocatePooled(msgLen);
+        memcpy(buffer.get(), _readAhead.get() + _readAheadBegin, msgLen);
+        _readAheadBegin += msgLen;
+        if (_readAheadBegin == _readAheadEnd) {
+            _readAheadBegin = _readAheadEnd = 0;
+        }
+        return Message(std::move(buffer));
+    }
+
+    Future<size_t> readAtLeast(asio::mutable_buffer buffer,
+                               size_t minBytes,
+                               const transport::BatonHandle& baton) {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            return opportunisticReadAtLeast(*_sslSocket, buffer, minBytes, baton);
+        }
+#endif
+        return opportunisticReadAtLeast(_socket, buffer, minBytes, baton);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers,
                       const transport::BatonHandle& baton = nullptr) {
@@ -399,6 +539,23 @@ private:
         return opportunisticRead(_socket, buffers, baton);
     }
 
+    /**
+     * Writes a message. Messages with spliced documents are sent with gather I/O straight from the
+     * documents' own buffers rather than being copied into one buffer first.
+     */
+    Future<void> writeMessage(const Message& message,
+                              const transport::BatonHandle& baton = nullptr) {
+        if (!message.hasSplices()) {
+            return write(asio::buffer(message.buf(), message.size()), baton);
+        }
+
+        std::vector<asio::const_buffer> buffers;
+        for (const auto& range : message.gatherBuffers()) {
+            buffers.emplace_back(range.data(), range.length());
+        }
+        return write(buffers, baton);
+    }
+
     template <typename ConstBufferSequence>
     Future<void> write(const ConstBufferSequence& buffers,
                        const transport::BatonHandle& baton = nullptr) {
@@ -469,6 +626,51 @@ private:
         }
     }
 
+    /**
+     * Like opportunisticRead, but completes as soon as 'minBytes' bytes have arrived, with however
+     * many bytes up to the size of 'buffer' could be read at that point.
+     */
+    template <typename Stream>
+    Future<size_t> opportunisticReadAtLeast(Stream& stream,
+                                            asio::mutable_buffer buffer,
+                                            size_t minBytes,
+                                            const transport::BatonHandle& baton = nullptr) {
+        std::error_code ec;
+        size_t size;
+
+        if (MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite) &&
+            _blockingMode == Async) {
+            asio::mutable_buffer localBuffer(buffer.data(), std::min<size_t>(buffer.size(), 1));
+
+            size = asio::read(stream, localBuffer, ec);
+            if (!ec && size < minBytes) {
+                ec = asio::error::would_block;
+            }
+        } else {
+            size = asio::read(stream, buffer, asio::transfer_at_least(minBytes), ec);
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            const auto asyncBuffer = buffer + size;
+            const size_t asyncMinBytes = minBytes - size;
+
+            if (baton) {
+                return baton->addSession(*this, Baton::Type::In)
+                    .then([&stream, asyncBuffer, asyncMinBytes, baton, this] {
+                        return opportunisticReadAtLeast(stream, asyncBuffer, asyncMinBytes, baton);
+                    })
+                    .then([size](size_t asyncSize) { return size + asyncSize; });
+            }
+
+            return asio::async_read(
+                       stream, asyncBuffer, asio::transfer_at_least(asyncMinBytes), UseFuture{})
+                .then([size](size_t asyncSize) { return size + asyncSize; });
+        } else {
+            return futurize(ec, size);
+        }
+    }
+
     /**
      * moreToSend checks the ssl socket after an opportunisticWrite.  If there are still bytes to
      * send, we manually send them off the underlying socket.  Then we hook that up with a future
@@ -501,6 +703,23 @@ private:
     }
 #endif
 
+    template <typename Buffer>
+    static void consumeBuffers(Buffer* buffer, std::size_t size) {
+        *buffer += size;
+    }
+
+    static void consumeBuffers(std::vector<asio::const_buffer>* buffers, std::size_t size) {
+        auto it = buffers->begin();
+        while (it != buffers->end() && size >= it->size()) {
+            size -= it->size();
+            ++it;
+        }
+        buffers->erase(buffers->begin(), it);
+        if (size > 0) {
+            buffers->front() += size;
+        }
+    }
+
     template <typename Stream, typename ConstBufferSequence>
     Future<void> opportunisticWrite(Stream& stream,
                                     const ConstBufferSequence& buffers,
@@ -510,14 +729,14 @@ private:
 
         if (MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite) &&
             _blockingMode == Async) {
-            asio::const_buffer localBuffer = buffers;
+            asio::const_buffer localBuffer = *asio::buffer_sequence_begin(buffers);
 
-            if (buffers.size()) {
-                localBuffer = asio::const_buffer(buffers.data(), 1);
+            if (localBuffer.size()) {
+                localBuffer = asio::const_buffer(localBuffer.data(), 1);
             }
 
             size = asio::write(stream, localBuffer, ec);
-            if (!ec && buffers.size() > 1) {
+            if (!ec && asio::buffer_size(buffers) > 1) {
                 ec = asio::error::would_block;
             }
         } else {
@@ -532,7 +751,7 @@ private:
             // size is > 0.
             ConstBufferSequence asyncBuffers(buffers);
             if (size > 0) {
-                asyncBuffers += size;
+                consumeBuffers(&asyncBuffers, size);
             }
 
             if (auto more = moreToSend(stream, asyncBuffers, baton)) {
@@ -690,6 +909,11 @@ private:
     boost::optional<Milliseconds> _configuredTimeout;
     boost::optional<Milliseconds> _socketTimeout;
 
+    // Bytes received ahead of the messages returned so far, in [_readAheadBegin, _readAheadEnd)
+    SharedBuffer _readAhead;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
+
     GenericSocket _socket;
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
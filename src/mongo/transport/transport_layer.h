@@ -153,6 +153,12 @@ public:
      */
     virtual void run() noexcept = 0;
     virtual void runFor(Milliseconds time) noexcept = 0;
+
+    /*
+     * Run at most one handler from the event loop, waiting up to the given time for one to
+     * become ready.
+     */
+    virtual void runOneFor(Milliseconds time) noexcept = 0;
     virtual void stop() = 0;
 
     using Task = stdx::function<void()>;
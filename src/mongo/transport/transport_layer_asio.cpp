@@ -220,6 +220,18 @@ public:
         }
     }
 
+    void runOneFor(Milliseconds time) noexcept override {
+        ThreadIdGuard threadIdGuard(this);
+        asio::io_context::work work(_ioContext);
+
+        try {
+            _ioContext.run_one_for(time.toSystemDuration());
+        } catch (...) {
+            severe() << "Uncaught exception in reactor: " << exceptionToStatus();
+            fassertFailed(50864);
+        }
+    }
+
     void stop() override {
         _ioContext.stop();
     }
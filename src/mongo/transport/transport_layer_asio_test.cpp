@@ -260,6 +260,18 @@ public:
         ASSERT_FALSE(ec);
     }
 
+    // Sends all of 'msgs' with a single write
+    void sendMessages(const std::vector<Message>& msgs) {
+        std::string bytes;
+        for (const auto& msg : msgs) {
+            bytes.append(msg.buf(), msg.size());
+        }
+
+        std::error_code ec;
+        asio::write(_sock, asio::buffer(bytes.data(), bytes.size()), ec);
+        ASSERT_FALSE(ec);
+    }
+
 private:
     asio::io_context _ctx;
     asio::ip::tcp::socket _sock;
@@ -358,5 +370,56 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+Message makePingMessage(int32_t id, size_t paddingSize) {
+    OpMsgBuilder builder;
+    builder.setBody(BSON("ping" << 1 << "padding" << std::string(paddingSize, 'x')));
+    Message msg = builder.finish();
+    msg.header().setResponseToMsgId(0);
+    msg.header().setId(id);
+    return msg;
+}
+
+/* check that messages arriving back to back are each received whole, whatever their size */
+class PipelinedMessagesSEP : public TimeoutSEP {
+public:
+    explicit PipelinedMessagesSEP(std::vector<Message> expected) : _expected(std::move(expected)) {}
+
+    void startSession(transport::SessionHandle session) override {
+        stdx::thread([ this, session = std::move(session) ]() mutable {
+            for (const auto& expected : _expected) {
+                auto swMsg = session->sourceMessage();
+                ASSERT_OK(swMsg.getStatus());
+                ASSERT_EQ(swMsg.getValue().size(), expected.size());
+                ASSERT_EQ(swMsg.getValue().header().getId(), expected.header().getId());
+                ASSERT_EQ(0, memcmp(swMsg.getValue().buf(), expected.buf(), expected.size()));
+            }
+
+            session.reset();
+            notifyComplete();
+        }).detach();
+    }
+
+private:
+    const std::vector<Message> _expected;
+};
+
+TEST(TransportLayerASIO, SourcePipelinedMessages) {
+    std::vector<Message> msgs{makePingMessage(1, 10),
+                              makePingMessage(2, 100),
+                              makePingMessage(3, 10),
+                              makePingMessage(4, 20 * 1024),
+                              makePingMessage(5, 3 * 1024),
+                              makePingMessage(6, 10)};
+
+    PipelinedMessagesSEP sep(msgs);
+    auto tla = makeAndStartTL(&sep);
+
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendMessages(msgs);
+
+    ASSERT_TRUE(sep.waitForTimeout(Milliseconds{10000}));
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -105,6 +105,18 @@ StatusWith<executor::TaskExecutor::CallbackHandle> TaskExecutorProxy::scheduleRe
     return _executor->scheduleRemoteCommand(request, cb, baton);
 }
 
+executor::TaskExecutor::RemoteCommandBatchHandle TaskExecutorProxy::makeRemoteCommandBatch() {
+    return _executor->makeRemoteCommandBatch();
+}
+
+StatusWith<executor::TaskExecutor::CallbackHandle> TaskExecutorProxy::scheduleRemoteCommandInBatch(
+    const executor::RemoteCommandRequest& request,
+    const RemoteCommandCallbackFn& cb,
+    const RemoteCommandBatchHandle& batch,
+    const transport::BatonHandle& baton) {
+    return _executor->scheduleRemoteCommandInBatch(request, cb, batch, baton);
+}
+
 void TaskExecutorProxy::cancel(const CallbackHandle& cbHandle) {
     _executor->cancel(cbHandle);
 }
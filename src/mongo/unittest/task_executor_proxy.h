@@ -69,6 +69,12 @@ public:
         const executor::RemoteCommandRequest& request,
         const RemoteCommandCallbackFn& cb,
         const transport::BatonHandle& baton = nullptr) override;
+    virtual RemoteCommandBatchHandle makeRemoteCommandBatch() override;
+    virtual StatusWith<CallbackHandle> scheduleRemoteCommandInBatch(
+        const executor::RemoteCommandRequest& request,
+        const RemoteCommandCallbackFn& cb,
+        const RemoteCommandBatchHandle& batch,
+        const transport::BatonHandle& baton = nullptr) override;
     virtual void cancel(const CallbackHandle& cbHandle) override;
     virtual void wait(const CallbackHandle& cbHandle) override;
     virtual void appendConnectionStats(executor::ConnectionPoolStats* stats) const override;
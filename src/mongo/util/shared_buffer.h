@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/intrusive_ptr.hpp>
+#include <cstring>
 
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
@@ -51,6 +53,15 @@ public:
         return takeOwnership(mongoMalloc(sizeof(Holder) + bytes), bytes);
     }
 
+    /**
+     * Like allocate(), but the memory is taken from and, once the last reference is dropped,
+     * returned to the size-class pool described in shared_buffer_pool.h. The capacity is rounded
+     * up to the size class. Requests larger than the largest size class are not pooled.
+     *
+     * Defined in shared_buffer_pool.cpp.
+     */
+    static SharedBuffer allocatePooled(size_t bytes);
+
     /**
      * Resizes the buffer, copying the current contents.
      *
@@ -62,6 +73,17 @@ public:
     void realloc(size_t size) {
         invariant(!_holder || !_holder->isShared());
 
+        if (isPooled()) {
+            // Stay in the pool rather than handing its memory to ::realloc().
+            if (size <= capacity() && size > capacity() / 2) {
+                return;
+            }
+            auto tmp = allocatePooled(size);
+            memcpy(tmp.get(), get(), std::min(size, capacity()));
+            swap(tmp);
+            return;
+        }
+
         const size_t realSize = size + sizeof(Holder);
         void* newPtr = mongoRealloc(_holder.get(), realSize);
 
@@ -96,11 +118,18 @@ public:
         return _holder ? _holder->_capacity : 0;
     }
 
+    /**
+     * Returns true if the underlying buffer goes back to the buffer pool when released.
+     */
+    bool isPooled() const {
+        return _holder && _holder->_pooled;
+    }
+
 private:
     class Holder {
     public:
-        explicit Holder(AtomicUInt32::WordType initial, size_t capacity)
-            : _refCount(initial), _capacity(capacity) {
+        explicit Holder(AtomicUInt32::WordType initial, size_t capacity, bool pooled = false)
+            : _refCount(initial), _capacity(capacity), _pooled(pooled) {
             invariant(capacity == _capacity);
         }
 
@@ -111,6 +140,11 @@ private:
 
         friend void intrusive_ptr_release(Holder* h) {
             if (h->_refCount.subtractAndFetch(1) == 0) {
+                if (h->_pooled) {
+                    h->releaseToPool();
+                    return;
+                }
+
                 // We placement new'ed a Holder in takeOwnership above,
                 // so we must destroy the object here.
                 h->~Holder();
@@ -130,8 +164,15 @@ private:
             return _refCount.load() > 1;
         }
 
+        /**
+         * Destroys this pooled Holder and gives its memory back to the buffer pool. Defined in
+         * shared_buffer_pool.cpp.
+         */
+        void releaseToPool() noexcept;
+
         AtomicUInt32 _refCount;
-        uint32_t _capacity;
+        uint32_t _capacity : 31;
+        uint32_t _pooled : 1;
     };
 
     explicit SharedBuffer(Holder* holder) : _holder(holder, /*add_ref=*/false) {
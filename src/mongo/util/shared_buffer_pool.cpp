@@ -0,0 +1,270 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include "mongo/base/static_assert.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/bits.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+constexpr size_t SharedBufferPool::kMinSizeClassBytes;
+constexpr size_t SharedBufferPool::kMaxSizeClassBytes;
+constexpr size_t SharedBufferPool::kThreadCacheMaxBytes;
+constexpr size_t SharedBufferPool::kAllThreadCachesMaxBytes;
+constexpr size_t SharedBufferPool::kGlobalCacheMaxBytes;
+
+namespace {
+
+constexpr int kMinSizeClassShift = 9;
+constexpr int kNumSizeClasses = 24 - kMinSizeClassShift + 1;
+
+MONGO_STATIC_ASSERT(SharedBufferPool::kMinSizeClassBytes == size_t(1) << kMinSizeClassShift);
+MONGO_STATIC_ASSERT(SharedBufferPool::kMaxSizeClassBytes ==
+                    SharedBufferPool::kMinSizeClassBytes << (kNumSizeClasses - 1));
+
+int sizeClassIndex(size_t bytes) {
+    if (bytes <= SharedBufferPool::kMinSizeClassBytes) {
+        return 0;
+    }
+    return 64 - countLeadingZeros64(bytes - 1) - kMinSizeClassShift;
+}
+
+size_t sizeClassCapacity(int index) {
+    return SharedBufferPool::kMinSizeClassBytes << index;
+}
+
+struct Counters {
+    AtomicInt64 threadCacheHits;
+    AtomicInt64 globalCacheHits;
+    AtomicInt64 misses;
+    AtomicInt64 returned;
+    AtomicInt64 freed;
+    AtomicInt64 bytesCached;
+    AtomicInt64 bytesCachedByThreads;
+} counters;
+
+/**
+ * Per size class lists of cached buffers. The lists are threaded through the cached memory itself,
+ * so caching a buffer never allocates.
+ */
+class FreeLists {
+public:
+    void* pop(int index) {
+        auto block = _heads[index];
+        if (block) {
+            _heads[index] = block->next;
+            _bytes -= sizeClassCapacity(index);
+        }
+        return block;
+    }
+
+    /**
+     * Caches 'block' unless that would take the lists above 'maxBytes'.
+     */
+    bool push(int index, void* block, size_t maxBytes) {
+        const size_t capacity = sizeClassCapacity(index);
+        if (_bytes + capacity > maxBytes) {
+            return false;
+        }
+        _heads[index] = new (block) FreeBlock{_heads[index]};
+        _bytes += capacity;
+        return true;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* _heads[kNumSizeClasses] = {};
+    size_t _bytes = 0;
+};
+
+class GlobalCache {
+public:
+    void* pop(int index) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _lists.pop(index);
+    }
+
+    bool push(int index, void* block) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _lists.push(index, block, SharedBufferPool::kGlobalCacheMaxBytes);
+    }
+
+private:
+    stdx::mutex _mutex;
+    FreeLists _lists;
+};
+
+// Leaked, so that buffers released during shutdown can still be returned.
+GlobalCache& globalCache() {
+    static auto cache = new GlobalCache();
+    return *cache;
+}
+
+/**
+ * Caches 'block' in 'threadLists' unless that would take them above kThreadCacheMaxBytes, or the
+ * caches of all threads together above kAllThreadCachesMaxBytes.
+ */
+bool pushToThreadCache(int index, void* block, FreeLists* threadLists) {
+    const long long capacity = sizeClassCapacity(index);
+    if (counters.bytesCachedByThreads.addAndFetch(capacity) >
+            static_cast<long long>(SharedBufferPool::kAllThreadCachesMaxBytes) ||
+        !threadLists->push(index, block, SharedBufferPool::kThreadCacheMaxBytes)) {
+        counters.bytesCachedByThreads.subtractAndFetch(capacity);
+        return false;
+    }
+    return true;
+}
+
+void cacheOrFree(int index, void* block, FreeLists* threadLists) {
+    if ((threadLists && pushToThreadCache(index, block, threadLists)) ||
+        globalCache().push(index, block)) {
+        counters.bytesCached.addAndFetch(sizeClassCapacity(index));
+        return;
+    }
+    counters.freed.addAndFetch(1);
+    free(block);
+}
+
+thread_local bool threadCacheDestroyed = false;
+
+/**
+ * The calling thread's cache. Its buffers move to the global cache when the thread exits.
+ */
+class ThreadCache {
+public:
+    ~ThreadCache() {
+        threadCacheDestroyed = true;
+        for (int index = 0; index < kNumSizeClasses; ++index) {
+            while (auto block = _lists.pop(index)) {
+                counters.bytesCached.subtractAndFetch(sizeClassCapacity(index));
+                counters.bytesCachedByThreads.subtractAndFetch(sizeClassCapacity(index));
+                cacheOrFree(index, block, nullptr);
+            }
+        }
+    }
+
+    /**
+     * Returns nullptr while the thread is exiting and its cache is already gone.
+     */
+    static FreeLists* get();
+
+private:
+    FreeLists _lists;
+};
+
+thread_local ThreadCache threadCache;
+
+FreeLists* ThreadCache::get() {
+    return threadCacheDestroyed ? nullptr : &threadCache._lists;
+}
+
+/**
+ * Returns a cached block for the size class, or nullptr if there is none.
+ */
+void* takeCached(int index) {
+    auto threadLists = ThreadCache::get();
+    if (auto block = threadLists ? threadLists->pop(index) : nullptr) {
+        counters.threadCacheHits.addAndFetch(1);
+        counters.bytesCached.subtractAndFetch(sizeClassCapacity(index));
+        counters.bytesCachedByThreads.subtractAndFetch(sizeClassCapacity(index));
+        return block;
+    }
+    if (auto block = globalCache().pop(index)) {
+        counters.globalCacheHits.addAndFetch(1);
+        counters.bytesCached.subtractAndFetch(sizeClassCapacity(index));
+        return block;
+    }
+    counters.misses.addAndFetch(1);
+    return nullptr;
+}
+
+}  // namespace
+
+SharedBuffer SharedBuffer::allocatePooled(size_t bytes) {
+    if (bytes > SharedBufferPool::kMaxSizeClassBytes) {
+        return allocate(bytes);
+    }
+
+    const int index = sizeClassIndex(bytes);
+    const size_t capacity = sizeClassCapacity(index);
+    void* block = takeCached(index);
+    if (!block) {
+        block = mongoMalloc(sizeof(Holder) + capacity);
+    }
+    return SharedBuffer(new (block) Holder(1U, capacity, /*pooled=*/true));
+}
+
+void SharedBuffer::Holder::releaseToPool() noexcept {
+    const int index = sizeClassIndex(_capacity);
+    void* block = this;
+    this->~Holder();
+
+    counters.returned.addAndFetch(1);
+    cacheOrFree(index, block, ThreadCache::get());
+}
+
+size_t SharedBufferPool::sizeClassBytes(size_t bytes) {
+    if (bytes > kMaxSizeClassBytes) {
+        return bytes;
+    }
+    return sizeClassCapacity(sizeClassIndex(bytes));
+}
+
+SharedBufferPool::Stats SharedBufferPool::getStats() {
+    Stats stats;
+    stats.threadCacheHits = counters.threadCacheHits.load();
+    stats.globalCacheHits = counters.globalCacheHits.load();
+    stats.misses = counters.misses.load();
+    stats.returned = counters.returned.load();
+    stats.freed = counters.freed.load();
+    stats.bytesCached = counters.bytesCached.load();
+    stats.bytesCachedByThreads = counters.bytesCachedByThreads.load();
+    return stats;
+}
+
+void SharedBufferPool::appendStats(BSONObjBuilder* builder) {
+    const auto stats = getStats();
+    builder->append("threadCacheHits", stats.threadCacheHits);
+    builder->append("globalCacheHits", stats.globalCacheHits);
+    builder->append("misses", stats.misses);
+    builder->append("returned", stats.returned);
+    builder->append("freed", stats.freed);
+    builder->append("bytesCached", stats.bytesCached);
+    builder->append("bytesCachedByThreads", stats.bytesCachedByThreads);
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Statistics and limits of the pool behind SharedBuffer::allocatePooled().
+ *
+ * Pooled buffers come in power-of-two size classes. A released buffer is first kept in a cache
+ * owned by the releasing thread, so that a thread which receives, processes and replies to
+ * requests keeps reusing the same few buffers without synchronization. When that cache is full,
+ * when the caches of all threads together are full, or when the thread exits, buffers move to a
+ * mutex-protected global cache that any thread can allocate from. Buffers which fit in neither
+ * cache are freed.
+ */
+class SharedBufferPool {
+public:
+    static constexpr size_t kMinSizeClassBytes = 512;
+    static constexpr size_t kMaxSizeClassBytes = 16 * 1024 * 1024;
+
+    // Buffers cached by a single thread, across all size classes.
+    static constexpr size_t kThreadCacheMaxBytes = 256 * 1024;
+
+    // Buffers cached by all threads together, so that many mostly idle threads, such as those of
+    // thread-per-connection service executors, cannot each pin a full thread cache.
+    static constexpr size_t kAllThreadCachesMaxBytes = 32 * 1024 * 1024;
+
+    // Buffers cached globally, across all size classes.
+    static constexpr size_t kGlobalCacheMaxBytes = 64 * 1024 * 1024;
+
+    struct Stats {
+        long long threadCacheHits = 0;
+        long long globalCacheHits = 0;
+        long long misses = 0;
+        long long returned = 0;
+        long long freed = 0;
+        long long bytesCached = 0;
+        long long bytesCachedByThreads = 0;
+    };
+
+    /**
+     * Returns the capacity of a pooled buffer allocated for 'bytes' bytes, or 'bytes' itself if
+     * that is too large to be pooled.
+     */
+    static size_t sizeClassBytes(size_t bytes);
+
+    static Stats getStats();
+
+    /**
+     * Appends the stats as fields of 'builder', for serverStatus.
+     */
+    static void appendStats(BSONObjBuilder* builder);
+};
+
+}  // namespace mongo
@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/shared_buffer_pool.h"
+
+namespace mongo {
+namespace {
+
+// Each test uses its own size classes, so that buffers cached by one test are not handed out in
+// another.
+
+TEST(SharedBufferPoolTest, RoundsUpToSizeClass) {
+    auto small = SharedBuffer::allocatePooled(1);
+    ASSERT_TRUE(small.isPooled());
+    ASSERT_EQ(small.capacity(), SharedBufferPool::kMinSizeClassBytes);
+
+    auto rounded = SharedBuffer::allocatePooled(SharedBufferPool::kMinSizeClassBytes + 1);
+    ASSERT_TRUE(rounded.isPooled());
+    ASSERT_EQ(rounded.capacity(), 2 * SharedBufferPool::kMinSizeClassBytes);
+    ASSERT_EQ(SharedBufferPool::sizeClassBytes(SharedBufferPool::kMinSizeClassBytes + 1),
+              rounded.capacity());
+
+    auto tooLarge = SharedBuffer::allocatePooled(SharedBufferPool::kMaxSizeClassBytes + 1);
+    ASSERT_FALSE(tooLarge.isPooled());
+    ASSERT_EQ(tooLarge.capacity(), SharedBufferPool::kMaxSizeClassBytes + 1);
+
+    ASSERT_FALSE(SharedBuffer::allocate(1).isPooled());
+}
+
+TEST(SharedBufferPoolTest, ReusesBufferReleasedOnSameThread) {
+    auto buffer = SharedBuffer::allocatePooled(3000);
+    const char* ptr = buffer.get();
+    const auto before = SharedBufferPool::getStats();
+
+    buffer = {};
+    ASSERT_EQ(SharedBufferPool::getStats().returned, before.returned + 1);
+
+    auto reused = SharedBuffer::allocatePooled(4000);
+    ASSERT_EQ(reused.get(), ptr);
+    ASSERT_EQ(SharedBufferPool::getStats().threadCacheHits, before.threadCacheHits + 1);
+}
+
+TEST(SharedBufferPoolTest, BufferIsNotReusedWhileShared) {
+    auto buffer = SharedBuffer::allocatePooled(9000);
+    auto copy = buffer;
+    const char* ptr = buffer.get();
+
+    buffer = {};
+    auto other = SharedBuffer::allocatePooled(9000);
+    ASSERT_NE(other.get(), ptr);
+    ASSERT_EQ(copy.get(), ptr);
+}
+
+TEST(SharedBufferPoolTest, ReallocKeepsBufferPooled) {
+    auto buffer = SharedBuffer::allocatePooled(20 * 1024);
+    strcpy(buffer.get(), "pooled");
+
+    buffer.realloc(40 * 1024);
+    ASSERT_TRUE(buffer.isPooled());
+    ASSERT_EQ(buffer.capacity(), 64u * 1024);
+    ASSERT_EQ(StringData(buffer.get()), "pooled");
+}
+
+TEST(SharedBufferPoolTest, LargeBuffersSkipThreadCache) {
+    const size_t bytes = 2 * SharedBufferPool::kThreadCacheMaxBytes;
+    auto buffer = SharedBuffer::allocatePooled(bytes);
+    const char* ptr = buffer.get();
+    const auto before = SharedBufferPool::getStats();
+
+    buffer = {};
+    ASSERT_EQ(SharedBufferPool::getStats().bytesCached,
+              before.bytesCached + static_cast<long long>(bytes));
+
+    auto reused = SharedBuffer::allocatePooled(bytes);
+    ASSERT_EQ(reused.get(), ptr);
+    ASSERT_EQ(SharedBufferPool::getStats().globalCacheHits, before.globalCacheHits + 1);
+}
+
+TEST(SharedBufferPoolTest, ThreadCacheMovesToGlobalCacheOnThreadExit) {
+    const size_t bytes = SharedBufferPool::kThreadCacheMaxBytes / 2;
+    const char* ptr = nullptr;
+    stdx::thread([&] {
+        auto buffer = SharedBuffer::allocatePooled(bytes);
+        ptr = buffer.get();
+    }).join();
+
+    const auto before = SharedBufferPool::getStats();
+    auto reused = SharedBuffer::allocatePooled(bytes);
+    ASSERT_EQ(reused.get(), ptr);
+    ASSERT_EQ(SharedBufferPool::getStats().globalCacheHits, before.globalCacheHits + 1);
+}
+
+TEST(SharedBufferPoolTest, ThreadCachesTogetherStayUnderLimit) {
+    // Enough threads with a full cache each to go over the limit for all threads
+    const size_t numThreads =
+        SharedBufferPool::kAllThreadCachesMaxBytes / SharedBufferPool::kThreadCacheMaxBytes + 8;
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    size_t numCached = 0;
+    bool done = false;
+
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&] {
+            SharedBuffer::allocatePooled(SharedBufferPool::kThreadCacheMaxBytes);
+
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            ++numCached;
+            cv.notify_all();
+            cv.wait(lk, [&] { return done; });
+        });
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return numCached == numThreads; });
+
+        const auto stats = SharedBufferPool::getStats();
+        ASSERT_LTE(stats.bytesCachedByThreads,
+                   static_cast<long long>(SharedBufferPool::kAllThreadCachesMaxBytes));
+        ASSERT_GT(stats.bytesCachedByThreads,
+                  static_cast<long long>(SharedBufferPool::kAllThreadCachesMaxBytes -
+                                         SharedBufferPool::kThreadCacheMaxBytes));
+
+        done = true;
+        cv.notify_all();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace
+}  // namespace mongo